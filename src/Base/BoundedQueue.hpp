@@ -0,0 +1,92 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__BoundedQueue
+#define CAP__BoundedQueue
+#include <atomic>
+#include <vector>
+
+namespace CAP
+{
+
+//!
+//! BoundedQueue
+//!
+//! Fixed capacity, lock-free, single producer/single consumer queue. One thread (the producer) calls push() while
+//! one other thread (the consumer) calls pop(). Neither call blocks: push() returns false when the queue is full and pop()
+//! returns false when it is empty. The queue is used by TaskIterator to pass pipeline slots between the producer and consumer stages.
+//!
+template < class T >
+class BoundedQueue
+{
+public:
+
+  //!
+  //! CTOR. Allocate space for the given number of items.
+  //!
+  BoundedQueue(unsigned int _capacity)
+  :
+  size(_capacity+1),
+  head(0),
+  tail(0),
+  items(_capacity+1)
+  {
+  }
+
+  virtual ~BoundedQueue() {}
+
+  //!
+  //! Append the given item at the end of the queue. Returns false, without appending, if the queue is full.  Producer thread only.
+  //!
+  bool push(const T & item)
+  {
+  unsigned int t    = tail.load(std::memory_order_relaxed);
+  unsigned int next = (t+1==size) ? 0 : t+1;
+  if (next==head.load(std::memory_order_acquire)) return false;
+  items[t] = item;
+  tail.store(next,std::memory_order_release);
+  return true;
+  }
+
+  //!
+  //! Remove the item at the front of the queue and copy it in the given item. Returns false if the queue is empty. Consumer thread only.
+  //!
+  bool pop(T & item)
+  {
+  unsigned int h = head.load(std::memory_order_relaxed);
+  if (h==tail.load(std::memory_order_acquire)) return false;
+  item = items[h];
+  head.store((h+1==size) ? 0 : h+1,std::memory_order_release);
+  return true;
+  }
+
+  bool isEmpty() const
+  {
+  return head.load(std::memory_order_acquire)==tail.load(std::memory_order_acquire);
+  }
+
+  unsigned int getCapacity() const
+  {
+  return size-1;
+  }
+
+protected:
+
+  const unsigned int size;
+  alignas(64) std::atomic<unsigned int> head; //!< written by the consumer only
+  alignas(64) std::atomic<unsigned int> tail; //!< written by the producer only
+  std::vector<T> items;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__BoundedQueue */
@@ -18,20 +18,28 @@ using CAP::ConfigurationException;
 ClassImp(CAP::Configuration);
 
 CAP::Configuration::Configuration()
+:
+parameters(),
+keywordIndex(),
+suffixIndex()
 {
-  parameters.clear();
 }
 
 CAP::Configuration::Configuration(const CAP::Configuration & _configuration)
+:
+parameters(_configuration.parameters),
+keywordIndex(_configuration.keywordIndex),
+suffixIndex(_configuration.suffixIndex)
 {
-  parameters = _configuration.parameters;
 }
 
 CAP::Configuration & CAP::Configuration::operator=(const CAP::Configuration & _configuration)
 {
   if (this!= &_configuration)
     {
-    parameters = _configuration.parameters;
+    parameters   = _configuration.parameters;
+    keywordIndex = _configuration.keywordIndex;
+    suffixIndex  = _configuration.suffixIndex;
     }
   return *this;
 }
@@ -42,20 +50,47 @@ CAP::Configuration::~Configuration()
   parameters.clear();
 }
 
+void CAP::Configuration::Parameter::parse()
+{
+  isDec       = value.IsDec();
+  isFloat     = value.IsFloat();
+  longValue   = isDec   ? value.Atoll() : 0;
+  doubleValue = isFloat ? value.Atof()  : 0.0;
+  CAP::String v = value;
+  v.ToUpper();
+  if (v.EqualTo("0") || v.EqualTo("FALSE") || v.EqualTo("YES") ) boolValue = false;
+  else if (v.EqualTo("1") || v.EqualTo("TRUE")  || v.EqualTo("NO")  ) boolValue = true;
+  else if (isDec) boolValue = value.Atoi()>0;
+  else boolValue = false;
+}
 
-CAP::String CAP::Configuration::getParameter(const char* aKeyword)  const
+void CAP::Configuration::indexParameter(unsigned int index)
 {
-  vector<Parameter>::const_iterator iter;
-  //cout << " size: " << parameters.size() << endl;
-  for (iter = parameters.begin(); iter != parameters.end(); iter++)
+  // emplace leaves existing entries untouched: each suffix keeps the first parameter it was found in.
+  const std::string keyword = parameters[index].keyword.Data();
+  suffixIndex.emplace(keyword,index);
+  for (size_t colon = keyword.find(':'); colon != std::string::npos; colon = keyword.find(':',colon+1))
     {
-    //cout << "keyword:" << iter->keyword << "   " << iter->value << endl;
-    if (iter->keyword.EndsWith(aKeyword))
-      {
-      return iter->value;
-      }
+    suffixIndex.emplace(keyword.substr(colon),index);
+    if (colon+1<keyword.size()) suffixIndex.emplace(keyword.substr(colon+1),index);
+    }
+}
+
+unsigned int CAP::Configuration::findParameter(const char* aKeyword)  const
+{
+  auto found = suffixIndex.find(aKeyword);
+  if (found != suffixIndex.end()) return found->second;
+  // no match at a path boundary: fall back on a plain suffix match.
+  for (unsigned int index=0; index<parameters.size(); index++)
+    {
+    if (parameters[index].keyword.EndsWith(aKeyword)) return index;
     }
-  throw ConfigurationException(aKeyword,"Parameter not found!!!!!","Configuration::getParameter(const char* aKeyword) ");
+  throw ConfigurationException(aKeyword,"Parameter not found!!!!!","Configuration::findParameter(const char* aKeyword) ");
+}
+
+CAP::String CAP::Configuration::getParameter(const char* aKeyword)  const
+{
+  return parameters[findParameter(aKeyword)].value;
 }
 
 CAP::String  CAP::Configuration::standardize(const char * path, const char* aKeyword) const
@@ -98,48 +133,38 @@ CAP::String  CAP::Configuration::getValueString(const char * path, const char* a
 
 bool  CAP::Configuration::getValueBool(const char* aKeyword) const
 {
-  CAP::String v = getParameter(aKeyword);
-  v.ToUpper();
-  //cout << " CAP::Configuration::getValueBool(const char* aKeyword) for keyword: " << aKeyword << " finds:" << v << endl;
-  if (v.EqualTo("0") || v.EqualTo("FALSE") || v.EqualTo("YES") ) return false;
-  else if (v.EqualTo("1") || v.EqualTo("TRUE")  || v.EqualTo("NO")  ) return true;
-  else if (v.IsDec())
-    {
-    int vv = v.Atoi();
-    return vv>0;
-    }
-  return false;
- }
+  return parameters[findParameter(aKeyword)].boolValue;
+}
 
 
 int CAP::Configuration::getValueInt(const char* aKeyword) const
 {
-  CAP::String v = getParameter(aKeyword);
-  if (!v.IsDec())
+  const Parameter & parameter = parameters[findParameter(aKeyword)];
+  if (!parameter.isDec)
     {
     return -99999;
     }
-  return v.Atoi();
+  return int(parameter.longValue);
 }
 
 long CAP::Configuration::getValueLong(const char* aKeyword) const
 {
-  CAP::String v = getParameter(aKeyword);
-  if (!v.IsDec())
+  const Parameter & parameter = parameters[findParameter(aKeyword)];
+  if (!parameter.isDec)
     {
     return -99999;
     }
-  return v.Atoll();
+  return parameter.longValue;
 }
 
 double CAP::Configuration::getValueDouble (const char* aKeyword) const
 {
-  CAP::String v = getParameter(aKeyword);
-  if (!v.IsFloat())
+  const Parameter & parameter = parameters[findParameter(aKeyword)];
+  if (!parameter.isFloat)
     {
     return -1.0E100;
     }
-  return v.Atof();
+  return parameter.doubleValue;
  }
 
 
@@ -162,11 +187,8 @@ void CAP::Configuration::addParameters(const Configuration & source)
   for (iter = source.parameters.begin(); iter != source.parameters.end(); iter++)
     {
     //cout << "======== Adding parameter.keyword = " << iter->keyword << " value   = " << iter->value << endl;
-    Parameter  parameter;
-    parameter.keyword = iter->keyword;
-    parameter.value   = iter->value;
+    Parameter  parameter = *iter;
     addParameter(parameter);
-    int index = -1 + parameters.size();
     //cout << "======== Added parameter.keyword = " << parameters[index].keyword << " value   = " << parameters[index].value << endl;
     }
   //cout << "======== Final:  " << parameters.size() << endl;
@@ -175,26 +197,19 @@ void CAP::Configuration::addParameters(const Configuration & source)
 
 void CAP::Configuration::addParameter(Parameter& parameter)
 {
-  vector<Parameter>::iterator iter;
-  bool stop = false;
-
-//  if (parameter.keyword.Contains("EventsAnalyze"))
-//    {
-//    cout << "Searching for EventsAnalyze " << endl;
-//    stop = true;
-//    }
-  String keySearched = parameter.keyword;
-  //cout << "======== CAP::Configuration::addParameter(" << keySearched << ")" << endl;
-  for (iter = parameters.begin(); iter != parameters.end(); iter++)
+  auto found = keywordIndex.find(parameter.keyword.Data());
+  if (found != keywordIndex.end())
     {
-    String keyCompared = iter->keyword;
-    if (keyCompared.EqualTo(keySearched.Data()))
-      {
-        iter->value = parameter.value;
-        return;
-      }
+    Parameter & existing = parameters[found->second];
+    existing.value = parameter.value;
+    existing.parse();
+    return;
     }
+  unsigned int index = parameters.size();
   parameters.push_back(parameter);
+  parameters[index].parse();
+  keywordIndex.emplace(parameter.keyword.Data(),index);
+  indexParameter(index);
 }
 
 void CAP::Configuration::addParameter(const char * name, bool value)
@@ -388,14 +403,7 @@ bool CAP::Configuration::isString(const char * keyword) const
 
 bool CAP::Configuration::isFound(const char * keyword) const
 {
-  vector<Parameter>::const_iterator iter;
-  for (iter = parameters.begin(); iter != parameters.end(); iter++)
-    if (iter->keyword == keyword)
-      {
-      //cout << "<CAP::Configuration::getParameter>\tReturning value " << Iter->value << " for keyword " << Iter->keyword << endl;
-      return true;
-      }
-  return false;
+  return keywordIndex.find(keyword) != keywordIndex.end();
 }
 
 
@@ -495,6 +503,26 @@ void CAP::Configuration::addSelectedValues(const char *  keyBaseName, const char
 void CAP::Configuration::clear()
 {
   parameters.clear();
+  keywordIndex.clear();
+  suffixIndex.clear();
+}
+
+CAP::Configuration CAP::Configuration::getSnapshot(const char * path) const
+{
+  Configuration snapshot;
+  // match whole path components only: path "Task1" must not capture "Task10:..."
+  String prefix = path;
+  if (!prefix.EndsWith(":")) prefix += ":";
+  vector<Parameter>::const_iterator iter;
+  for (iter = parameters.begin(); iter != parameters.end(); iter++)
+    {
+    if (iter->keyword.BeginsWith(prefix))
+      {
+      Parameter parameter = *iter;
+      snapshot.addParameter(parameter);
+      }
+    }
+  return snapshot;
 }
 
 void CAP::Configuration::readFromFile(const char * _inputPath,
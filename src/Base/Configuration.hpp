@@ -13,6 +13,7 @@
 #define CAP__Configuration
 #include <iostream>
 #include <map>
+#include <unordered_map>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -34,10 +35,32 @@ class Configuration
 {
   //friend TextParser;
 
+  //!
+  //! Keyword and value of a parameter. The value is parsed once, when it is set, and kept in typed form so getValueXXX() calls
+  //! need not parse it again.
+  //!
   struct Parameter
   {
   String keyword;
   String value;
+  bool   isDec;
+  bool   isFloat;
+  bool   boolValue;
+  long   longValue;
+  double doubleValue;
+
+  Parameter()
+  :
+  keyword(),
+  value(),
+  isDec(false),
+  isFloat(false),
+  boolValue(false),
+  longValue(0),
+  doubleValue(0.0)
+  { }
+
+  void parse();
   };
 
 public:
@@ -47,6 +70,13 @@ public:
   Configuration & operator=(const Configuration & _configuration);
 
   String  getParameter(const char* aKeyword)  const;
+
+  //!
+  //! Return the index of the parameter matching the given keyword, i.e., the first parameter (in the order they were added) whose
+  //! keyword ends with the given keyword at a path boundary (':'). If none is found, keywords ending with the given keyword anywhere are
+  //! considered. Throws a ConfigurationException if no parameter matches.
+  //!
+  unsigned int findParameter(const char* aKeyword) const;
   int     getNParameters() const;
   bool    getValueBool(const char* aKeyword) const;
   int     getValueInt(const char* aKeyword) const;
@@ -94,6 +124,13 @@ public:
 
   void sanityCheck(const char * name);
 
+  //!
+  //! Returns a configuration holding only the parameters whose keyword lies under the given path, i.e., begins with the given path
+  //! followed by a colon. Lookups made from that path resolve as they do in this configuration, as long as no keyword outside the path
+  //! ends with the same path and key, while the snapshot is typically much smaller than the full configuration.
+  //!
+  Configuration getSnapshot(const char * path) const;
+
 
   //!
   //!Generates and stores in the configuration of this task a list of key,value parameters based on the given parameters.value
@@ -154,8 +191,25 @@ public:
   }
 
 protected:
+
+  //!
+  //! Register the suffixes of the keyword of the parameter at the given index in the suffix index.
+  //!
+  void indexParameter(unsigned int index);
+
   std::vector<Parameter> parameters;
 
+  //!
+  //! Index of each parameter by its full keyword.
+  //!
+  std::unordered_map<std::string,unsigned int> keywordIndex; //!
+
+  //!
+  //! Index of the first parameter whose keyword ends with a given suffix starting at a path boundary. For keyword "A:B:c", the
+  //! suffixes are "A:B:c", ":B:c", "B:c", ":c", and "c".
+  //!
+  std::unordered_map<std::string,unsigned int> suffixIndex; //!
+
   ClassDef(Configuration,0)
   
 };
@@ -247,6 +247,11 @@ void CAP::ConfigurationManager::setSeverity()
   setSeverityLevel(selectedLevel);
 }
 
+void CAP::ConfigurationManager::freezeConfiguration()
+{
+  configuration = configuration.getSnapshot(configurationPath);
+}
+
 void CAP::ConfigurationManager::setConfigurationPath(const CAP::String _configurationPath)
 {
   configurationPath = _configurationPath;
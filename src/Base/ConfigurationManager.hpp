@@ -128,6 +128,14 @@ public:
 
   int getNSelectedValues(const char *  path, const char *  keyBaseName, const char *  defaultValue) const;
 
+  //!
+  //! Replace the configuration of this instance by a snapshot holding only the parameters under its configuration path (see
+  //! Configuration::getSnapshot()). Call once configure() is complete, for tasks that only look up their own parameters; values
+  //! read afterwards are found in a much smaller configuration and are already parsed. RunAnalysis freezes the event analysis
+  //! tasks once their configuration is complete.
+  //!
+  void freezeConfiguration();
+
   void setConfigurationPath(const String _configurationPath);
   const String & getConfigurationPath() const;
 
@@ -23,11 +23,24 @@ namespace CAP
 DerivedHistoIterator::DerivedHistoIterator(const String & _name,
                                            const Configuration & _configuration)
 :
-Task(_name,_configuration)
+Task(_name,_configuration),
+maxConcurrentFiles(1),
+workerSubTasks(),
+filePool()
 {
   appendClassName("DerivedHistoIterator");
 }
 
+Task * DerivedHistoIterator::addWorkerSubTask(unsigned int iWorker, Task * task)
+{
+  if (iWorker==0) return addSubTask(task);
+  if (!task)  throw TaskException("Given task pointer is null.", "DerivedHistoIterator::addWorkerSubTask(unsigned int iWorker, Task * task)");
+  if (workerSubTasks.size()<iWorker) workerSubTasks.resize(iWorker);
+  workerSubTasks[iWorker-1].push_back(task);
+  task->setParent(this);
+  return task;
+}
+
 void DerivedHistoIterator::setDefaultConfiguration()
 {
   Task::setDefaultConfiguration();
@@ -36,6 +49,7 @@ void DerivedHistoIterator::setDefaultConfiguration()
   addParameter("HistogramsImport",         true);
   addParameter("HistogramsExport",         true);
   addParameter("AppendedString",           TString("_Derived"));
+  addParameter("maxConcurrentFiles",       int(1));
   generateKeyValuePairs("IncludedPattern", none,20);
   generateKeyValuePairs("ExcludedPattern", none,20);
 }
@@ -55,6 +69,11 @@ void DerivedHistoIterator::configure()
   appendedString      = getValueString("AppendedString");
   maximumDepth        = 1; //getValueInt(   "MaximumDepth");
   defaultGroupSize    = 50; //getValueInt(   "DefaultGroupSize");
+  maxConcurrentFiles  = getValueInt(   "maxConcurrentFiles");
+  filePool.setMaxConcurrentFiles(maxConcurrentFiles);
+  for (unsigned int iWorker=0; iWorker<workerSubTasks.size(); iWorker++)
+    for (unsigned int iTask=0; iTask<workerSubTasks[iWorker].size(); iTask++)
+      workerSubTasks[iWorker][iTask]->configure();
 
   if (reportInfo(__FUNCTION__))
     {
@@ -67,6 +86,8 @@ void DerivedHistoIterator::configure()
     printItem("DefaultGroupSize",    defaultGroupSize);
     printItem("AppendedString",      appendedString);
     printItem("MaximumDepth",        maximumDepth);
+    printItem("maxConcurrentFiles",  maxConcurrentFiles);
+    printItem("nWorkers",            int(getNWorkers()));
     cout << endl;
     }
 }
@@ -152,60 +173,74 @@ void DerivedHistoIterator::execute()
       cout << " nFiles................: " << nFiles << endl;
       }
 
-    for (int iFile=0; iFile<nFiles; iFile++)
+    // workers beyond 0 need their own copy of this subtask
+    unsigned int nWorkers = 1;
+    while (nWorkers<getNWorkers() && workerSubTasks[nWorkers-1].size()>iTask) nWorkers++;
+    filePool.run(allFilesToProcess,nWorkers,[&](unsigned int iWorker, unsigned int iFile)
       {
-      histosImportFile  = allFilesToProcess[iFile];
-      histosExportFile  = removeRootExtension(histosImportFile);
-      histosExportFile += appendedString;
-      if (reportInfo(__FUNCTION__))
+      Task & task = (iWorker==0) ? subTask : *workerSubTasks[iWorker-1][iTask];
+      if (reportInfo("execute"))
         {
         cout << endl;
         printItem("nFiles",nFiles);
-        printItem("iFile",iFile);
-        printItem("Input file",histosImportFile);
-        printItem("Output file",histosExportFile);
-        }
-      String nullString = "";
-      subTask.setHistosCreate(false);
-      subTask.setHistosImport(true);
-      subTask.setHistosImportPath(nullString);
-      subTask.setHistosImportFile(histosImportFile);
-      subTask.setHistosImportDerived(false);
-      subTask.setHistosCreateDerived(true);
-      subTask.setHistosExport(true);
-      subTask.setHistosExportPath(nullString);
-      subTask.setHistosExportFile(histosExportFile);
-      subTask.setHistosReset(false);
-      subTask.setHistosClear(true);
-      subTask.setHistosPlot(false);
-      subTask.setHistosPrint(false);
-      subTask.setHistosScale(false);
-      subTask.setHistosForceRewrite(true);
-      if (reportInfo(__FUNCTION__))
-        {
-        cout << "Initialize task : " << subTask.getName() << endl;
-        }
-      subTask.initialize();
-      if (reportInfo(__FUNCTION__))
-        {
-        cout << "starting calculateDerivedHistograms for task : " << subTask.getName() << endl;
-        }
-      subTask.calculateDerivedHistograms();
-      if (reportInfo(__FUNCTION__))
-        {
-        cout << "complted calculateDerivedHistograms for task : " << subTask.getName() << endl;
-        }
-      subTask.exportHistograms();
-      subTask.clearHistograms();
-      subTask.closeHistogramFiles();
-      if (reportInfo(__FUNCTION__))
-        {
-        cout << "Finisihed w/ file : " << iFile << endl;
+        printItem("iFile",int(iFile));
+        printItem("iWorker",int(iWorker));
         }
-      }
+      processFile(task,allFilesToProcess[iFile]);
+      });
+    if (reportInfo(__FUNCTION__)) filePool.printReport(cout);
     }
   if (reportEnd(__FUNCTION__))
     ;
 }
 
+void DerivedHistoIterator::processFile(Task & subTask, const String & importFile)
+{
+  String exportFile = removeRootExtension(importFile);
+  exportFile += appendedString;
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("Input file",importFile);
+    printItem("Output file",exportFile);
+    }
+  String nullString = "";
+  subTask.setHistosCreate(false);
+  subTask.setHistosImport(true);
+  subTask.setHistosImportPath(nullString);
+  subTask.setHistosImportFile(importFile);
+  subTask.setHistosImportDerived(false);
+  subTask.setHistosCreateDerived(true);
+  subTask.setHistosExport(true);
+  subTask.setHistosExportPath(nullString);
+  subTask.setHistosExportFile(exportFile);
+  subTask.setHistosReset(false);
+  subTask.setHistosClear(true);
+  subTask.setHistosPlot(false);
+  subTask.setHistosPrint(false);
+  subTask.setHistosScale(false);
+  subTask.setHistosForceRewrite(true);
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << "Initialize task : " << subTask.getName() << endl;
+    }
+  subTask.initialize();
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << "starting calculateDerivedHistograms for task : " << subTask.getName() << endl;
+    }
+  subTask.calculateDerivedHistograms();
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << "complted calculateDerivedHistograms for task : " << subTask.getName() << endl;
+    }
+  subTask.exportHistograms();
+  subTask.clearHistograms();
+  subTask.closeHistogramFiles();
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << "Finisihed w/ file : " << importFile << endl;
+    }
+}
+
 } // namespace CAP
@@ -12,6 +12,7 @@
 #ifndef CAP__DerivedHistoIterator
 #define CAP__DerivedHistoIterator
 #include "Task.hpp"
+#include "FileTaskPool.hpp"
 
 namespace CAP
 {
@@ -23,6 +24,9 @@ namespace CAP
 //!which are then set as errors in the histograms saved on output. The name of the output file is generated based on the template name
 //!and a selected appendString name. This class should NOT be run as a subtask of a more complex task in its current form.
 //!
+//!With maxConcurrentFiles>1, the selected files are processed concurrently. Worker k>0 uses its own replica of the subtasks, added
+//!with addWorkerSubTask(k,task), so the number of workers is limited by the number of replica sets provided.
+//!
 class DerivedHistoIterator : public Task
 {
 protected:
@@ -38,6 +42,10 @@ protected:
   int    nInputFile;
   int    maximumDepth;
   int    nEventFilters;
+  int    maxConcurrentFiles;
+
+  vector< vector<Task*> > workerSubTasks; //!
+  FileTaskPool            filePool;       //!
 
  // bool   histosForceRewrite;
 
@@ -73,6 +81,29 @@ public:
   //!
   virtual void execute();
 
+  //!
+  //! Add the given task to the replica set of worker iWorker. Replicas must be added in the same order as the subtasks of this iterator.
+  //! For iWorker==0, the task is added as a regular subtask.
+  //!
+  Task * addWorkerSubTask(unsigned int iWorker, Task * task);
+
+  //!
+  //! Number of workers available: one plus the number of replica sets.
+  //!
+  unsigned int getNWorkers() const
+  {
+  return 1 + workerSubTasks.size();
+  }
+
+protected:
+
+  //!
+  //! Compute and export the derived histograms of the given input file with the given (sub)task.
+  //!
+  virtual void processFile(Task & subTask, const String & importFile);
+
+public:
+
   ClassDef(DerivedHistoIterator,0)
 };
 
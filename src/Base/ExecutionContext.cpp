@@ -0,0 +1,59 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "ExecutionContext.hpp"
+using CAP::ExecutionContext;
+using CAP::String;
+
+ExecutionContext::ExecutionContext(ExecutionContext * _parent)
+:
+state(OK),
+cancelled(false),
+parent(_parent)
+{   }
+
+String ExecutionContext::getStateName() const
+{
+  String stateName;
+  switch (getState())
+    {
+      case OK:        stateName = "OK";        break;
+      case EOFILE:    stateName = "EOF";       break;
+      case EODATA:    stateName = "EOD";       break;
+      case ERROR:     stateName = "ERROR";     break;
+      case CANCELLED: stateName = "CANCELLED"; break;
+    }
+  if (getState()==OK && isCancelled()) stateName = "CANCELLED";
+  return stateName;
+}
+
+void ExecutionContext::reset()
+{
+  state     = OK;
+  cancelled = false;
+}
+
+bool ExecutionContext::isCancelled() const
+{
+  const ExecutionContext * context = this;
+  while (context)
+    {
+    if (context->cancelled) return true;
+    context = context->parent;
+    }
+  return false;
+}
+
+ExecutionContext * ExecutionContext::getDefaultContext()
+{
+  static ExecutionContext defaultContext;
+  return &defaultContext;
+}
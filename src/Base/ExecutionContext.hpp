@@ -0,0 +1,109 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ExecutionContext
+#define CAP__ExecutionContext
+#include <atomic>
+#include "Aliases.hpp"
+
+namespace CAP
+{
+
+//!
+//! ExecutionContext
+//!
+//! Execution state (end of file, end of data, error, cancellation) of one stream of execution, i.e., the task tree driven by one
+//! TaskIterator or by one of its worker threads. A reader reaching the end of its data posts EODATA on its own context only, so
+//! other iterators or streams running in the same process carry on. A context may have a parent context: cancelling the parent
+//! cancels all its children streams. State changes are atomic and may be posted and read from different threads.
+//!
+class ExecutionContext
+{
+public:
+
+  enum State { OK, EOFILE, EODATA, ERROR, CANCELLED };
+
+  //!
+  //! CTOR
+  //!
+  ExecutionContext(ExecutionContext * _parent=nullptr);
+
+  //!
+  //! DTOR
+  //!
+  virtual ~ExecutionContext() {}
+
+  //!
+  //! Set the state of this stream
+  //!
+  void setState(State newState)  {  state = newState;   }
+
+  //!
+  //! Get the state of this stream
+  //!
+  State getState() const  {  return State(state.load());   }
+
+  //!
+  //! Returns a string corresponding to the current state of this stream.
+  //!
+  String getStateName() const;
+
+  //!
+  //! Restore the OK state and clear the cancellation request. Call before (re)starting the stream.
+  //!
+  void reset();
+
+  //!
+  //! Request this stream and all its children streams to stop as soon as possible.
+  //!
+  void cancel()  {  cancelled = true;  }
+
+  //!
+  //! Returns true if this stream or one of its ancestors was cancelled.
+  //!
+  bool isCancelled() const;
+
+  inline bool  isOk() const     { return state == OK; }
+  inline bool  isEof() const    { return state == EOFILE; }
+  inline bool  isEod() const    { return state == EODATA; }
+  inline bool  isError() const  { return state == ERROR; }
+
+  //!
+  //! Returns true if this stream must stop: its state is no longer OK or it was cancelled.
+  //!
+  inline bool  isDone() const   { return state != OK || isCancelled(); }
+
+  //!
+  //! Get the parent context if any
+  //!
+  ExecutionContext * getParent() const { return parent; }
+
+  //!
+  //! Set the parent context
+  //!
+  void setParent(ExecutionContext * _parent) { parent = _parent; }
+
+  //!
+  //! Get the process wide context used by tasks that are not driven by an iterator.
+  //!
+  static ExecutionContext * getDefaultContext();
+
+protected:
+
+  std::atomic<int>   state;
+  std::atomic<bool>  cancelled;
+  ExecutionContext * parent;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ExecutionContext */
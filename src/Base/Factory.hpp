@@ -16,13 +16,18 @@
 //! Factory
 //!
 //! Generic base class for factory services.
-//! A factory can be used to generate and own a large collection of objects of the same type "T". Objects are allocated on the heap and pointers "T*" to these
-//! objects kept in a large array T ** objects. The array is nominally of fixed size but is enlarged whenever more objects are needed. The factory model is useful
+//! A factory can be used to generate and own a large collection of objects of the same type "T". The objects are allocated on the heap in slabs, i.e., arrays
+//! of contiguous objects, so consecutive calls to getNextObject() return objects adjacent in memory. The factory is enlarged, whenever more objects are needed,
+//! by adding a new slab as large as the current capacity: existing objects are never moved and pointers to them remain valid. The factory model is useful
 //! when objects need to be repeatedly used and discarded (e.g., in data analysis of particles) because no malloc or destroy is required. The memory remains allocated
 //! and so there is no time wasted creating and destroying the objects. The reset method is to be called on a factory to indicate that a new "event" is being considered.
 //! It must evidently be possible to initialize the objects with "set" methods specific to the class "T". Use the  T * getNextObject() method to obtain an used object.
 //!
+//! A factory is not thread safe. Classes using a factory from several threads (e.g., Particle, ParticleDigit, VectorField) hold one factory per thread.
+//!
 #include <iostream>
+#include <vector>
+#include <new>
 #include "TObject.h"
 #include "Exceptions.hpp"
 
@@ -40,7 +45,39 @@ protected:
   /////////////////////////////////////////////////////////////
   long capacity;
   long index;
-  T ** objects;
+  vector<T*>   slabs;       //! slabs of contiguous objects
+  vector<long> slabSizes;   //! number of objects in each slab
+  unsigned int slabIndex;   //! slab providing the next object
+  long slabPosition;        //! position of the next object in its slab
+  long highWaterMark;       //! largest number of objects in use since initialization
+  long nGrowths;            //! number of slabs added after initialization
+
+  //!
+  //! Allocate a new slab of the given size and append it to the factory.
+  //!
+  void addSlab(long size)
+  {
+  T * slab = nullptr;
+  try
+    {
+    slab = new T[size];
+    }
+  catch (const std::bad_alloc &)
+    {
+    throw FactoryException(capacity, capacity+size, "Unable to allocate new capacity","Factory::addSlab()");
+    }
+  slabs.push_back(slab);
+  slabSizes.push_back(size);
+  capacity += size;
+  }
+
+  void deleteSlabs()
+  {
+  for (unsigned int k=0; k<slabs.size(); k++) delete[] slabs[k];
+  slabs.clear();
+  slabSizes.clear();
+  capacity = 0;
+  }
 
   public:
   /////////////////////////////////////////////////////////////
@@ -51,30 +88,37 @@ protected:
   TObject(),
   capacity(0),
   index(0),
-  objects(0)
+  slabs(),
+  slabSizes(),
+  slabIndex(0),
+  slabPosition(0),
+  highWaterMark(0),
+  nGrowths(0)
   {
    // no ops
   }
   
   virtual ~Factory()
   {
-  delete[] objects;
+  deleteSlabs();
   }
 
   void initialize(int initialCapacity)
   {
-  if (objects) delete[] objects;
-    capacity = initialCapacity;
-    objects = new T*[capacity];
-    for (int k=0; k<capacity; k++)
-      {
-      objects[k] = new T();
-      }
+  deleteSlabs();
+  index         = 0;
+  slabIndex     = 0;
+  slabPosition  = 0;
+  highWaterMark = 0;
+  nGrowths      = 0;
+  addSlab(initialCapacity>0 ? initialCapacity : 1);
   }
 
   void reset()
   {
-  index = 0;
+  index        = 0;
+  slabIndex    = 0;
+  slabPosition = 0;
   }
 
   // Returns the capacity of this store/factory
@@ -95,30 +139,58 @@ protected:
   return index-1;
   }
 
+  // Returns the largest number of objects used at once since the factory was initialized
+  long getHighWaterMark() const
+  {
+  return highWaterMark;
+  }
+
+  // Returns the number of slabs added to the factory because its capacity was exceeded
+  long getNGrowths() const
+  {
+  return nGrowths;
+  }
+
+  // Returns the number of slabs of the factory
+  unsigned int getNSlabs() const
+  {
+  return slabs.size();
+  }
+
+  // Returns the memory size (in bytes) of the objects owned by the factory
+  long getBytes() const
+  {
+  return capacity*long(sizeof(T));
+  }
+
+  void printStatistics(ostream & os) const
+  {
+  os << "Factory -- capacity: " << capacity
+     << " slabs: "               << slabs.size()
+     << " growths: "             << nGrowths
+     << " high water mark: "     << highWaterMark
+     << " bytes: "               << getBytes() << endl;
+  }
+
   T * getNextObject() 
   {
-  if (index<capacity)
+  if (slabIndex<slabs.size() && slabPosition==slabSizes[slabIndex])
     {
-    ///cout << "Factory<T>::getNextObject() Index: " << index << " Capacity: " << capacity <<  endl;
-    return objects[index++];
+    slabIndex++;
+    slabPosition = 0;
     }
-  else
+  if (slabIndex==slabs.size())
     {
     ///cout << "Factory<T>::getNextObject() Index: " << index << " Capacity: " << capacity << " ==================================  Capacity will be doubled."  << endl;
-    T** keep = objects;
-    long newCapacity = 2*capacity;
-    objects = new T*[newCapacity];
-    if (!objects)
-      {
-      throw FactoryException(capacity, newCapacity, "Unable to allocate new capacity","Factory::getNextObject()");
-      }
-    for (long k=0; k<capacity; k++) objects[k] = keep[k];
-    for (long k=capacity; k<newCapacity; k++) objects[k] = new T();
-    delete[] keep;
-    capacity = newCapacity;
+    addSlab(capacity>0 ? capacity : 1);
+    nGrowths++;
     cout << "<W> Factory::getObject() Object capacity increased to : " << capacity << endl;
-    return objects[index++];
     }
+  T * object = slabs[slabIndex] + slabPosition;
+  slabPosition++;
+  index++;
+  if (index>highWaterMark) highWaterMark = index;
+  return object;
   }
 
 //  T * getObjectAt(unsigned long index)
@@ -0,0 +1,107 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include "TROOT.h"
+#include "FileTaskPool.hpp"
+using CAP::FileTaskPool;
+using std::endl;
+
+FileTaskPool::FileTaskPool(int _maxConcurrentFiles)
+:
+maxConcurrentFiles(_maxConcurrentFiles<1 ? 1 : _maxConcurrentFiles),
+nWorkersUsed(0),
+fileNames(),
+fileTimes(),
+fileWorkers(),
+wallTime(0.0)
+{   }
+
+void FileTaskPool::run(const VectorString & _fileNames, unsigned int nWorkers, FileOperation operation)
+{
+  fileNames = _fileNames;
+  unsigned int nFiles = fileNames.size();
+  fileTimes.assign(nFiles,0.0);
+  fileWorkers.assign(nFiles,-1);
+  nWorkersUsed = nWorkers;
+  if (nWorkersUsed>(unsigned int) maxConcurrentFiles) nWorkersUsed = maxConcurrentFiles;
+  if (nWorkersUsed>nFiles) nWorkersUsed = nFiles;
+  if (nWorkersUsed<1)      nWorkersUsed = 1;
+
+  std::atomic<unsigned int> nextFile(0);
+  std::atomic<bool>         failed(false);
+  std::exception_ptr        exception;
+  std::mutex                mutex;
+  auto work = [&](unsigned int iWorker)
+    {
+    try
+    {
+    while (!failed)
+      {
+      unsigned int iFile = nextFile++;
+      if (iFile>=nFiles) break;
+      auto fileStart = std::chrono::steady_clock::now();
+      operation(iWorker,iFile);
+      fileTimes[iFile]   = std::chrono::duration<double>(std::chrono::steady_clock::now()-fileStart).count();
+      fileWorkers[iFile] = iWorker;
+      }
+    }
+    catch (...)
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!exception) exception = std::current_exception();
+    failed = true;
+    }
+    };
+
+  auto start = std::chrono::steady_clock::now();
+  if (nWorkersUsed==1)
+    {
+    work(0);
+    }
+  else
+    {
+    ROOT::EnableThreadSafety();
+    std::vector<std::thread> workers;
+    for (unsigned int iWorker=1; iWorker<nWorkersUsed; iWorker++) workers.push_back(std::thread(work,iWorker));
+    work(0);
+    for (unsigned int iWorker=0; iWorker<workers.size(); iWorker++) workers[iWorker].join();
+    }
+  wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+  if (exception) std::rethrow_exception(exception);
+}
+
+void FileTaskPool::printReport(std::ostream & output) const
+{
+  std::ios_base::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+  double sumTime = 0.0;
+  output << endl;
+  output << "-------------------------------------------------------------------------------------" << endl;
+  output << " Files processed: " << fileNames.size() << "  Workers: " << nWorkersUsed << endl;
+  output << "-------------------------------------------------------------------------------------" << endl;
+  for (unsigned int iFile=0; iFile<fileNames.size(); iFile++)
+    {
+    output << std::setw(6) << iFile << "  worker " << std::setw(3) << fileWorkers[iFile]
+           << "  " << std::fixed << std::setprecision(2) << std::setw(10) << fileTimes[iFile] << " s  " << fileNames[iFile] << endl;
+    sumTime += fileTimes[iFile];
+    }
+  output << "-------------------------------------------------------------------------------------" << endl;
+  output << " Sum of file times: " << std::fixed << std::setprecision(2) << sumTime << " s   Wall time: " << wallTime << " s" << endl;
+  output << "-------------------------------------------------------------------------------------" << endl;
+  output.flags(flags);
+  output.precision(precision);
+}
@@ -0,0 +1,87 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__FileTaskPool
+#define CAP__FileTaskPool
+#include <functional>
+#include <iostream>
+#include <vector>
+#include "Aliases.hpp"
+
+namespace CAP
+{
+
+//!
+//! FileTaskPool
+//!
+//! Runs a file level operation (open, compute, write) over a list of files on up to maxConcurrentFiles threads. Each worker
+//! repeatedly claims the next unprocessed file, so workers that finish early pick up the remaining files. A worker handles one
+//! file at a time, which bounds the number of files open simultaneously. The processing time of each file is recorded for the report.
+//! With a single worker, files are processed in order in the calling thread.
+//!
+class FileTaskPool
+{
+public:
+
+  //!
+  //! Operation carried out by worker iWorker on file iFile.
+  //!
+  using FileOperation = std::function<void(unsigned int iWorker, unsigned int iFile)>;
+
+  FileTaskPool(int _maxConcurrentFiles=1);
+
+  virtual ~FileTaskPool() {}
+
+  //!
+  //! Process the given files with at most nWorkers workers (further limited by maxConcurrentFiles and the number of files).
+  //! The first exception thrown by the operation stops the pool; it is rethrown once all workers are done.
+  //!
+  void run(const VectorString & _fileNames, unsigned int nWorkers, FileOperation operation);
+
+  //!
+  //! Print the processing time of each file and the wall time of the last call to run().
+  //!
+  void printReport(std::ostream & output) const;
+
+  int getMaxConcurrentFiles() const
+  {
+  return maxConcurrentFiles;
+  }
+
+  void setMaxConcurrentFiles(int _maxConcurrentFiles)
+  {
+  maxConcurrentFiles = _maxConcurrentFiles<1 ? 1 : _maxConcurrentFiles;
+  }
+
+  double getFileTime(unsigned int iFile) const
+  {
+  return fileTimes[iFile];
+  }
+
+  double getWallTime() const
+  {
+  return wallTime;
+  }
+
+protected:
+
+  int                 maxConcurrentFiles;
+  unsigned int        nWorkersUsed;
+  VectorString        fileNames;
+  std::vector<double> fileTimes;    //!< processing time of each file (seconds)
+  std::vector<int>    fileWorkers;  //!< worker that processed each file
+  double              wallTime;     //!< wall time of the last run (seconds)
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__FileTaskPool */
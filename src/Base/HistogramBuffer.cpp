@@ -0,0 +1,230 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <cmath>
+#include "HistogramBuffer.hpp"
+using CAP::HistogramBuffer;
+
+HistogramBuffer::HistogramBuffer(TH1 * _histogram)
+:
+histogram(_histogram),
+xAxis(_histogram->GetXaxis()),
+yAxis(_histogram->GetYaxis()),
+profile(dynamic_cast<TProfile*>(_histogram)),
+profile2D(dynamic_cast<TProfile2D*>(_histogram)),
+hasSumw2(false),
+hasBinSumw2(false),
+strideX(_histogram->GetNbinsX()+2),
+entries(0),
+contents(),
+sumw2(),
+binEntries(),
+binSumw2(),
+trackTouched(false),
+touched()
+{
+  unsigned int nCells = histogram->GetNcells();
+  contents.assign(nCells,0.0);
+  if (profile || profile2D)
+    {
+    // profiles always hold the sums of weighted squared values
+    hasSumw2    = true;
+    hasBinSumw2 = (profile ? profile->GetBinSumw2()->GetSize() : profile2D->GetBinSumw2()->GetSize())>0;
+    binEntries.assign(nCells,0.0);
+    if (hasBinSumw2) binSumw2.assign(nCells,0.0);
+    }
+  else
+    {
+    hasSumw2 = histogram->GetSumw2N()>0;
+    }
+  if (hasSumw2) sumw2.assign(nCells,0.0);
+}
+
+template <class P>
+void HistogramBuffer::flushProfile(P * p)
+{
+  unsigned int nCells = contents.size();
+  double * array         = p->GetArray();
+  double * sumw2Array    = p->GetSumw2()->GetArray();
+  double * binSumw2Array = hasBinSumw2 ? p->GetBinSumw2()->GetArray() : nullptr;
+  for (unsigned int bin=0; bin<nCells; bin++)
+    {
+    if (binEntries[bin]==0.0) continue;
+    array[bin]      += contents[bin];
+    sumw2Array[bin] += sumw2[bin];
+    p->SetBinEntries(bin,p->GetBinEntries(bin)+binEntries[bin]);
+    if (hasBinSumw2) binSumw2Array[bin] += binSumw2[bin];
+    }
+}
+
+bool HistogramBuffer::hasContent() const
+{
+  if (entries>0) return true;
+  unsigned int nCells  = contents.size();
+  unsigned int nBlocks = trackTouched ? touched.size() : 1;
+  for (unsigned int iBlock=0; iBlock<nBlocks; iBlock++)
+    {
+    unsigned int first = 0;
+    unsigned int last  = nCells;
+    if (trackTouched)
+      {
+      if (!touched[iBlock]) continue;
+      first = iBlock<<blockShift;
+      last  = std::min(first+(1u<<blockShift),nCells);
+      }
+    for (unsigned int bin=first; bin<last; bin++)
+      {
+      if (contents[bin]!=0.0) return true;
+      if (!sumw2.empty()      && sumw2[bin]!=0.0)      return true;
+      if (!binEntries.empty() && binEntries[bin]!=0.0) return true;
+      }
+    }
+  return false;
+}
+
+void HistogramBuffer::flush()
+{
+  // buffers filled with add() may hold content without counted entries: whether there is anything to flush is decided on the content.
+  if (!hasContent()) return;
+  // the statistics of the histogram, which may also be filled directly, are kept and those of the buffer added to them. They are
+  // read before the bins are updated because TH1::GetStats() may compute them from the bin contents.
+  double stats[TH1::kNstat];
+  std::fill(stats,stats+TH1::kNstat,0.0);
+  histogram->GetStats(stats);
+  if (profile)
+    {
+    flushProfile(profile);
+    }
+  else if (profile2D)
+    {
+    flushProfile(profile2D);
+    }
+  else
+    {
+    unsigned int nCells = contents.size();
+    double * sumw2Array = hasSumw2 ? histogram->GetSumw2()->GetArray() : nullptr;
+    for (unsigned int bin=0; bin<nCells; bin++)
+      {
+      if (contents[bin]==0.0 && (!hasSumw2 || sumw2[bin]==0.0)) continue;
+      histogram->AddBinContent(bin,contents[bin]);
+      if (hasSumw2) sumw2Array[bin] += sumw2[bin];
+      }
+    }
+  addStats(stats);
+  double nEntries = histogram->GetEntries() + entries;
+  histogram->PutStats(stats);
+  histogram->SetEntries(nEntries);
+  reset();
+}
+
+void HistogramBuffer::addStats(double * stats) const
+{
+  // as TH1::ResetStats() does, the statistics are computed at the bin centers, excluding the underflow and overflow bins
+  bool twoD = histogram->GetDimension()>1;
+  int nBinsX = xAxis->GetNbins();
+  int nBinsY = twoD ? yAxis->GetNbins() : 1;
+  for (int iy=(twoD?1:0); iy<=(twoD?nBinsY:0); iy++)
+    {
+    double y = twoD ? yAxis->GetBinCenter(iy) : 0.0;
+    for (int ix=1; ix<=nBinsX; ix++)
+      {
+      int bin  = getBin(ix,iy);
+      double x = xAxis->GetBinCenter(ix);
+      double w, w2;
+      if (profile || profile2D)
+        {
+        w  = binEntries[bin];
+        w2 = hasBinSumw2 ? binSumw2[bin] : w;
+        }
+      else
+        {
+        w  = contents[bin];
+        w2 = hasSumw2 ? sumw2[bin] : std::abs(w);
+        }
+      if (w==0.0 && w2==0.0) continue;
+      stats[0] += w;
+      stats[1] += w2;
+      stats[2] += w*x;
+      stats[3] += w*x*x;
+      if (profile)
+        {
+        stats[4] += contents[bin];
+        stats[5] += sumw2[bin];
+        }
+      else if (twoD)
+        {
+        stats[4] += w*y;
+        stats[5] += w*y*y;
+        stats[6] += w*x*y;
+        if (profile2D)
+          {
+          stats[7] += contents[bin];
+          stats[8] += sumw2[bin];
+          }
+        }
+      }
+    }
+}
+
+void HistogramBuffer::add(const HistogramBuffer & other)
+{
+  unsigned int nCells  = contents.size();
+  unsigned int nBlocks = other.trackTouched ? other.touched.size() : 1;
+  for (unsigned int iBlock=0; iBlock<nBlocks; iBlock++)
+    {
+    unsigned int first = 0;
+    unsigned int last  = nCells;
+    if (other.trackTouched)
+      {
+      if (!other.touched[iBlock]) continue;
+      first = iBlock<<blockShift;
+      last  = std::min(first+(1u<<blockShift),nCells);
+      if (trackTouched) touched[iBlock] = 1;
+      }
+    for (unsigned int bin=first; bin<last; bin++) contents[bin] += other.contents[bin];
+    if (hasSumw2)    for (unsigned int bin=first; bin<last; bin++) sumw2[bin]      += other.sumw2[bin];
+    if (profile || profile2D)
+      for (unsigned int bin=first; bin<last; bin++) binEntries[bin] += other.binEntries[bin];
+    if (hasBinSumw2) for (unsigned int bin=first; bin<last; bin++) binSumw2[bin]   += other.binSumw2[bin];
+    }
+  entries += other.entries;
+}
+
+void HistogramBuffer::setTrackTouched(bool track)
+{
+  trackTouched = track;
+  touched.assign(track ? ((contents.size()>>blockShift)+1) : 0, track ? 1 : 0);
+}
+
+void HistogramBuffer::reset()
+{
+  entries = 0;
+  if (trackTouched)
+    {
+    unsigned int nCells = contents.size();
+    for (unsigned int iBlock=0; iBlock<touched.size(); iBlock++)
+      {
+      if (!touched[iBlock]) continue;
+      touched[iBlock] = 0;
+      unsigned int first = iBlock<<blockShift;
+      unsigned int last  = std::min(first+(1u<<blockShift),nCells);
+      std::fill(contents.begin()+first,contents.begin()+last,0.0);
+      if (!sumw2.empty())      std::fill(sumw2.begin()+first,sumw2.begin()+last,0.0);
+      if (!binEntries.empty()) std::fill(binEntries.begin()+first,binEntries.begin()+last,0.0);
+      if (!binSumw2.empty())   std::fill(binSumw2.begin()+first,binSumw2.begin()+last,0.0);
+      }
+    return;
+    }
+  std::fill(contents.begin(),contents.end(),0.0);
+  std::fill(sumw2.begin(),sumw2.end(),0.0);
+  std::fill(binEntries.begin(),binEntries.end(),0.0);
+  std::fill(binSumw2.begin(),binSumw2.end(),0.0);
+}
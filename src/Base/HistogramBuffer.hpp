@@ -0,0 +1,191 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__HistogramBuffer
+#define CAP__HistogramBuffer
+#include <vector>
+#include <algorithm>
+#include "TH1.h"
+#include "TAxis.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+
+using std::vector;
+
+namespace CAP
+{
+
+//!
+//! Plain array accumulating the content of a histogram during the event loop. The array is laid out like the bins of the histogram,
+//! including the underflow and overflow bins, so the global bin number of a TH1 or TH2 indexes it directly; the number of entries
+//! is kept as an integer. Filling a buffer thus requires neither virtual calls nor updates of the histogram statistics.
+//! The content of the buffer is added to the histogram, and the buffer zeroed, by flush(). HistogramGroup flushes the buffers it
+//! created before the histograms are scaled, merged, or saved (see HistogramGroup::flush()).
+//!
+//! Profiles (TProfile and TProfile2D) are supported as well: the buffer then accumulates the sums of weights, of weighted values,
+//! and of weighted squared values of each bin (see fillProfile()).
+//!
+class HistogramBuffer
+{
+public:
+
+  //!
+  //! Create a buffer for the given histogram, which must have fixed number of bins.
+  //!
+  HistogramBuffer(TH1 * _histogram);
+
+  virtual ~HistogramBuffer() {}
+
+  //!
+  //! Add the given weight to the given global bin, without counting an entry. Count the entries with addEntries(): the content
+  //! is flushed regardless, but the number of entries of the histogram is only incremented by the entries counted.
+  //!
+  inline void add(int bin, double weight)
+  {
+  if (trackTouched) touched[bin>>blockShift] = 1;
+  contents[bin] += weight;
+  if (hasSumw2) sumw2[bin] += weight*weight;
+  }
+
+  //!
+  //! Count n entries.
+  //!
+  inline void addEntries(long n)
+  {
+  entries += n;
+  }
+
+  //!
+  //! Fill the bin of the given value of a 1D histogram, as TH1::Fill() does.
+  //!
+  inline void fill(double x, double weight)
+  {
+  add(xAxis->FindFixBin(x),weight);
+  entries++;
+  }
+
+  //!
+  //! Fill the bin of the given values of a 2D histogram, as TH2::Fill() does.
+  //!
+  inline void fill(double x, double y, double weight)
+  {
+  add(getBin(xAxis->FindFixBin(x),yAxis->FindFixBin(y)),weight);
+  entries++;
+  }
+
+  //!
+  //! Fill the bin of a 1D profile corresponding to x with the value y, as TProfile::Fill() does.
+  //!
+  inline void fillProfile(double x, double y, double weight)
+  {
+  addProfile(xAxis->FindFixBin(x),y,weight);
+  }
+
+  //!
+  //! Fill the bin of a 2D profile corresponding to x and y with the value z, as TProfile2D::Fill() does.
+  //!
+  inline void fillProfile(double x, double y, double z, double weight)
+  {
+  addProfile(getBin(xAxis->FindFixBin(x),yAxis->FindFixBin(y)),z,weight);
+  }
+
+  //!
+  //! Global bin number of the bins ix and iy of a 2D histogram.
+  //!
+  inline int getBin(int ix, int iy) const
+  {
+  return ix + strideX*iy;
+  }
+
+  //!
+  //! Difference of the global bin numbers of bins (ix,iy+1) and (ix,iy) of a 2D histogram.
+  //!
+  inline int getStrideX() const
+  {
+  return strideX;
+  }
+
+  //!
+  //! Add the content of the given buffer, which must be a buffer of a histogram with the same binning, to this buffer. Used
+  //! to reduce buffers filled by different threads. Only the touched blocks of bins are added if the given buffer tracks them.
+  //!
+  void add(const HistogramBuffer & other);
+
+  //!
+  //! Record which blocks of bins are filled, so add(const HistogramBuffer&) and reset() skip the blocks left untouched. Meant for
+  //! buffers reduced after each small batch of fills, e.g. the thread buffers of ParticlePairParallelFiller.
+  //!
+  void setTrackTouched(bool track);
+
+  //!
+  //! Returns true if any bin of this buffer has a non zero content, or entries were counted.
+  //!
+  bool hasContent() const;
+
+  //!
+  //! Add the content of this buffer to its histogram and zero the buffer. The statistics of the content of the buffer (sums of
+  //! weights, of weighted values and of their squares) are added to those of the histogram, which are left unchanged otherwise:
+  //! histograms filled both through a buffer and directly keep the exact statistics of their direct fills.
+  //!
+  void flush();
+
+  //!
+  //! Zero the buffer without changing the histogram.
+  //!
+  void reset();
+
+  TH1 * getHistogram() const
+  {
+  return histogram;
+  }
+
+protected:
+
+  inline void addProfile(int bin, double value, double weight)
+  {
+  if (trackTouched) touched[bin>>blockShift] = 1;
+  contents[bin]   += weight*value;
+  sumw2[bin]      += weight*value*value;
+  binEntries[bin] += weight;
+  if (hasBinSumw2) binSumw2[bin] += weight*weight;
+  entries++;
+  }
+
+  template <class P> void flushProfile(P * p);
+
+  //!
+  //! Add the statistics of the content of this buffer to the given array, laid out as by TH1::GetStats().
+  //!
+  void addStats(double * stats) const;
+
+  TH1 *          histogram;
+  TAxis *        xAxis;
+  TAxis *        yAxis;
+  TProfile *     profile;
+  TProfile2D *   profile2D;
+  bool           hasSumw2;
+  bool           hasBinSumw2;
+  int            strideX;
+  long           entries;
+  vector<double> contents;
+  vector<double> sumw2;
+  vector<double> binEntries;
+  vector<double> binSumw2;
+  bool           trackTouched;
+  vector<unsigned char> touched;   // whether each block of 2^blockShift bins was filled since the last reset
+
+  static const int blockShift = 6;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__HistogramBuffer */
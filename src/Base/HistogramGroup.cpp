@@ -15,6 +15,7 @@
 
 using CAP::Task;
 using CAP::HistogramGroup;
+using CAP::HistogramBuffer;
 using CAP::String;
 using CAP::Configuration;
 
@@ -26,12 +27,19 @@ HistogramGroup::HistogramGroup(Task * _parent,
 :
 HistogramCollection(_name),
 parent(_parent),
-configuration(_configuration)
+configuration(_configuration),
+buffers()
 {
   setClassName("HistogramGroup");
   setInstanceName(_name);
 }
 
+HistogramGroup::~HistogramGroup()
+{
+  for (unsigned int iBuffer=0; iBuffer<buffers.size(); iBuffer++) delete buffers[iBuffer];
+  buffers.clear();
+}
+
 //!
 //! Overload this class to create histograms.
 //!
@@ -50,6 +58,25 @@ void HistogramGroup::importHistograms(TFile & inputFile __attribute__((unused)))
 }
 
 
+HistogramBuffer * HistogramGroup::createBuffer(TH1 * histogram)
+{
+  if (!histogram) return nullptr;
+  HistogramBuffer * buffer = new HistogramBuffer(histogram);
+  buffers.push_back(buffer);
+  return buffer;
+}
+
+void HistogramGroup::flush()
+{
+  for (unsigned int iBuffer=0; iBuffer<buffers.size(); iBuffer++) buffers[iBuffer]->flush();
+}
+
+void HistogramGroup::reset()
+{
+  for (unsigned int iBuffer=0; iBuffer<buffers.size(); iBuffer++) buffers[iBuffer]->reset();
+  HistogramCollection::reset();
+}
+
 Task * HistogramGroup::getParentTask() const
 {
   return parent;
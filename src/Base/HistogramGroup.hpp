@@ -12,6 +12,7 @@
 #ifndef CAP__Histograms
 #define CAP__Histograms
 #include "HistogramCollection.hpp"
+#include "HistogramBuffer.hpp"
 #include "Configuration.hpp"
 #include "NameManager.hpp"
 
@@ -28,10 +29,21 @@ public:
              const String & _name,
              const Configuration & _configuration);
 
-  ~HistogramGroup() {}
+  ~HistogramGroup();
 
   virtual void createHistograms();
   virtual void importHistograms(TFile & inputFile);
+
+  //!
+  //! Add the content of the accumulation buffers of this group to their histograms. Called before the histograms are scaled,
+  //! merged, or saved.
+  //!
+  virtual void flush();
+
+  //!
+  //! Reset the histograms and the accumulation buffers of this group.
+  //!
+  virtual void reset();
   
   //!
   //! Returns the configuration of this histogram set
@@ -71,8 +83,15 @@ public:
 
 protected:
 
+  //!
+  //! Create an accumulation buffer for the given histogram. The buffer is owned and flushed by this group. Returns a null pointer
+  //! if the given histogram is null.
+  //!
+  HistogramBuffer * createBuffer(TH1 * histogram);
+
   Task * parent;
   Configuration configuration;
+  vector<HistogramBuffer*> buffers; //!
 
   ClassDef(HistogramGroup,0)
 };
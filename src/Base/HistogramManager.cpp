@@ -87,6 +87,7 @@ void CAP::HistogramManager::reset()
 //!
 void CAP::HistogramManager::save(TFile & outputFile)
 {
+  flush();
   //cout << "<INFO> CAP::HistogramManager::save(TFile & outputFile)" << endl;
   for (unsigned int iSet=0; iSet<sets.size(); iSet++)
     {
@@ -100,6 +101,7 @@ void CAP::HistogramManager::save(TFile & outputFile)
 
 void CAP::HistogramManager::save(ofstream & outputFile)
 {
+  flush();
   for (unsigned int iSet=0; iSet<sets.size(); iSet++)
     {
     for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
@@ -127,11 +129,60 @@ void CAP::HistogramManager::load(TFile & inputFile)
     }
 }
 
+void CAP::HistogramManager::saveContents(TDirectory & directory)
+{
+  flush();
+  directory.cd();
+  for (unsigned int iSet=0; iSet<sets.size(); iSet++)
+    {
+    for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
+      {
+      HistogramGroup * group = sets[iSet][iGroup];
+      for (unsigned int iObject=0; iObject<group->size(); iObject++) group->getObjectAt(iObject)->Write();
+      }
+    }
+}
+
+void CAP::HistogramManager::loadContents(TDirectory & directory)
+{
+  for (unsigned int iSet=0; iSet<sets.size(); iSet++)
+    {
+    for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
+      {
+      HistogramGroup * group = sets[iSet][iGroup];
+      for (unsigned int iObject=0; iObject<group->size(); iObject++)
+        {
+        TH1 * histogram = group->getObjectAt(iObject);
+        TH1 * saved = (TH1*) directory.Get(histogram->GetName());
+        if (!saved) throw HistogramException(histogram->GetName(),"Histogram not found","HistogramManager::loadContents(TDirectory & directory)");
+        histogram->Reset();
+        histogram->Add(saved);
+        delete saved;
+        }
+      }
+    }
+}
+
+//!
+//!Flush the accumulation buffers of all sets and all groups they contain
+//!
+void CAP::HistogramManager::flush()
+{
+  for (unsigned int iSet=0; iSet<sets.size(); iSet++)
+    {
+    for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
+      {
+      sets[iSet][iGroup]->flush();
+      }
+    }
+}
+
 //!
 //!Scale histograms of all sets and all groups they contain by the given factor
 //!
 void CAP::HistogramManager::scale(double scalingFactor)
 {
+  flush();
   for (unsigned int iSet=0; iSet<sets.size(); iSet++)
     {
     for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
@@ -140,3 +191,24 @@ void CAP::HistogramManager::scale(double scalingFactor)
       }
     }
 }
+
+//!
+//!Add the histograms of all sets and all groups of the given manager to those of this manager
+//!
+void CAP::HistogramManager::add(HistogramManager & source, double factor)
+{
+  flush();
+  source.flush();
+  unsigned int nSets = sets.size();
+  if (source.sets.size()!=nSets)
+    throw HistogramException("","source.sets.size()!=nSets","HistogramManager::add(HistogramManager & source, double factor)");
+  for (unsigned int iSet=0; iSet<nSets; iSet++)
+    {
+    if (source.sets[iSet].size()!=sets[iSet].size())
+      throw HistogramException(names[iSet],"Source set has a different number of groups","HistogramManager::add(HistogramManager & source, double factor)");
+    for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
+      {
+      sets[iSet][iGroup]->add(*source.sets[iSet][iGroup],factor);
+      }
+    }
+}
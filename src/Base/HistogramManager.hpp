@@ -81,11 +81,35 @@ public:
   //!
   void load(TFile & outputFile);
 
+  //!
+  //!Add the content of the accumulation buffers of all sets and all groups they contain to their histograms. Called by save(),
+  //!saveContents(), scale(), and add(), and by tasks before their histograms are scaled or exported.
+  //!
+  void flush();
+
   //!
   //!Scale histograms of all sets and all groups they contain by the given factor
   //!
   void scale(double scalingFactor);
 
+  //!
+  //!Add the histograms of all sets and all groups of the given manager, multiplied by the given factor, to those of this manager.
+  //!The two managers must have the same structure (number of sets and of groups per set).
+  //!
+  void add(HistogramManager & source, double factor=1.0);
+
+  //!
+  //!Write the histograms of all sets and all groups they contain in the given directory. Unlike save(), the histograms are written
+  //!in the given directory rather than at the top of its file. Used for checkpoints.
+  //!
+  void saveContents(TDirectory & directory);
+
+  //!
+  //!Replace the content of the histograms of all sets and all groups they contain by that of the same named histograms found in
+  //!the given directory. The histograms must already exist, i.e., have been created.
+  //!
+  void loadContents(TDirectory & directory);
+
   inline int getNSets()
   {
   return sets.size();
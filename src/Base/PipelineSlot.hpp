@@ -0,0 +1,37 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__PipelineSlot
+#define CAP__PipelineSlot
+
+namespace CAP
+{
+
+//!
+//! PipelineSlot
+//!
+//! Base class of the data units passed between the producer and consumer stages of a pipelined TaskIterator. A slot holds all the
+//! data (e.g., event streams) a task needs to process one event. Slots are created once by Task::createPipelineSlot(), attached to the
+//! tasks of a stage with Task::setPipelineSlot() before each call to execute(), and recycled through a free list.
+//!
+class PipelineSlot
+{
+public:
+
+  PipelineSlot() {}
+
+  virtual ~PipelineSlot() {}
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__PipelineSlot */
@@ -9,6 +9,7 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <iomanip>
 #include "TSystem.h"
 #include "TSystemDirectory.h"
 #include "TSystemFile.h"
@@ -28,6 +29,7 @@ IdentifiedObject         (),
 timer                    (),
 histogramManager         (),
 parent                   (nullptr),
+executionContext         (nullptr),
 histosCreate             (false),
 histosCreateDerived      (false),
 histosReset              (false),
@@ -72,6 +74,7 @@ IdentifiedObject         (_name,_name,"1.0",_name,_name,0),
 timer                    (),
 histogramManager         (),
 parent                   (nullptr),
+executionContext         (nullptr),
 histosCreate             (false),
 histosCreateDerived      (false),
 histosReset              (false),
@@ -228,7 +231,12 @@ void Task::finalize()
 {
   if (reportStart(__FUNCTION__))
     ;
-  if (histosExport)  exportHistograms();
+  flushHistograms();
+  if (histosExport)
+    {
+    TaskProfileScope scope(profile,TaskProfile::ExportHistograms);
+    exportHistograms();
+    }
   if (histosPlot)    plotHistograms();
   if (histosPrint)   printHistograms();
   if (hasSubTasks()) finalizeSubTasks();
@@ -339,6 +347,11 @@ void Task::resetHistograms()
     ;
 }
 
+void Task::flushHistograms()
+{
+  histogramManager.flush();
+}
+
 void Task::clearHistograms()
 {
   if (reportStart(__FUNCTION__))
@@ -424,17 +437,43 @@ void Task::partial(const String & outputPathBase)
     cout << endl;
     cout << "Partial save of histograms." << endl;
     }
+  flushHistograms();
   // If scaling histograms, one must call resetHistograms to set all histo to zero content.
   // Otherwise, the content will be non sensical.
   // However, it is OK to call resetHistograms without calling scaleHistograms
-  if (histosScale && histosReset)   scaleHistograms();
-  if (histosExport)  exportHistograms(outputPathBase);
+  if (histosScale && histosReset)
+    {
+    TaskProfileScope scope(profile,TaskProfile::ScaleHistograms);
+    scaleHistograms();
+    }
+  if (histosExport)
+    {
+    TaskProfileScope scope(profile,TaskProfile::ExportHistograms);
+    exportHistograms(outputPathBase);
+    }
   if (histosReset)   resetHistograms();
   if (hasSubTasks()) for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->partial(outputPathBase);
   if (reportEnd(__FUNCTION__))
     ;
 }
 
+void Task::mergeHistograms(Task & source)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  if (source.getNSubTasks()!=getNSubTasks())
+    throw TaskException("Source task has a different number of subtasks.","Task::mergeHistograms(Task & source)");
+  // the source is reset after each merge: its execution count is the increment since the last merge.
+  taskExecuted      += source.taskExecuted;
+  taskExecutedTotal += source.taskExecuted;
+  histogramManager.add(source.histogramManager);
+  profile.add(source.profile);
+  source.profile.reset();
+  for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->mergeHistograms(*source.subTasks[iTask]);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
 
 void Task::closeHistogramFiles()
 {
@@ -484,7 +523,7 @@ long Task::loadNEexecutedTask(TFile & inputFile)
   return taskExecuted;
 }
 
-void Task::writeParameter(TFile & outputFile, const String & parameterName, long value)
+void Task::writeParameter(TDirectory & outputFile, const String & parameterName, long value)
 {
   if (reportStart(__FUNCTION__))
     ;
@@ -492,7 +531,7 @@ void Task::writeParameter(TFile & outputFile, const String & parameterName, long
   TParameter<Long64_t>(parameterName,value,'+').Write();
 }
 
-long Task::readParameter(TFile & inputFile, const String & parameterName)
+long Task::readParameter(TDirectory & inputFile, const String & parameterName)
 {
   if (reportStart(__FUNCTION__))
     ;
@@ -500,7 +539,7 @@ long Task::readParameter(TFile & inputFile, const String & parameterName)
   if (!par)
   {
     if (reportError(__FUNCTION__)) cout << "Parameter not found:" <<  parameterName << endl;
-    throw TaskException("Parameter not found","Task::readParameter(TFile & inputFile, const String & parameterName)");
+    throw TaskException("Parameter not found","Task::readParameter(TDirectory & inputFile, const String & parameterName)");
   }
   double value = par->GetVal();
   delete par;
@@ -687,13 +726,47 @@ void Task::copyFile(const String & inputPath,  const String & inputFileName, con
 
 
 
+void Task::saveCheckpoint(TDirectory & directory)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  writeParameter(directory,"taskExecuted",taskExecuted);
+  writeParameter(directory,"taskExecutedTotal",taskExecutedTotal);
+  histogramManager.saveContents(directory);
+  for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)
+    {
+    TDirectory * subTaskDirectory = directory.mkdir(Form("SubTask%02d",iTask));
+    if (!subTaskDirectory) throw TaskException("Unable to create subtask directory","Task::saveCheckpoint(TDirectory & directory)");
+    subTasks[iTask]->saveCheckpoint(*subTaskDirectory);
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void Task::loadCheckpoint(TDirectory & directory)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  taskExecuted      = readParameter(directory,"taskExecuted");
+  taskExecutedTotal = readParameter(directory,"taskExecutedTotal");
+  histogramManager.loadContents(directory);
+  for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)
+    {
+    TDirectory * subTaskDirectory = directory.GetDirectory(Form("SubTask%02d",iTask));
+    if (!subTaskDirectory) throw TaskException("Subtask directory not found in checkpoint","Task::loadCheckpoint(TDirectory & directory)");
+    subTasks[iTask]->loadCheckpoint(*subTaskDirectory);
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
 void Task::initializeSubTasks()
 {
   if (reportStart(__FUNCTION__))
     ;
   unsigned int nSubTasks = subTasks.size();
   if (reportDebug(__FUNCTION__))  cout << "SubTasks Count: " << nSubTasks  << endl;
-  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->initialize();
+  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->profiledInitialize();
   if (reportEnd(__FUNCTION__))
   { }
 }
@@ -701,7 +774,7 @@ void Task::initializeSubTasks()
 void Task::executeSubTasks()
 {
   unsigned int nSubTasks = subTasks.size();
-  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->execute();
+  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->profiledExecute();
 }
 
 void Task::finalizeSubTasks()
@@ -710,11 +783,117 @@ void Task::finalizeSubTasks()
     ;
   unsigned int nSubTasks = subTasks.size();
   if (reportDebug(__FUNCTION__))  cout << "SubTasks Count: " << nSubTasks  << endl;
-  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->finalize();
+  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->profiledFinalize();
   if (reportEnd(__FUNCTION__))
     ;
 }
 
+void Task::profiledInitialize()
+{
+  TaskProfileScope scope(profile,TaskProfile::Initialize);
+  initialize();
+}
+
+void Task::profiledExecute()
+{
+  TaskProfileScope scope(profile,TaskProfile::Execute);
+  execute();
+}
+
+void Task::profiledFinalize()
+{
+  TaskProfileScope scope(profile,TaskProfile::Finalize);
+  finalize();
+}
+
+void Task::profiledExecuteBatch(const vector<PipelineSlot*> & slots)
+{
+  TaskProfileScope scope(profile,TaskProfile::Execute,slots.size());
+  executeBatch(slots);
+}
+
+void Task::executeBatch(const vector<PipelineSlot*> & slots)
+{
+  for (unsigned int iSlot=0; iSlot<slots.size(); iSlot++)
+    {
+    setPipelineSlot(slots[iSlot]);
+    execute();
+    }
+}
+
+double Task::getProfileTotalTime() const
+{
+  double total = profile.getTotalTime();
+  if (total>0.0) return total;
+  // tasks that are not called by a parent (e.g., the top task) have no time of their own: use their subtasks.
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) total += subTasks[iTask]->getProfileTotalTime();
+  return total;
+}
+
+void Task::printProfile(ostream & output, int depth) const
+{
+  double total      = getProfileTotalTime();
+  double childTotal = 0.0;
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) childTotal += subTasks[iTask]->getProfileTotalTime();
+  double self       = (total>childTotal) ? total-childTotal : 0.0;
+  long   nEvents    = profile.getCalls(TaskProfile::Execute);
+  double execTime   = profile.getTime(TaskProfile::Execute);
+  if (depth==0)
+    {
+    output << endl;
+    output << left  << setw(50) << "Task"
+    << right << setw(12) << "total(s)"
+    << setw(12) << "self(s)"
+    << setw(12) << "export(s)"
+    << setw(12) << "scale(s)"
+    << setw(12) << "events"
+    << setw(12) << "us/event"
+    << setw(14) << "events/s"
+    << setw(14) << "particles" << endl;
+    }
+  std::string label(2*depth,' ');
+  label += getName().Data();
+  output << left << setw(50) << label << right << fixed << setprecision(3)
+  << setw(12) << total
+  << setw(12) << self
+  << setw(12) << profile.getTime(TaskProfile::ExportHistograms)
+  << setw(12) << profile.getTime(TaskProfile::ScaleHistograms)
+  << setw(12) << nEvents
+  << setw(12) << ((nEvents>0) ? 1.0E6*execTime/double(nEvents) : 0.0)
+  << setw(14) << ((execTime>0.0) ? double(nEvents)/execTime : 0.0)
+  << setw(14) << getNParticlesProcessed() << endl;
+  output << defaultfloat << setprecision(6);
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) subTasks[iTask]->printProfile(output,depth+1);
+}
+
+void Task::writeProfile(ostream & output, int depth) const
+{
+  std::string indent(2*depth,' ');
+  double total      = getProfileTotalTime();
+  double childTotal = 0.0;
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) childTotal += subTasks[iTask]->getProfileTotalTime();
+  output << indent << "{" << endl;
+  output << indent << "  \"name\": \"" << getName() << "\"," << endl;
+  output << indent << "  \"class\": \"" << IsA()->GetName() << "\"," << endl;
+  output << indent << "  \"total\": " << total << "," << endl;
+  output << indent << "  \"self\": " << ((total>childTotal) ? total-childTotal : 0.0) << "," << endl;
+  output << indent << "  \"particles\": " << getNParticlesProcessed() << "," << endl;
+  for (int iPhase=0; iPhase<TaskProfile::nPhases; iPhase++)
+    {
+    TaskProfile::Phase phase = TaskProfile::Phase(iPhase);
+    output << indent << "  \"" << TaskProfile::getPhaseName(phase) << "\": { \"calls\": " << profile.getCalls(phase) << ", \"time\": " << profile.getTime(phase) << " }," << endl;
+    }
+  output << indent << "  \"subTasks\": [";
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++)
+    {
+    output << ((iTask>0) ? "," : "") << endl;
+    subTasks[iTask]->writeProfile(output,depth+2);
+    }
+  output << ((subTasks.size()>0) ? "\n" + indent + "  " : "") << "]" << endl;
+  output << indent << "}";
+  if (depth==0) output << endl;
+}
+
 void Task::resetSubTasks()
 {
   if (reportStart(__FUNCTION__))
@@ -738,6 +917,23 @@ void Task::clearSubTasks()
 }
 
 
+ExecutionContext * Task::getExecutionContext() const
+{
+  const Task * task = this;
+  while (task)
+    {
+    if (task->executionContext) return task->executionContext;
+    task = task->parent;
+    }
+  return ExecutionContext::getDefaultContext();
+}
+
+void Task::setExecutionContext(ExecutionContext * context)
+{
+  executionContext = context;
+  for (unsigned int iTask=0; iTask<subTasks.size(); iTask++) subTasks[iTask]->setExecutionContext(context);
+}
+
 Task * Task::addSubTask(Task * task)
 {
   if (!task)  throw TaskException("Given task pointer is null.", "Task::addSubTask(Task * task)");
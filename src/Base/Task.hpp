@@ -25,6 +25,9 @@
 #include "StateManager.hpp"
 #include "NameManager.hpp"
 #include "Timer.hpp"
+#include "PipelineSlot.hpp"
+#include "ExecutionContext.hpp"
+#include "TaskProfile.hpp"
 
 using std::vector;
 using std::iostream;
@@ -37,15 +40,18 @@ using std::endl;
 //#define postTaskOk()          ( StateManager::getStateManager()->setState(StateManager::OK)     )
 //#define postTaskRunning()     ( StateManager::getStateManager()->setState(StateManager::OK)     )
 //#define postTaskCompleted()   ( StateManager::getStateManager()->setState(StateManager::COMPLETED)   )
-#define postTaskEof()         ( StateManager::getStateManager()->setState(StateManager::EOFILE)      )
-#define postTaskEod()         ( StateManager::getStateManager()->setState(StateManager::EODATA)     )
+//
+// End of file/data are posted on, and read from, the execution context of the task (i.e., of its stream) rather than a global state.
+//
+#define postTaskEof()         ( getExecutionContext()->setState(ExecutionContext::EOFILE)      )
+#define postTaskEod()         ( getExecutionContext()->setState(ExecutionContext::EODATA)     )
 //#define postTaskWarning()     ( StateManager::getStateManager()->setState(StateManager::WARNING)     )
 //#define postTaskError()       ( StateManager::getStateManager()->setState(StateManager::ERROR)       )
 //#define postTaskFatal()       ( StateManager::getStateManager()->setState(StateManager::FATAL)       )
 //
 //#define isTaskConfigured()    ( StateManager::getStateManager()->isConfigured()  )
 //#define isTaskInitialized()   ( StateManager::getStateManager()->Initialized()   )
-#define isTaskEod()           ( StateManager::getStateManager()->isEod()   )
+#define isTaskEod()           ( getExecutionContext()->isEod()   )
 
 
 
@@ -73,6 +79,16 @@ protected:
   //!
   Task * parent;
 
+  //!
+  //! Execution context (stream state) this task reports to. Null if the task inherits the context of its parent.
+  //!
+  ExecutionContext * executionContext; //!
+
+  //!
+  //! Calls and time spent in each phase of this task. Filled only when profiling is enabled.
+  //!
+  TaskProfile profile; //!
+
   bool   histosCreate;
   bool   histosCreateDerived;
   bool   histosReset;
@@ -160,6 +176,47 @@ public:
   //!
   void clearSubTasks();
 
+  //!
+  //! Call initialize(), execute(), or finalize() on this task, recording the time spent in its profile if profiling is enabled.
+  //!
+  void profiledInitialize();
+  void profiledExecute();
+  void profiledFinalize();
+
+  //!
+  //! Call executeBatch() on this task, recording one execute call per slot in its profile if profiling is enabled.
+  //!
+  void profiledExecuteBatch(const vector<PipelineSlot*> & slots);
+
+  TaskProfile & getProfile()
+  {
+  return profile;
+  }
+
+  //!
+  //! Total time spent by this task. For tasks that were not profiled directly (e.g., the top task), the total of its subtasks.
+  //!
+  double getProfileTotalTime() const;
+
+  //!
+  //! Number of particles processed by this task, reported by the profiler. The base class implementation returns 0.
+  //!
+  virtual long getNParticlesProcessed() const
+  {
+  return 0;
+  }
+
+  //!
+  //! Print the profile of this task and its subtasks as an indented table: total and self time, export and scaling time,
+  //! number of events executed, time per event, event rate, and number of particles processed.
+  //!
+  void printProfile(ostream & output, int depth=0) const;
+
+  //!
+  //! Write the profile of this task and its subtasks in JSON format.
+  //!
+  void writeProfile(ostream & output, int depth=0) const;
+
   virtual void setDefaultConfiguration();
   virtual void printConfiguration(ostream & output);
   virtual void configure();
@@ -278,6 +335,12 @@ public:
   //! Calls the reset method of all the histogram groups owned by this task.
   //!
   virtual void resetHistograms();
+
+  //!
+  //! Add the content of the accumulation buffers of the histogram groups owned by this task to their histograms. Called before
+  //! the histograms are scaled or exported.
+  //!
+  virtual void flushHistograms();
   //!
   //! Calls the clear method of all the histogram groups owned by this task. This effectively delete the histogram groups. Only call this method if you know
   //! what you are doing..
@@ -315,12 +378,98 @@ public:
 
   virtual void partial(const String & outputPathBase);
 
+  //!
+  //! Add the histograms and execution counters accumulated by the given source task to those of this task instance, then
+  //! proceed recursively with the subtasks. The source must be a replica of this task, i.e., a task of the same class with
+  //! the same configuration and the same subtask structure. Used by TaskIterator to sum the per-thread replicas into the master copy.
+  //!
+  virtual void mergeHistograms(Task & source);
+
+  //!
+  //! Save the state needed to resume the execution of this task instance, i.e., its execution counters and the content of its histograms,
+  //! in the given directory, then proceed recursively with the subtasks, each in its own sub directory. Derived classes holding additional
+  //! state (event counters, reader position, random generator) extend this method. Used by TaskIterator to checkpoint long runs.
+  //!
+  virtual void saveCheckpoint(TDirectory & directory);
+
+  //!
+  //! Restore the state saved by saveCheckpoint() from the given directory. Must be called after initialize(), once the histograms are created.
+  //!
+  virtual void loadCheckpoint(TDirectory & directory);
+
+  //!
+  //! Execute this task once for each of the given pipeline slots, i.e., on a block of buffered events. The base class implementation
+  //! calls setPipelineSlot() and execute() for each slot in turn. Derived classes may override this method to process the block as a whole.
+  //!
+  virtual void executeBatch(const vector<PipelineSlot*> & slots);
+
+  //!
+  //! Returns true if this task belongs to the producer stage of a pipelined TaskIterator, i.e., if it fills the event data
+  //! that the tasks that follow it consume. The base class implementation returns false.
+  //!
+  virtual bool isPipelineProducer() const
+  {
+  return false;
+  }
+
+  //!
+  //! Create a pipeline slot suitable to hold the data exchanged by the stages of a pipelined TaskIterator. The caller owns the slot.
+  //! The base class implementation returns a null pointer: the task does not support pipelined execution.
+  //!
+  virtual PipelineSlot * createPipelineSlot()
+  {
+  return nullptr;
+  }
+
+  //!
+  //! Attach the given slot to this task: the next call to execute() reads and writes the data held by the slot. A null pointer
+  //! restores the data the task was initialized with.
+  //!
+  virtual void setPipelineSlot(PipelineSlot * slot __attribute__((unused))) {}
+
+  //!
+  //! Bits used by getDataRead() and getDataWritten() to identify the shared data a task accesses while it executes.
+  //! Bit k (k<8) designates event stream k, and bit 8+k the EventProperties of event stream k.
+  //!
+  static const unsigned int StreamsData         = 0x000000FFu;
+  static const unsigned int PropertiesData      = 0x0000FF00u;
+  static const unsigned int RandomGeneratorData = 1u<<16;
+  static const unsigned int ParticleFactoryData = 1u<<17;
+  static const unsigned int AllData             = 0xFFFFFFFFu;
+
+  static inline unsigned int getStreamData(unsigned int streamIndex)
+  {
+  return 1u<<streamIndex;
+  }
+
+  static inline unsigned int getPropertiesData(unsigned int streamIndex)
+  {
+  return 1u<<(8+streamIndex);
+  }
+
+  //!
+  //! Returns the bit mask of the shared data read by execute(). The base class implementation returns AllData, i.e., a task
+  //! that does not declare its data accesses is assumed to depend on every task executed before it.
+  //!
+  virtual unsigned int getDataRead() const
+  {
+  return AllData;
+  }
+
+  //!
+  //! Returns the bit mask of the shared data written by execute(). The base class implementation returns AllData.
+  //!
+  virtual unsigned int getDataWritten() const
+  {
+  return AllData;
+  }
+
   virtual void closeHistogramFiles();
 
   //!
   //! Read the given named parameter from the given input file.
   //!
-  virtual long readParameter(TFile & inputFile, const String & parameterName);
+  virtual long readParameter(TDirectory & inputFile, const String & parameterName);
 
   //!
   //! Open the root file named "fileName" located on the path "inputPath", using options specified by "ioOption".
@@ -413,7 +562,7 @@ public:
   //!
   //! Save the given (long) value with the given name in the given output file.
   //!
-  void writeParameter(TFile & outputFile, const String & parameterName, long value);
+  void writeParameter(TDirectory & outputFile, const String & parameterName, long value);
  
   void setHistogramFileNames(const String inputName, const String outputName)
   {
@@ -476,6 +625,17 @@ public:
   parent = _parent;
   }
 
+  //!
+  //! Returns the execution context of this task: its own context if set, otherwise that of its closest ancestor, or the process
+  //! wide default context for tasks not driven by an iterator.
+  //!
+  ExecutionContext * getExecutionContext() const;
+
+  //!
+  //! Attach this task and all its subtasks to the given execution context.
+  //!
+  virtual void setExecutionContext(ExecutionContext * context);
+
 
   //!
   //! Returns the name of the parent task (if there is a parent task). If this task has no parent
@@ -9,7 +9,17 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+#include "TROOT.h"
+#include "TH1.h"
+#include "TRandom3.h"
+#include "TSystem.h"
 #include "TaskIterator.hpp"
+#include "BoundedQueue.hpp"
 //using CAP::Task;
 //using CAP::TaskIterator;
 //using CAP::Configuration;
@@ -18,6 +28,274 @@ using namespace CAP;
 
 ClassImp(TaskIterator);
 
+namespace CAP
+{
+
+//!
+//! Synchronization of the worker threads of a multi-threaded TaskIterator. Events are processed in rounds: the master
+//! thread releases a round by incrementing round, and each worker signals the completion of the round by incrementing nIdle.
+//!
+class TaskIteratorSync
+{
+public:
+  std::mutex              mutex;
+  std::condition_variable condition;
+  long                    round;
+  int                     nIdle;
+  bool                    stop;
+  vector<long>            nEventsThread;
+  vector<long>            nEventsDone;
+  vector<ExecutionContext*> contexts; // context of each thread; contexts[0] is that of the iterator
+  std::exception_ptr      exception;
+
+  ~TaskIteratorSync()
+  {
+  for (unsigned int iThread=1; iThread<contexts.size(); iThread++) delete contexts[iThread];
+  }
+};
+
+//!
+//! State shared by the producer and consumer stages of a pipelined TaskIterator. Free slots go from the consumer to the producer,
+//! filled slots from the producer to the consumer. A null slot marks the end of the production. A stage finding its queue empty
+//! sleeps on the condition variable until the other stage pushes a slot. The consumer pauses the producer, e.g., for a partial
+//! save, with pause() and lets it resume with resume().
+//!
+class TaskIteratorPipeline
+{
+public:
+  TaskIteratorPipeline(unsigned int depth)
+  :
+  slots(),
+  freeSlots(depth),
+  readySlots(depth+1),
+  mutex(),
+  condition(),
+  stop(false),
+  paused(false),
+  producerPaused(false),
+  producerDone(false),
+  exception()
+  {  }
+
+  //!
+  //! Push the given slot in the given queue and wake up the other stage.
+  //!
+  void push(BoundedQueue<PipelineSlot*> & queue, PipelineSlot * slot)
+  {
+  queue.push(slot);
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    }
+  condition.notify_all();
+  }
+
+  //!
+  //! Pop a filled slot. If wait is true, sleep until a slot is ready. Returns false if no slot was popped.
+  //!
+  bool popReady(PipelineSlot * & slot, bool wait)
+  {
+  if (readySlots.pop(slot)) return true;
+  if (!wait) return false;
+  std::unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [this]{ return !readySlots.isEmpty(); });
+  return readySlots.pop(slot);
+  }
+
+  //!
+  //! Pop a free slot, sleeping until one is available. Returns false if the pipeline is stopped. While the pipeline is paused,
+  //! the producer waits here, with no event in progress, until it is resumed.
+  //!
+  bool popFree(PipelineSlot * & slot)
+  {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+    {
+    condition.wait(lock, [this]{ return stop || paused || !freeSlots.isEmpty(); });
+    if (stop) return false;
+    if (!paused) break;
+    producerPaused = true;
+    condition.notify_all();
+    condition.wait(lock, [this]{ return stop || !paused; });
+    producerPaused = false;
+    }
+  return freeSlots.pop(slot);
+  }
+
+  //!
+  //! Pause the producer and wait until it is idle or done.
+  //!
+  void pause()
+  {
+  std::unique_lock<std::mutex> lock(mutex);
+  paused = true;
+  condition.notify_all();
+  condition.wait(lock, [this]{ return producerPaused || producerDone; });
+  }
+
+  void resume()
+  {
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    paused = false;
+    }
+  condition.notify_all();
+  }
+
+  //!
+  //! Mark the end of the production.
+  //!
+  void setProducerDone()
+  {
+  // the ready queue has room for all slots plus the end of production marker.
+  readySlots.push(nullptr);
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    producerDone = true;
+    }
+  condition.notify_all();
+  }
+
+  void setStop()
+  {
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+    }
+  condition.notify_all();
+  }
+
+  vector<PipelineSlot*>       slots;
+  BoundedQueue<PipelineSlot*> freeSlots;
+  BoundedQueue<PipelineSlot*> readySlots;
+  std::mutex                  mutex;
+  std::condition_variable     condition;
+  bool                        stop;
+  bool                        paused;
+  bool                        producerPaused;
+  bool                        producerDone;
+  std::exception_ptr          exception;
+};
+
+//!
+//! Pool of worker threads executing the independent subtasks of one level of the task graph of a TaskIterator on the same event.
+//! The calling thread takes part in the execution: the tasks of a level are handed out, one at a time, to whichever thread is
+//! free. execute() returns once all the tasks of the level are completed, and rethrows the first exception thrown by any of them.
+//!
+class TaskIteratorScheduler
+{
+public:
+  TaskIteratorScheduler(unsigned int nWorkers)
+  :
+  mutex(),
+  condition(),
+  completed(),
+  level(nullptr),
+  next(0),
+  round(0),
+  nDone(0),
+  stop(false),
+  exception(),
+  workers()
+  {
+  for (unsigned int iWorker=0; iWorker<nWorkers; iWorker++)
+    workers.push_back(std::thread(&TaskIteratorScheduler::work,this));
+  }
+
+  ~TaskIteratorScheduler()
+  {
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+    }
+  condition.notify_all();
+  for (unsigned int iWorker=0; iWorker<workers.size(); iWorker++) workers[iWorker].join();
+  }
+
+  void execute(const vector<Task*> & tasks)
+  {
+  if (workers.size()==0 || tasks.size()==1)
+    {
+    for (unsigned int iTask=0; iTask<tasks.size(); iTask++) tasks[iTask]->profiledExecute();
+    return;
+    }
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    level = &tasks;
+    next  = 0;
+    nDone = 0;
+    round++;
+    }
+  condition.notify_all();
+  run();
+  std::exception_ptr caught;
+    {
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [this]{ return nDone==workers.size(); });
+    caught    = exception;
+    exception = nullptr;
+    }
+  if (caught) std::rethrow_exception(caught);
+  }
+
+protected:
+
+  //!
+  //! Execute tasks of the current level until none is left.
+  //!
+  void run()
+  {
+  unsigned int nTasks = level->size();
+  for (unsigned int iTask=next++; iTask<nTasks; iTask=next++)
+    {
+    try
+      {
+      (*level)[iTask]->profiledExecute();
+      }
+    catch (...)
+      {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!exception) exception = std::current_exception();
+      }
+    }
+  }
+
+  //!
+  //! Work loop of the worker threads: wait for a level to be released by execute(), take part in its execution, and signal completion.
+  //!
+  void work()
+  {
+  long done = 0;
+  while (true)
+    {
+      {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this,done]{ return stop || round!=done; });
+      if (stop) return;
+      done = round;
+      }
+    run();
+      {
+      std::lock_guard<std::mutex> lock(mutex);
+      nDone++;
+      }
+    completed.notify_one();
+    }
+  }
+
+  std::mutex                mutex;
+  std::condition_variable   condition;
+  std::condition_variable   completed;
+  const vector<Task*> *     level;
+  std::atomic<unsigned int> next;
+  long                      round;
+  unsigned int              nDone;
+  bool                      stop;
+  std::exception_ptr        exception;
+  vector<std::thread>       workers;
+};
+
+}
+
 TaskIterator::TaskIterator(const String & _name,
                            const Configuration & _configuration)
 :
@@ -27,16 +305,33 @@ nEventsPerSubbunch(1),
 nSubbunchesPerBunch(1),
 nBunches(1),
 nEventsRequested(1),
+nThreads(1),
+pipelined(false),
+pipelineDepth(8),
+batchSize(1),
+concurrentTasks(1),
 nEventsReport(10),
+checkpoint(false),
+checkpointInterval(0),
+checkpointPath("DEFAULT"),
 bunchLabel("BUNCH"),
 subbunchLabel(""),
 iEvent(0),
 iSubBunch(0),
-iBunch(0)
+iBunch(0),
+completed(false),
+threadSubTasks(),
+taskLevels(),
+iteratorContext(new ExecutionContext())
 {
   appendClassName("TaskIterator");
 }
 
+TaskIterator::~TaskIterator()
+{
+  delete iteratorContext;
+}
+
 void TaskIterator::setDefaultConfiguration()
 {
   Task::setDefaultConfiguration();
@@ -46,7 +341,15 @@ void TaskIterator::setDefaultConfiguration()
   addParameter("nSubbunchesPerBunch",     nSubbunchesPerBunch);
   addParameter("nBunches",                nBunches);
   addParameter("nEventsRequested",        nEventsRequested);
+  addParameter("nThreads",                nThreads);
+  addParameter("Pipelined",               pipelined);
+  addParameter("PipelineDepth",           pipelineDepth);
+  addParameter("BatchSize",               batchSize);
+  addParameter("ConcurrentTasks",         concurrentTasks);
   addParameter("nEventsReport",           nEventsReport);
+  addParameter("Checkpoint",              checkpoint);
+  addParameter("CheckpointInterval",      checkpointInterval);
+  addParameter("CheckpointPath",          checkpointPath);
   addParameter("BunchLabel",              bunchLabel);
   addParameter("SubbunchLabel",           subbunchLabel);
 }
@@ -59,7 +362,15 @@ void TaskIterator::configure()
   nSubbunchesPerBunch    = getValueInt(   "nSubbunchesPerBunch");
   nBunches               = getValueInt(   "nBunches");
   nEventsRequested       = getValueLong(  "nEventsRequested");
+  nThreads               = getValueInt(   "nThreads");
+  pipelined              = getValueBool(  "Pipelined");
+  pipelineDepth          = getValueInt(   "PipelineDepth");
+  batchSize              = getValueInt(   "BatchSize");
+  concurrentTasks        = getValueInt(   "ConcurrentTasks");
   nEventsReport          = getValueLong(  "nEventsReport");
+  checkpoint             = getValueBool(  "Checkpoint");
+  checkpointInterval     = getValueLong(  "CheckpointInterval");
+  checkpointPath         = getValueString("CheckpointPath");
   bunchLabel             = getValueString("BunchLabel");
   subbunchLabel          = getValueString("SubbunchLabel");
 
@@ -68,6 +379,21 @@ void TaskIterator::configure()
     // nEventsPerSubbunch is past to RunAna.C via the launching script.
     nEventsRequested = nEventsPerSubbunch;
     }
+  if (nThreads<1) nThreads = 1;
+  if (pipelineDepth<1) pipelineDepth = 1;
+  if (batchSize<1) batchSize = 1;
+  if (batchSize>1 && !pipelined)
+    throw TaskException("BatchSize>1 requires Pipelined=true.","TaskIterator::configure()");
+  // the producer must be able to fill a whole block.
+  if (pipelineDepth<batchSize) pipelineDepth = batchSize;
+  if (pipelined && nThreads>1)
+    throw TaskException("Pipelined execution cannot be combined with nThreads>1.","TaskIterator::configure()");
+  if (checkpoint && (pipelined || nThreads>1))
+    throw TaskException("Checkpoints are only supported in serial mode.","TaskIterator::configure()");
+  if (checkpointInterval<0) checkpointInterval = 0;
+  if (concurrentTasks<1) concurrentTasks = 1;
+  if (concurrentTasks>1 && (pipelined || nThreads>1))
+    throw TaskException("ConcurrentTasks>1 is only supported in serial mode.","TaskIterator::configure()");
 
   if (reportInfo(__FUNCTION__))
     {
@@ -77,7 +403,15 @@ void TaskIterator::configure()
     printItem("nSubbunchesPerBunch" ,nSubbunchesPerBunch);
     printItem("nBunches" ,nBunches);
     printItem("nEventsRequested" ,nEventsRequested);
+    printItem("nThreads" ,nThreads);
+    printItem("Pipelined" ,pipelined);
+    printItem("PipelineDepth" ,pipelineDepth);
+    printItem("BatchSize" ,batchSize);
+    printItem("ConcurrentTasks" ,concurrentTasks);
     printItem("nEventsReport" ,nEventsReport);
+    printItem("Checkpoint" ,checkpoint);
+    printItem("CheckpointInterval" ,checkpointInterval);
+    printItem("CheckpointPath" ,checkpointPath);
     printItem("bunchLabel" ,bunchLabel);
     printItem("subbunchLabel" ,subbunchLabel);
     }
@@ -144,6 +478,7 @@ void TaskIterator::execute()
       printItem("Subtask name",subTasks[k]->getName());
     printItem("isGrid",isGrid);
     printItem("nEventsRequested",nEventsRequested);
+    printItem("nThreads",nThreads);
     printItem("nEventsReport" ,nEventsReport);
     printItem("nEventsPerSubbunch",nEventsPerSubbunch);
     printItem("nSubbunchesPerBunch",nSubbunchesPerBunch);
@@ -155,13 +490,54 @@ void TaskIterator::execute()
   iEvent           = 0;
   iSubBunch        = 0;
   iBunch           = 0;
+  completed        = false;
+  // the subtasks of this iterator report to its own context, which is cancelled along with that of the enclosing task, if any.
+  iteratorContext->reset();
+  iteratorContext->setParent(hasParent() ? getParent()->getExecutionContext() : nullptr);
+  setExecutionContext(iteratorContext);
+  if (nThreads>1)
+    {
+    executeThreaded();
+    timer.stop();
+    finalize();
+    if (checkpoint && completed) gSystem->Unlink(getCheckpointFileName());
+    clear();
+    return;
+    }
+  if (pipelined)
+    {
+    executePipelined();
+    timer.stop();
+    finalize();
+    if (checkpoint && completed) gSystem->Unlink(getCheckpointFileName());
+    clear();
+    return;
+    }
+  // with ConcurrentTasks>1, the subtasks are executed level by level, the tasks of a level running concurrently on the same event.
+  taskLevels.clear();
+  if (concurrentTasks>1)
+    {
+    buildTaskLevels();
+    if (taskLevels.size()==getNSubTasks()) taskLevels.clear(); // no two tasks are independent
+    else ROOT::EnableThreadSafety();
+    }
+  TaskIteratorScheduler scheduler(taskLevels.size()>0 ? concurrentTasks-1 : 0);
   bool working     = true;
+  if (checkpoint && resumeFromCheckpoint() && iEvent>=nEventsRequested)
+    {
+    working   = false;
+    completed = true;
+    }
   while (working)
     {
-    for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->execute();
+    if (taskLevels.size()>0)
+      for (unsigned int iLevel=0; iLevel<taskLevels.size(); iLevel++) scheduler.execute(taskLevels[iLevel]);
+    else
+      for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->profiledExecute();
     iEvent++;
+    bool checkpointDue = checkpoint && checkpointInterval>0 && iEvent%checkpointInterval==0;
     if (iEvent%nEventsReport == 0) printItem("iEvent",iEvent);
-    if (isTaskEod())
+    if (iteratorContext->isDone())
       {
       working = false; break;
       }
@@ -174,6 +550,7 @@ void TaskIterator::execute()
         printItem("nEventsRequested",nEventsRequested);
         cout << endl;
         }
+      completed = true;
       working = false; break;
       }
 
@@ -191,16 +568,142 @@ void TaskIterator::execute()
           // bunch is completed
           iSubBunch=0;
           iBunch++;
-          if (iBunch==nBunches) working = false;
+          if (iBunch==nBunches)
+            {
+            completed = true;
+            working   = false;
+            }
           }
+        checkpointDue = checkpoint;
         }
       }
+    if (checkpointDue && working) writeCheckpoint();
     }
   timer.stop();
   finalize();
+  // a completed run must not be resumed by a restarted job. A cancelled or interrupted run keeps its last checkpoint.
+  if (checkpoint && completed) gSystem->Unlink(getCheckpointFileName());
   clear(); // should delete everything..
 }
 
+void TaskIterator::buildTaskLevels()
+{
+  unsigned int nTasks = getNSubTasks();
+  vector<unsigned int> taskLevel(nTasks,0);
+  unsigned int nLevels = 0;
+  for (unsigned int iTask=0; iTask<nTasks; iTask++)
+    {
+    unsigned int read    = subTasks[iTask]->getDataRead();
+    unsigned int written = subTasks[iTask]->getDataWritten();
+    // a task follows every earlier task writing data it accesses, or reading data it writes.
+    for (unsigned int jTask=0; jTask<iTask; jTask++)
+      {
+      unsigned int jRead    = subTasks[jTask]->getDataRead();
+      unsigned int jWritten = subTasks[jTask]->getDataWritten();
+      if ((jWritten & (read|written)) || (jRead & written))
+        {
+        if (taskLevel[jTask]+1>taskLevel[iTask]) taskLevel[iTask] = taskLevel[jTask]+1;
+        }
+      }
+    if (taskLevel[iTask]+1>nLevels) nLevels = taskLevel[iTask]+1;
+    }
+  taskLevels.assign(nLevels,vector<Task*>());
+  for (unsigned int iTask=0; iTask<nTasks; iTask++) taskLevels[taskLevel[iTask]].push_back(subTasks[iTask]);
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("nLevels",nLevels);
+    for (unsigned int iLevel=0; iLevel<nLevels; iLevel++)
+      for (unsigned int iTask=0; iTask<taskLevels[iLevel].size(); iTask++)
+        printItem(Form("Level %d",iLevel),taskLevels[iLevel][iTask]->getName());
+    }
+}
+
+void TaskIterator::saveCheckpoint(TDirectory & directory)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  writeParameter(directory,"iEvent",   iEvent);
+  writeParameter(directory,"iBunch",   iBunch);
+  writeParameter(directory,"iSubBunch",iSubBunch);
+  directory.cd();
+  if (gRandom) gRandom->Write("gRandom");
+  Task::saveCheckpoint(directory);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void TaskIterator::loadCheckpoint(TDirectory & directory)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  iEvent    = readParameter(directory,"iEvent");
+  iBunch    = readParameter(directory,"iBunch");
+  iSubBunch = readParameter(directory,"iSubBunch");
+  TRandom3 * savedRandom   = dynamic_cast<TRandom3*>(directory.Get("gRandom"));
+  TRandom3 * currentRandom = dynamic_cast<TRandom3*>(gRandom);
+  if (savedRandom && currentRandom)
+    *currentRandom = *savedRandom;
+  else if (reportWarning(__FUNCTION__))
+    cout << "State of gRandom not restored: only TRandom3 generators are supported." << endl;
+  delete savedRandom;
+  Task::loadCheckpoint(directory);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+String TaskIterator::getCheckpointFileName() const
+{
+  String fileName = checkpointPath.EqualTo("DEFAULT") ? histosExportPath : checkpointPath;
+  if (fileName.Length()>0 && !fileName.EndsWith("/")) fileName += "/";
+  fileName += getName();
+  fileName += "Checkpoint.root";
+  return fileName;
+}
+
+void TaskIterator::writeCheckpoint()
+{
+  String fileName = getCheckpointFileName();
+  String tempName = fileName + ".tmp";
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("iEvent",iEvent);
+    printItem("Checkpoint file",fileName);
+    }
+  gSystem->mkdir(gSystem->DirName(fileName),1);
+  TFile * file = TFile::Open(tempName,"RECREATE");
+  if (!file || file->IsZombie())
+    throw FileException(tempName,"Unable to create checkpoint file","TaskIterator::writeCheckpoint()");
+  saveCheckpoint(*file);
+  file->Close();
+  delete file;
+  if (gSystem->Rename(tempName,fileName)!=0)
+    throw FileException(fileName,"Unable to replace checkpoint file","TaskIterator::writeCheckpoint()");
+}
+
+bool TaskIterator::resumeFromCheckpoint()
+{
+  String fileName = getCheckpointFileName();
+  // AccessPathName returns true if the file does NOT exist.
+  if (gSystem->AccessPathName(fileName)) return false;
+  TFile * file = TFile::Open(fileName,"READ");
+  if (!file || file->IsZombie())
+    throw FileException(fileName,"Unable to open checkpoint file","TaskIterator::resumeFromCheckpoint()");
+  loadCheckpoint(*file);
+  file->Close();
+  delete file;
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("Resumed from checkpoint",fileName);
+    printItem("iEvent",iEvent);
+    printItem("iBunch",iBunch);
+    printItem("iSubBunch",iSubBunch);
+    }
+  return true;
+}
+
 
 void TaskIterator::finalize()
 {
@@ -211,7 +714,7 @@ void TaskIterator::finalize()
     cout << "---------------------------------------------------------------------------------------- " <<   endl;
     cout << "---------------------------------------------------------------------------------------- " <<   endl;
     printItem("Task named" ,getName());
-    printItem("Completed with status" ,StateManager::getStateManager()->getStateName());
+    printItem("Completed with status" ,iteratorContext->getStateName());
     printItem("isGrid" ,isGrid);
     printItem("nEventsPerSubbunch" ,nEventsPerSubbunch);
     printItem("nSubbunchesPerBunch" ,nSubbunchesPerBunch);
@@ -229,3 +732,365 @@ void TaskIterator::finalize()
     }
 }
 
+
+Task * TaskIterator::addThreadSubTask(unsigned int iThread, Task * task)
+{
+  if (iThread==0) return addSubTask(task);
+  if (!task)  throw TaskException("Given task pointer is null.", "TaskIterator::addThreadSubTask(unsigned int iThread, Task * task)");
+  if (threadSubTasks.size()<iThread) threadSubTasks.resize(iThread);
+  threadSubTasks[iThread-1].push_back(task);
+  task->setParent(this);
+  return task;
+}
+
+unsigned int TaskIterator::getNThreadSubTasks(unsigned int iThread) const
+{
+  if (iThread==0) return getNSubTasks();
+  if (iThread>threadSubTasks.size()) return 0;
+  return threadSubTasks[iThread-1].size();
+}
+
+Task * TaskIterator::getThreadSubTaskAt(unsigned int iThread, unsigned int index)
+{
+  if (iThread==0) return getSubTaskAt(index);
+  return threadSubTasks[iThread-1][index];
+}
+
+void TaskIterator::executeThreaded()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  for (int iThread=1; iThread<nThreads; iThread++)
+    {
+    if (getNThreadSubTasks(iThread)!=getNSubTasks())
+      {
+      String message = "Replica set of thread ";
+      message += iThread;
+      message += " does not match the subtasks of the iterator.";
+      throw TaskException(message,"TaskIterator::executeThreaded()");
+      }
+    }
+  // histograms of the replicas must not be attached to the (shared) current directory. The previous setting is restored on return.
+  ROOT::EnableThreadSafety();
+  bool addDirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+
+  TaskIteratorSync sync;
+  sync.round  = 0;
+  sync.nIdle  = 0;
+  sync.stop   = false;
+  sync.nEventsThread.assign(nThreads,0);
+  sync.nEventsDone.assign(nThreads,0);
+  sync.contexts.push_back(iteratorContext);
+  for (int iThread=1; iThread<nThreads; iThread++)
+    {
+    ExecutionContext * context = new ExecutionContext(iteratorContext);
+    sync.contexts.push_back(context);
+    for (unsigned int iTask=0; iTask<getNThreadSubTasks(iThread); iTask++) getThreadSubTaskAt(iThread,iTask)->setExecutionContext(context);
+    }
+
+  vector<std::thread> workers;
+  for (int iThread=1; iThread<nThreads; iThread++)
+    workers.push_back(std::thread(&TaskIterator::executeThread,this,iThread,std::ref(sync)));
+
+  bool partialSaves    = histosExportPartial && !isGrid;
+  long nEventsPerRound = partialSaves ? nBunches*nSubbunchesPerBunch*nEventsPerSubbunch : nEventsRequested;
+  bool working         = true;
+  while (working)
+    {
+    long nEventsRound = nEventsRequested - iEvent;
+    if (nEventsRound>nEventsPerRound) nEventsRound = nEventsPerRound;
+    // events are shared among the streams that have not reached their end of data.
+    vector<int> activeThreads;
+    for (int iThread=0; iThread<nThreads; iThread++)
+      if (!sync.contexts[iThread]->isEod()) activeThreads.push_back(iThread);
+    if (activeThreads.size()==0)
+      {
+      working = false;
+      break;
+      }
+    int nActive = activeThreads.size();
+    {
+    std::lock_guard<std::mutex> lock(sync.mutex);
+    sync.nEventsThread.assign(nThreads,0);
+    sync.nEventsDone.assign(nThreads,0);
+    for (int iActive=0; iActive<nActive; iActive++)
+      {
+      long nEventsThread = nEventsRound/nActive;
+      if (iActive < nEventsRound%nActive) nEventsThread++;
+      sync.nEventsThread[activeThreads[iActive]] = nEventsThread;
+      }
+    sync.nIdle = 0;
+    sync.round++;
+    }
+    sync.condition.notify_all();
+
+    long nDone = 0;
+    for (long iEventThread=0; iEventThread<sync.nEventsThread[0]; iEventThread++)
+      {
+      for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->profiledExecute();
+      nDone++;
+      if (iteratorContext->isDone()) break;
+      }
+    {
+    std::unique_lock<std::mutex> lock(sync.mutex);
+    sync.condition.wait(lock, [&sync,this]{ return sync.nIdle==nThreads-1 || sync.exception; });
+    }
+    if (sync.exception)
+      {
+      working = false;
+      break;
+      }
+    for (int iThread=1; iThread<nThreads; iThread++) nDone += sync.nEventsDone[iThread];
+    mergeThreadSubTasks();
+    // as in the serial loop, report once every nEventsReport events.
+    if ((iEvent+nDone)/nEventsReport != iEvent/nEventsReport) printItem("iEvent",iEvent+nDone);
+    iEvent += nDone;
+    if (iteratorContext->isCancelled() || nDone==0)
+      {
+      working = false; break;
+      }
+    if (iEvent>=nEventsRequested)
+      {
+      if (reportInfo(__FUNCTION__))
+        {
+        cout << endl;
+        printItem("iEvent",iEvent);
+        printItem("nEventsRequested",nEventsRequested);
+        cout << endl;
+        }
+      completed = true;
+      working = false; break;
+      }
+    if (partialSaves)
+      {
+      partial(histosExportPath);
+      iSubBunch++;
+      if (iSubBunch==nSubbunchesPerBunch)
+        {
+        iSubBunch=0;
+        iBunch++;
+        if (iBunch==nBunches)
+          {
+          completed = true;
+          working   = false;
+          }
+        }
+      }
+    }
+
+  {
+  std::lock_guard<std::mutex> lock(sync.mutex);
+  sync.stop = true;
+  }
+  sync.condition.notify_all();
+  for (unsigned int iWorker=0; iWorker<workers.size(); iWorker++) workers[iWorker].join();
+  TH1::AddDirectory(addDirectory);
+  if (sync.exception) std::rethrow_exception(sync.exception);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void TaskIterator::executeThread(unsigned int iThread, TaskIteratorSync & sync)
+{
+  vector<Task*> & tasks = threadSubTasks[iThread-1];
+  unsigned int nTasks = tasks.size();
+  ExecutionContext * context = sync.contexts[iThread];
+  long round = 0;
+  try
+  {
+  // replicas are initialized in their own thread so they pick up the thread's event streams and particle factory.
+  // Initialization is serialized: it involves file access and printouts.
+  {
+  std::lock_guard<std::mutex> lock(sync.mutex);
+  for (unsigned int iTask=0; iTask<nTasks; iTask++) tasks[iTask]->profiledInitialize();
+  }
+  while (true)
+    {
+    long nEvents;
+    {
+    std::unique_lock<std::mutex> lock(sync.mutex);
+    sync.condition.wait(lock, [&sync,round]{ return sync.stop || sync.round>round; });
+    if (sync.stop) break;
+    round   = sync.round;
+    nEvents = sync.nEventsThread[iThread];
+    }
+    long nDone = 0;
+    for (long iEventThread=0; iEventThread<nEvents; iEventThread++)
+      {
+      for (unsigned int iTask=0; iTask<nTasks; iTask++) tasks[iTask]->profiledExecute();
+      nDone++;
+      if (context->isDone()) break;
+      }
+    {
+    std::lock_guard<std::mutex> lock(sync.mutex);
+    sync.nEventsDone[iThread] = nDone;
+    sync.nIdle++;
+    }
+    sync.condition.notify_all();
+    }
+  }
+  catch (...)
+  {
+  context->setState(ExecutionContext::ERROR);
+  iteratorContext->cancel();
+  std::lock_guard<std::mutex> lock(sync.mutex);
+  if (!sync.exception) sync.exception = std::current_exception();
+  }
+  sync.condition.notify_all();
+}
+
+void TaskIterator::mergeThreadSubTasks()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  for (unsigned int iReplica=0; iReplica<threadSubTasks.size(); iReplica++)
+    {
+    vector<Task*> & tasks = threadSubTasks[iReplica];
+    for (unsigned int iTask=0; iTask<tasks.size(); iTask++)
+      {
+      subTasks[iTask]->mergeHistograms(*tasks[iTask]);
+      tasks[iTask]->reset();
+      }
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void TaskIterator::executePipelined()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  unsigned int nProducers = 0;
+  while (nProducers<getNSubTasks() && subTasks[nProducers]->isPipelineProducer()) nProducers++;
+  if (nProducers==0 || nProducers==getNSubTasks())
+    throw TaskException("Pipelined execution requires producer subtasks followed by consumer subtasks.","TaskIterator::executePipelined()");
+
+  TaskIteratorPipeline pipeline(pipelineDepth);
+  for (int iSlot=0; iSlot<pipelineDepth; iSlot++)
+    {
+    PipelineSlot * slot = subTasks[0]->createPipelineSlot();
+    if (!slot) throw TaskException("Producer task does not support pipelined execution.","TaskIterator::executePipelined()");
+    pipeline.slots.push_back(slot);
+    pipeline.freeSlots.push(slot);
+    }
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("nProducers",int(nProducers));
+    printItem("nConsumers",int(getNSubTasks()-nProducers));
+    printItem("PipelineDepth",pipelineDepth);
+    printItem("BatchSize",batchSize);
+    }
+
+  std::thread producer(&TaskIterator::producePipeline,this,nProducers,std::ref(pipeline));
+  bool working = true;
+  bool endOfProduction = false;
+  long partialPeriod = nBunches*nSubbunchesPerBunch*nEventsPerSubbunch;
+  vector<PipelineSlot*> batch;
+  try
+  {
+  while (working && !endOfProduction)
+    {
+    // blocks end at the last event requested and at partial saves.
+    long nBatch = batchSize;
+    if (nEventsRequested-iEvent<nBatch) nBatch = nEventsRequested-iEvent;
+    if (histosExportPartial && !isGrid && partialPeriod-iEvent%partialPeriod<nBatch) nBatch = partialPeriod-iEvent%partialPeriod;
+    if (nBatch<1) nBatch = 1;
+    batch.clear();
+    while (long(batch.size())<nBatch)
+      {
+      PipelineSlot * slot;
+      // do not wait for a full block: process the events ready.
+      if (!pipeline.popReady(slot,batch.empty())) break;
+      if (!slot)
+        {
+        endOfProduction = true;
+        break;
+        }
+      batch.push_back(slot);
+      }
+    if (batch.empty()) break;
+    for (unsigned int iTask=nProducers; iTask<getNSubTasks(); iTask++) subTasks[iTask]->profiledExecuteBatch(batch);
+    for (unsigned int iSlot=0; iSlot<batch.size(); iSlot++)
+      {
+      pipeline.push(pipeline.freeSlots,batch[iSlot]);
+      iEvent++;
+      if (iEvent%nEventsReport == 0) printItem("iEvent",iEvent);
+      }
+    if (iEvent>=nEventsRequested)
+      {
+      if (reportInfo(__FUNCTION__))
+        {
+        cout << endl;
+        printItem("iEvent",iEvent);
+        printItem("nEventsRequested",nEventsRequested);
+        cout << endl;
+        }
+      completed = true;
+      working = false; break;
+      }
+    if (histosExportPartial  && !isGrid)
+      {
+      if (iEvent%partialPeriod==0)
+        {
+        // the producer subtasks are saved too: they must not be running meanwhile.
+        pipeline.pause();
+        partial(histosExportPath);
+        pipeline.resume();
+        iSubBunch++;
+        if (iSubBunch==nSubbunchesPerBunch)
+          {
+          iSubBunch=0;
+          iBunch++;
+          if (iBunch==nBunches)
+            {
+            completed = true;
+            working   = false;
+            }
+          }
+        }
+      }
+    }
+  }
+  catch (...)
+  {
+  pipeline.setStop();
+  producer.join();
+  for (unsigned int iSlot=0; iSlot<pipeline.slots.size(); iSlot++) delete pipeline.slots[iSlot];
+  throw;
+  }
+  pipeline.setStop();
+  producer.join();
+
+  // detach the slots before deleting them.
+  for (unsigned int iTask=0; iTask<getNSubTasks(); iTask++) subTasks[iTask]->setPipelineSlot(nullptr);
+  for (unsigned int iSlot=0; iSlot<pipeline.slots.size(); iSlot++) delete pipeline.slots[iSlot];
+  if (pipeline.exception) std::rethrow_exception(pipeline.exception);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void TaskIterator::producePipeline(unsigned int nProducers, TaskIteratorPipeline & pipeline)
+{
+  try
+  {
+  for (long iProduced=0; iProduced<nEventsRequested; iProduced++)
+    {
+    PipelineSlot * slot;
+    if (!pipeline.popFree(slot)) break;
+    for (unsigned int iTask=0; iTask<nProducers; iTask++)
+      {
+      subTasks[iTask]->setPipelineSlot(slot);
+      subTasks[iTask]->profiledExecute();
+      }
+    pipeline.push(pipeline.readySlots,slot);
+    if (iteratorContext->isDone()) break;
+    }
+  }
+  catch (...)
+  {
+  pipeline.exception = std::current_exception();
+  }
+  pipeline.setProducerDone();
+}
@@ -15,6 +15,9 @@
 
 namespace CAP {
 
+class TaskIteratorSync;
+class TaskIteratorPipeline;
+
 //!
 //! This class implements a task iterator task, i.e., a task that repeated calls other tasks (subtasks) to carry out the same operation(s) on a sequence of events (event stream).
 //!  Use the 'run' method to execute the job on all selected events. Internally, 'run' calls the 'execute' method repeatedly on each event in the event stream.
@@ -22,6 +25,33 @@ namespace CAP {
 //!
 //!  Optionally, the iterator may call a subsampleAnalysis method to carry out a sub-sample analysis of all the sub tasks operated by this iterator.
 //!
+//!  With nThreads>1, the events are processed by nThreads threads. Thread 0 runs the subtasks of this iterator (the master copy) while
+//!  thread k>0 runs its own replica of the subtasks, added with addThreadSubTask(k,task). Each replica owns its histograms, event streams,
+//!  and particle factory. The events requested are split evenly between the threads and the replica histograms are summed into the master
+//!  copy before each partial save and before finalize(). Replicas of generators must be given distinct seeds. Tasks drawing from
+//!  the global gRandom are not thread safe and must not be replicated.
+//!
+//!  With Pipelined=true, the leading subtasks that produce events (generators, readers) run in a separate thread and fill the events of
+//!  PipelineDepth recycled slots, while the remaining subtasks (analyzers) consume the filled slots in the calling thread. Slots are
+//!  passed between the two stages through lock-free queues so generation and analysis overlap; a stage with no slot to work on
+//!  sleeps until the other stage passes one. The producer stage is paused during partial saves. With BatchSize>1, the consumer stage takes up
+//!  to BatchSize filled slots at a time and passes them to the consumer subtasks as a block (see Task::executeBatch()). Blocks never
+//!  straddle a partial save.
+//!
+//!  Each iterator owns an execution context attached to its subtasks on execute(). A reader posting end of data thus stops its own
+//!  iterator only, and several iterators may run concurrently in one process. In threaded mode, each thread runs on its own
+//!  context (stream): a thread reaching end of data stops while the others carry on. Call cancel() to stop an iterator from another thread.
+//!
+//!  With Checkpoint=true, the iterator saves its position (event, bunch, and sub-bunch indices), the state of gRandom, and the state of
+//!  its subtasks (histograms, counters, reader entry, generator seeds) to file <name>Checkpoint.root in CheckpointPath after each partial
+//!  save and every CheckpointInterval events. If that file exists when the iterator starts, the run resumes from it. The file is removed
+//!  once the run completes. Checkpoints are only supported in serial mode (nThreads=1 and Pipelined=false).
+//!
+//!  With ConcurrentTasks>1 (serial mode only), the subtasks are sorted into levels according to the event streams and properties they
+//!  read and write (see Task::getDataRead() and Task::getDataWritten()). The subtasks of a level, e.g., several analyzers of the same
+//!  stream, execute concurrently on ConcurrentTasks threads, while producers (e.g., MeasurementPerformanceSimulator) complete before the
+//!  tasks consuming their output start. Subtasks that do not declare their data accesses are executed alone, in order.
+//!
 class TaskIterator : public Task
 {
 public:
@@ -38,7 +68,7 @@ public:
   //!
   //! DTOR
   //!
-  virtual ~TaskIterator() {}
+  virtual ~TaskIterator();
   
   //!
   //! Sets the default  values of the configuration parameters used by this task
@@ -61,19 +91,140 @@ public:
   //!
   virtual void finalize();
 
+  //!
+  //! Add the given task to the replica set of thread iThread. Replicas must be added in the same order as the subtasks of this iterator.
+  //! For iThread==0, the task is added as a regular subtask.
+  //!
+  Task * addThreadSubTask(unsigned int iThread, Task * task);
+
+  unsigned int getNThreadSubTasks(unsigned int iThread) const;
+
+  Task * getThreadSubTaskAt(unsigned int iThread, unsigned int index);
+
+  int getNThreads() const
+  {
+  return nThreads;
+  }
+
+  long getNEventsRequested() const
+  {
+  return nEventsRequested;
+  }
+
+  //!
+  //! Override the number of events requested. Call after configure().
+  //!
+  void setNEventsRequested(long _nEventsRequested)
+  {
+  nEventsRequested = _nEventsRequested;
+  }
+
+  //!
+  //! Run as a grid (or worker process) job: no partial saves, histograms are exported once at the end. Call after configure().
+  //!
+  void setGrid(bool _isGrid)
+  {
+  isGrid = _isGrid;
+  }
+
+  //!
+  //! Get the execution context of the stream(s) run by this iterator.
+  //!
+  ExecutionContext * getIteratorContext() const
+  {
+  return iteratorContext;
+  }
+
+  //!
+  //! Request this iterator (and all its streams) to stop after the events in progress. May be called from another thread.
+  //!
+  void cancel()
+  {
+  iteratorContext->cancel();
+  }
+
+  //!
+  //! Save the position of this iterator and the state of gRandom, then save the state of the subtasks.
+  //!
+  virtual void saveCheckpoint(TDirectory & directory);
+
+  //!
+  //! Restore the position of this iterator, the state of gRandom, and the state of the subtasks.
+  //!
+  virtual void loadCheckpoint(TDirectory & directory);
+
 protected:
 
+  //!
+  //! Execute the subtasks and their replicas on nThreads threads.
+  //!
+  virtual void executeThreaded();
+
+  //!
+  //! Work loop of thread iThread (iThread>0): initialize the replicas, then execute them on each round of events released by executeThreaded().
+  //!
+  virtual void executeThread(unsigned int iThread, TaskIteratorSync & sync);
+
+  //!
+  //! Sum the histograms and counters of the replicas into the subtasks of this iterator and reset the replicas.
+  //!
+  virtual void mergeThreadSubTasks();
+
+  //!
+  //! Execute the subtasks as a two stage pipeline: the producer stage runs in a separate thread while this thread runs the consumer stage.
+  //!
+  virtual void executePipelined();
+
+  //!
+  //! Work loop of the producer stage: fill free slots with the first nProducers subtasks and queue them for the consumer stage.
+  //!
+  virtual void producePipeline(unsigned int nProducers, TaskIteratorPipeline & pipeline);
+
+  //!
+  //! Full name of the checkpoint file of this iterator.
+  //!
+  String getCheckpointFileName() const;
+
+  //!
+  //! Write a checkpoint. The checkpoint is first written to a temporary file which then replaces the previous checkpoint, so an
+  //! interrupted write leaves the previous checkpoint intact.
+  //!
+  virtual void writeCheckpoint();
+
+  //!
+  //! Resume from the checkpoint file, if it exists. Returns true if a checkpoint was loaded.
+  //!
+  virtual bool resumeFromCheckpoint();
+
+  //!
+  //! Sort the subtasks into levels based on the data they read and write (see Task::getDataRead()). A subtask is placed one level
+  //! after the last earlier subtask it depends on, so the subtasks of a level are independent and can execute concurrently.
+  //!
+  virtual void buildTaskLevels();
+
   bool    isGrid;
   long    nEventsPerSubbunch;
   int     nSubbunchesPerBunch;
   int     nBunches;
   long    nEventsRequested;
+  int     nThreads;
+  bool    pipelined;
+  int     pipelineDepth;
+  int     batchSize;
+  int     concurrentTasks;
   long    nEventsReport;
+  bool    checkpoint;
+  long    checkpointInterval;
+  String  checkpointPath;
   String  bunchLabel;
   String  subbunchLabel;
   long    iEvent;
   int     iSubBunch;
   int     iBunch;
+  bool    completed; //! true once all the requested events or bunches were processed
+  vector< vector<Task*> > threadSubTasks;
+  vector< vector<Task*> > taskLevels; //!
+  ExecutionContext * iteratorContext; //!
 
   ClassDef(TaskIterator,0)
 };
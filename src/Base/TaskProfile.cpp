@@ -0,0 +1,51 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "TaskProfile.hpp"
+using CAP::TaskProfile;
+
+bool TaskProfile::enabled = false;
+
+TaskProfile::TaskProfile()
+{
+  reset();
+}
+
+void TaskProfile::reset()
+{
+  for (int iPhase=0; iPhase<nPhases; iPhase++)
+    {
+    calls[iPhase] = 0;
+    times[iPhase] = 0.0;
+    }
+}
+
+void TaskProfile::add(const TaskProfile & other)
+{
+  for (int iPhase=0; iPhase<nPhases; iPhase++)
+    {
+    calls[iPhase] += other.calls[iPhase];
+    times[iPhase] += other.times[iPhase];
+    }
+}
+
+const char * TaskProfile::getPhaseName(Phase phase)
+{
+  switch (phase)
+    {
+      case Initialize:       return "initialize";
+      case Execute:          return "execute";
+      case Finalize:         return "finalize";
+      case ExportHistograms: return "exportHistograms";
+      case ScaleHistograms:  return "scaleHistograms";
+    }
+  return "unknown";
+}
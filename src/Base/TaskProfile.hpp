@@ -0,0 +1,130 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__TaskProfile
+#define CAP__TaskProfile
+#include <chrono>
+
+namespace CAP
+{
+
+//!
+//! TaskProfile
+//!
+//! Number of calls and time spent by one task in each of the phases of its life cycle. Profiles are filled by TaskProfileScope
+//! objects placed around the calls, only when profiling is enabled (see setEnabled()).
+//!
+class TaskProfile
+{
+public:
+
+  enum Phase { Initialize, Execute, Finalize, ExportHistograms, ScaleHistograms };
+
+  static const int nPhases = 5;
+
+  TaskProfile();
+
+  virtual ~TaskProfile() {}
+
+  //!
+  //! Clear all calls and times.
+  //!
+  void reset();
+
+  //!
+  //! Record nCalls calls of the given phase that lasted the given time (in seconds) altogether.
+  //!
+  void add(Phase phase, double seconds, long nCalls=1)
+  {
+  calls[phase] += nCalls;
+  times[phase] += seconds;
+  }
+
+  //!
+  //! Add the calls and times of the given profile to this profile.
+  //!
+  void add(const TaskProfile & other);
+
+  long getCalls(Phase phase) const
+  {
+  return calls[phase];
+  }
+
+  double getTime(Phase phase) const
+  {
+  return times[phase];
+  }
+
+  //!
+  //! Time spent in initialize, execute, and finalize. Histogram export and scaling are sub phases and not added in.
+  //!
+  double getTotalTime() const
+  {
+  return times[Initialize] + times[Execute] + times[Finalize];
+  }
+
+  static const char * getPhaseName(Phase phase);
+
+  static bool isEnabled()
+  {
+  return enabled;
+  }
+
+  static void setEnabled(bool _enabled)
+  {
+  enabled = _enabled;
+  }
+
+protected:
+
+  long   calls[nPhases];
+  double times[nPhases];
+
+  static bool enabled;
+
+};
+
+//!
+//! Times the enclosing block and records it in the given profile, if profiling is enabled when the scope is entered.
+//!
+class TaskProfileScope
+{
+public:
+
+  TaskProfileScope(TaskProfile & _profile, TaskProfile::Phase _phase, long _nCalls=1)
+  :
+  profile(_profile),
+  phase(_phase),
+  nCalls(_nCalls),
+  active(TaskProfile::isEnabled()),
+  start()
+  {
+  if (active) start = std::chrono::steady_clock::now();
+  }
+
+  ~TaskProfileScope()
+  {
+  if (active) profile.add(phase,std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count(),nCalls);
+  }
+
+protected:
+
+  TaskProfile &                         profile;
+  TaskProfile::Phase                    phase;
+  long                                  nCalls;
+  bool                                  active;
+  std::chrono::steady_clock::time_point start;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__TaskProfile */
@@ -386,20 +386,20 @@ inline double VectorField::derivative(double aFin, double aFi0, double aFip)
 
 
 int VectorField::factorySize = 40;
-Factory<VectorField> * VectorField::factory = 0;
+thread_local std::unique_ptr< Factory<VectorField> > VectorField::factory;
 Factory<VectorField> * VectorField::getFactory()
 {
   if (!factory)
     {
-    factory = new Factory<VectorField>();
+    factory.reset(new Factory<VectorField>());
     factory->initialize(factorySize);
     }
-  return factory;
+  return factory.get();
 }
 
 void VectorField::resetFactory()
 {
-  factory->reset();
+  if (factory) factory->reset();
 }
 
 
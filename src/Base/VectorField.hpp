@@ -29,6 +29,7 @@
 #ifndef _TH2_VECTOR_3D_H_
 #define _TH2_VECTOR_3D_H_
 
+#include <memory>
 #include <TString.h>
 #include "IdentifiedObject.hpp"
 #include "Factory.hpp"
@@ -122,7 +123,7 @@ protected:
 
 // CAP Implementing VectorField to ampnage the Vectorfield used
   static int factorySize;
-  static Factory<VectorField> * factory;
+  static thread_local std::unique_ptr< Factory<VectorField> > factory; //!< one factory per thread, deleted when the thread exits
 
 public:
 
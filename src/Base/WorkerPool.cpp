@@ -0,0 +1,105 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "WorkerPool.hpp"
+using CAP::WorkerPool;
+
+WorkerPool::WorkerPool(unsigned int _nThreads)
+:
+mutex(),
+condition(),
+completed(),
+operation(nullptr),
+nItems(0),
+next(0),
+round(0),
+nDone(0),
+stop(false),
+exception(),
+workers()
+{
+  for (unsigned int iThread=1; iThread<_nThreads; iThread++)
+    workers.push_back(std::thread(&WorkerPool::work,this,iThread));
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+    }
+  condition.notify_all();
+  for (unsigned int iWorker=0; iWorker<workers.size(); iWorker++) workers[iWorker].join();
+}
+
+void WorkerPool::execute(unsigned int _nItems, const std::function<void(unsigned int,unsigned int)> & _operation)
+{
+  if (workers.size()==0 || _nItems==1)
+    {
+    for (unsigned int iItem=0; iItem<_nItems; iItem++) _operation(0,iItem);
+    return;
+    }
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    operation = &_operation;
+    nItems    = _nItems;
+    next      = 0;
+    nDone     = 0;
+    round++;
+    }
+  condition.notify_all();
+  run(0);
+  std::exception_ptr caught;
+    {
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [this]{ return nDone==workers.size(); });
+    operation = nullptr;
+    caught    = exception;
+    exception = nullptr;
+    }
+  if (caught) std::rethrow_exception(caught);
+}
+
+void WorkerPool::run(unsigned int iThread)
+{
+  for (unsigned int iItem=next++; iItem<nItems; iItem=next++)
+    {
+    try
+      {
+      (*operation)(iThread,iItem);
+      }
+    catch (...)
+      {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!exception) exception = std::current_exception();
+      }
+    }
+}
+
+void WorkerPool::work(unsigned int iThread)
+{
+  long done = 0;
+  while (true)
+    {
+      {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this,done]{ return stop || round!=done; });
+      if (stop) return;
+      done = round;
+      }
+    run(iThread);
+      {
+      std::lock_guard<std::mutex> lock(mutex);
+      nDone++;
+      }
+    completed.notify_one();
+    }
+}
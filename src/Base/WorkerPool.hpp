@@ -0,0 +1,83 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__WorkerPool
+#define CAP__WorkerPool
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+#include <functional>
+
+using std::vector;
+
+namespace CAP
+{
+
+//!
+//! Pool of persistent worker threads executing the items of a parallel loop, e.g., the tiles of the pair loop of a single event
+//! (see ParticlePairParallelFiller). The threads are created once and wait between loops, so a loop can be run for every event
+//! without the cost of creating threads. The calling thread takes part in the execution as thread 0: a pool of n threads thus
+//! starts n-1 workers. Items are handed out, one at a time, to whichever thread is free.
+//!
+class WorkerPool
+{
+public:
+
+  //!
+  //! Create a pool of _nThreads threads, including the calling thread.
+  //!
+  WorkerPool(unsigned int _nThreads);
+
+  virtual ~WorkerPool();
+
+  //!
+  //! Execute operation(iThread,iItem) for items 0 to nItems-1, where iThread, in the range 0 to getNThreads()-1, identifies the
+  //! thread executing the item. Returns once all the items are completed, and rethrows the first exception thrown by any of them.
+  //!
+  void execute(unsigned int nItems, const std::function<void(unsigned int,unsigned int)> & operation);
+
+  unsigned int getNThreads() const
+  {
+  return workers.size()+1;
+  }
+
+protected:
+
+  //!
+  //! Execute items of the current loop until none is left.
+  //!
+  void run(unsigned int iThread);
+
+  //!
+  //! Work loop of the worker threads: wait for a loop to be released by execute(), take part in its execution, and signal completion.
+  //!
+  void work(unsigned int iThread);
+
+  std::mutex                mutex;
+  std::condition_variable   condition;
+  std::condition_variable   completed;
+  const std::function<void(unsigned int,unsigned int)> * operation;
+  unsigned int              nItems;
+  std::atomic<unsigned int> next;
+  long                      round;
+  unsigned int              nDone;
+  bool                      stop;
+  std::exception_ptr        exception;
+  vector<std::thread>       workers;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__WorkerPool */
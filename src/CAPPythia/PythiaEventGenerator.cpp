@@ -10,6 +10,9 @@
  *
  * *********************************************************************/
 
+#include <fstream>
+#include <iterator>
+#include "TSystem.h"
 #include "PythiaEventGenerator.hpp"
 using CAP::PythiaEventGenerator;
 
@@ -278,3 +281,43 @@ void PythiaEventGenerator::finalize()
   if (reportEnd(__FUNCTION__))
     ;
 }
+
+void PythiaEventGenerator::saveCheckpoint(TDirectory & directory)
+{
+  EventTask::saveCheckpoint(directory);
+  // Pythia only dumps the state of its generator to a file: the dump is copied into the checkpoint so both are replaced at once.
+  String stateFileName = "PythiaRndmState";
+  FILE * stateFile = gSystem->TempFileName(stateFileName);
+  if (!stateFile)
+    throw FileException(stateFileName,"Unable to create temporary file","PythiaEventGenerator::saveCheckpoint()");
+  fclose(stateFile);
+  bool dumped = pythia->rndm.dumpState(stateFileName.Data());
+  std::ifstream input(stateFileName.Data(),std::ios::binary);
+  std::vector<char> state((std::istreambuf_iterator<char>(input)),std::istreambuf_iterator<char>());
+  input.close();
+  gSystem->Unlink(stateFileName);
+  if (!dumped || state.empty())
+    throw TaskException("Unable to save the state of the Pythia random generator","PythiaEventGenerator::saveCheckpoint()");
+  directory.cd();
+  directory.WriteObjectAny(&state,"vector<char>","PythiaRndmState");
+}
+
+void PythiaEventGenerator::loadCheckpoint(TDirectory & directory)
+{
+  EventTask::loadCheckpoint(directory);
+  std::vector<char> * state = nullptr;
+  directory.GetObject("PythiaRndmState",state);
+  if (!state)
+    throw TaskException("Checkpoint has no state of the Pythia random generator","PythiaEventGenerator::loadCheckpoint()");
+  String stateFileName = "PythiaRndmState";
+  FILE * stateFile = gSystem->TempFileName(stateFileName);
+  if (!stateFile)
+    throw FileException(stateFileName,"Unable to create temporary file","PythiaEventGenerator::loadCheckpoint()");
+  fwrite(state->data(),1,state->size(),stateFile);
+  fclose(stateFile);
+  delete state;
+  bool restored = pythia->rndm.readState(stateFileName.Data());
+  gSystem->Unlink(stateFileName);
+  if (!restored)
+    throw TaskException("Unable to restore the state of the Pythia random generator","PythiaEventGenerator::loadCheckpoint()");
+}
@@ -68,6 +68,18 @@ public:
   //!
   virtual void createEvent();
 
+  //!
+  //! Save the histograms and counters of this generator, and the state of the random generator of Pythia, so a resumed run
+  //! continues with the same sequence of events as the original run. The state of the generator is not changed: runs with and
+  //! without checkpoints produce the same events.
+  //!
+  virtual void saveCheckpoint(TDirectory & directory);
+
+  //!
+  //! Restore the state saved by saveCheckpoint(), including that of the Pythia random generator.
+  //!
+  virtual void loadCheckpoint(TDirectory & directory);
+
 
 protected:
   
@@ -23,6 +23,7 @@ b(0.0),
 nucleusA(),
 nucleusB(),
 nnInteractions(),
+genealogy(),
 binaryMoments(),
 participantMoments()
 {
@@ -35,10 +36,11 @@ b(collisionGeometry.b),
 nucleusA(collisionGeometry.nucleusA),
 nucleusB(collisionGeometry.nucleusB),
 nnInteractions(collisionGeometry.nnInteractions),
+genealogy(),
 binaryMoments(collisionGeometry.binaryMoments),
 participantMoments(collisionGeometry.participantMoments)
 {
-
+  copyInteractionParents(collisionGeometry);
 }
 
 CollisionGeometry & CollisionGeometry::operator=(const CollisionGeometry & collisionGeometry)
@@ -51,16 +53,35 @@ CollisionGeometry & CollisionGeometry::operator=(const CollisionGeometry & colli
     nnInteractions     = collisionGeometry.nnInteractions;
     binaryMoments      = collisionGeometry.binaryMoments;
     participantMoments = collisionGeometry.participantMoments;
+    copyInteractionParents(collisionGeometry);
     }
   return *this;
 }
 
+// The interactions copied from the source still refer to the genealogy arena of the source: record their parents again in this arena.
+void CollisionGeometry::copyInteractionParents(const CollisionGeometry & collisionGeometry)
+{
+  genealogy.clear();
+  for (unsigned int k=0; k<nnInteractions.size(); k++)
+    {
+    ParticleGenealogy::Range parents = collisionGeometry.nnInteractions[k].getParents();
+    Particle & interaction = nnInteractions[k];
+    LorentzVector momentum = interaction.getMomentum();
+    LorentzVector position = interaction.getPosition();
+    interaction.setGenealogy(&genealogy);
+    if (parents.size()==2) interaction.setParents(parents[0],parents[1]);
+    interaction.setMomentum(momentum);
+    interaction.setPosition(position);
+    }
+}
+
 void CollisionGeometry::clear()
 {
   b = -99999;
   nucleusA.clear();
   nucleusB.clear();
   nnInteractions.clear();
+  genealogy.clear();
   binaryMoments.reset();
   participantMoments.reset();
 }
@@ -71,6 +92,7 @@ void CollisionGeometry::reset()
   nucleusA.reset();
   nucleusB.reset();
   nnInteractions.clear();
+  genealogy.clear();
   binaryMoments.reset();
   participantMoments.reset();
 }
@@ -80,6 +102,7 @@ void CollisionGeometry::addNNCollision(Particle* nucleonA,
 {
 
   Particle interaction;
+  interaction.setGenealogy(&genealogy);
   interaction.setParents(nucleonA,nucleonB);
 
   //cout << " A:  x= " << nucleonA->getPosition().X() << " B:  x= " << nucleonB->getPosition().X() << " I:  x= " << interaction.getPosition().X() << endl;
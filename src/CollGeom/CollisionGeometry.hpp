@@ -37,6 +37,7 @@ protected:
   Nucleus nucleusA;
   Nucleus nucleusB;
   vector<Particle> nnInteractions;
+  ParticleGenealogy genealogy; //! Parents (nucleons) of the nucleon-nucleon interactions
   CollisionGeometryMoments binaryMoments;
   CollisionGeometryMoments participantMoments;
 
@@ -80,6 +81,8 @@ public:
 
 protected:
 
+  void copyInteractionParents(const CollisionGeometry & collisionGeometry);
+
   static CollisionGeometry * defaultCollisionGeometry;
 
 public:
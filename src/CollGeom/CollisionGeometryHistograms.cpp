@@ -353,8 +353,8 @@ void CollisionGeometryHistograms::fill(Event & event, double weight)
 
   Nucleus & nucleusA =  event.getNucleusA();
   Nucleus & nucleusB =  event.getNucleusB();
-  vector<Particle*> nucleonsA = nucleusA.getChildren();
-  vector<Particle*> nucleonsB = nucleusB.getChildren();
+  const vector<Particle*> & nucleonsA = nucleusA.getNucleons();
+  const vector<Particle*> & nucleonsB = nucleusB.getNucleons();
   for (unsigned int k=0;k<nucleonsA.size(); k++)
     {
     const LorentzVector & position = nucleonsA[k]->getPosition();
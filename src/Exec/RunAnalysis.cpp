@@ -9,6 +9,11 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <unistd.h>
+#include <sys/wait.h>
+#include <fstream>
+#include "TRandom.h"
+#include "TSystem.h"
 #include "RunAnalysis.hpp"
 #include "ParticleDbManager.hpp"
 #include "FilterCreator.hpp"
@@ -67,7 +72,9 @@ labelEpos("Epos"),
 labelUrqmd("Urqmd"),
 labelTherminator("Therminator"),
 labelResonance("Resonance"),
-labelPerformance("Performance")
+labelPerformance("Performance"),
+nProcesses(1),
+eventAnalysis(nullptr)
 {
   appendClassName("RunAnalysis");
 }
@@ -111,6 +118,9 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("RunEventAnalysis",           YES);
   addParameter("RunEventAnalysisGen",        YES);
   addParameter("RunEventAnalysisReco",       NO);
+  addParameter("nProcesses",                 int(1));
+  addParameter("maxConcurrentFiles",         int(1));
+  addParameter("Profiling",                  NO);
 
   addParameter("RunDerived",                 NO);
   addParameter("RunDerivedGen",              NO);
@@ -157,6 +167,7 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("Analysis:RunNuDynAnalysisGen",        NO);
   addParameter("Analysis:RunNuDynAnalysisReco",       NO);
   addParameter("Analysis:nBunches",                   int(50));
+  addParameter("Analysis:nThreads",                   int(1));
   addParameter("Analysis:HistogramsImportPath",       TString("DEFAULT"));
   addParameter("Analysis:HistogramsExportPath",       TString("DEFAULT"));
 }
@@ -221,6 +232,39 @@ void RunAnalysis::configureLabels()
     }
 }
 
+//!
+//! Add the generator and analyzer tasks of the event analysis to the given iterator. With iThread==0, the tasks
+//! are the regular subtasks of the iterator; with iThread>0, they form the replica set run by thread iThread.
+//!
+void RunAnalysis::addEventAnalysisTasks(TaskIterator * eventAnalysis, unsigned int iThread)
+{
+  if (getValueBool("Analysis:RunPythiaGenerator"))         eventAnalysis->addThreadSubTask(iThread,new PythiaEventGenerator(labelPythia,*requestedConfiguration));
+  if (getValueBool("Analysis:RunAmptReader"))              eventAnalysis->addThreadSubTask(iThread,new AmptEventReader(labelAmpt,*requestedConfiguration));
+  if (getValueBool("Analysis:RunTherminatorGenerator"))    eventAnalysis->addThreadSubTask(iThread,new TherminatorGenerator(labelTherminator,*requestedConfiguration));
+  if (getValueBool("Analysis:RunResonanceGenerator"))      eventAnalysis->addThreadSubTask(iThread,new ResonanceGenerator(labelResonance,*requestedConfiguration));
+  if (getValueBool("Analysis:RunPerformanceSim"))          eventAnalysis->addThreadSubTask(iThread,new MeasurementPerformanceSimulator(labelPerformance,*requestedConfiguration));
+
+  if (getValueBool("RunEventAnalysisGen"))
+    {
+    if (getValueBool("Analysis:RunGlobalAnalysisGen"))       eventAnalysis->addThreadSubTask(iThread,new GlobalAnalyzer(labelGlobal+labelGenerator, *requestedConfiguration));
+    if (getValueBool("Analysis:RunSpherocityAnalysisGen"))   eventAnalysis->addThreadSubTask(iThread,new TransverseSpherocityAnalyzer(labelSpherocity+labelGenerator, *requestedConfiguration));
+    if (getValueBool("Analysis:RunPartSingleAnalysisGen"))   eventAnalysis->addThreadSubTask(iThread,new ParticleSingleAnalyzer(labelSingle+labelGenerator, *requestedConfiguration));
+    if (getValueBool("Analysis:RunPartPairAnalysisGen"))     eventAnalysis->addThreadSubTask(iThread,new ParticlePairAnalyzer(labelPair+labelGenerator, *requestedConfiguration));
+    if (getValueBool("Analysis:RunNuDynAnalysisGen"))        eventAnalysis->addThreadSubTask(iThread,new NuDynAnalyzer(labelNuDyn+labelGenerator,*requestedConfiguration));
+    }
+
+  if (getValueBool("RunEventAnalysisReco"))
+    {
+    if (getValueBool("Analysis:RunGlobalAnalysisReco"))      eventAnalysis->addThreadSubTask(iThread,new GlobalAnalyzer(labelGlobal+labelReconstruction,*requestedConfiguration));
+    if (getValueBool("Analysis:RunSpherocityAnalysisReco"))  eventAnalysis->addThreadSubTask(iThread,new TransverseSpherocityAnalyzer(labelSpherocity+labelReconstruction, *requestedConfiguration));
+    if (getValueBool("Analysis:RunPartSingleAnalysisReco"))  eventAnalysis->addThreadSubTask(iThread,new ParticleSingleAnalyzer(labelSingle+labelReconstruction, *requestedConfiguration));
+    if (getValueBool("Analysis:RunPartPairAnalysisReco"))    eventAnalysis->addThreadSubTask(iThread,new ParticlePairAnalyzer(labelPair+labelReconstruction, *requestedConfiguration));
+    if (getValueBool("Analysis:RunNuDynAnalysisReco"))       eventAnalysis->addThreadSubTask(iThread,new NuDynAnalyzer(labelNuDyn+labelReconstruction,*requestedConfiguration));
+    if (getValueBool("Analysis:RunPerformanceAna"))          eventAnalysis->addThreadSubTask(iThread,new ParticlePerformanceAnalyzer(labelSimAna,*requestedConfiguration));
+    }
+}
+
+
 void RunAnalysis::configure()
 {
 
@@ -238,9 +282,17 @@ void RunAnalysis::configure()
   String  histoImportPath = getValueString("HistogramsImportPath");
   String  histoExportPath = getValueString("HistogramsExportPath");
   int nBunches = getValueInt("Analysis:nBunches");
+  nProcesses   = getValueInt("nProcesses");
+  if (nProcesses<1) nProcesses = 1;
+  int maxConcurrentFiles = getValueInt("maxConcurrentFiles");
+  if (maxConcurrentFiles<1) maxConcurrentFiles = 1;
+  TaskProfile::setEnabled(getValueBool("Profiling"));
 
   printItem("histoExportPath",histoExportPath);
   printItem("nBunches",nBunches);
+  printItem("nProcesses",nProcesses);
+  printItem("maxConcurrentFiles",maxConcurrentFiles);
+  printItem("Profiling",TaskProfile::isEnabled());
 
   //
   // task run only once at the beginning...
@@ -255,46 +307,69 @@ void RunAnalysis::configure()
   if (getValueBool("RunEventAnalysis"))
     {
     if (reportInfo(__FUNCTION__)) cout << "Setting up event analysis" << std::endl;
-    TaskIterator * eventAnalysis = new TaskIterator("Analysis",*requestedConfiguration);
+    eventAnalysis = new TaskIterator("Analysis",*requestedConfiguration);
     addSubTask(eventAnalysis);
 
-    if (getValueBool("Analysis:RunPythiaGenerator"))         eventAnalysis->addSubTask(new PythiaEventGenerator(labelPythia,*requestedConfiguration));
-    if (getValueBool("Analysis:RunAmptReader"))              eventAnalysis->addSubTask(new AmptEventReader(labelAmpt,*requestedConfiguration));
-    if (getValueBool("Analysis:RunTherminatorGenerator"))    eventAnalysis->addSubTask(new TherminatorGenerator(labelTherminator,*requestedConfiguration));
-    if (getValueBool("Analysis:RunResonanceGenerator"))      eventAnalysis->addSubTask(new ResonanceGenerator(labelResonance,*requestedConfiguration));
-    if (getValueBool("Analysis:RunPerformanceSim"))          eventAnalysis->addSubTask(new MeasurementPerformanceSimulator(labelPerformance,*requestedConfiguration));
-
-    if (getValueBool("RunEventAnalysisGen"))
+    int nThreads = getValueInt("Analysis:nThreads");
+    if (nThreads>1 && (getValueBool("Analysis:RunAmptReader")           ||
+                       getValueBool("Analysis:RunTherminatorGenerator") ||
+                       getValueBool("Analysis:RunResonanceGenerator")   ||
+                       getValueBool("Analysis:RunPerformanceSim")))
       {
-      if (getValueBool("Analysis:RunGlobalAnalysisGen"))       eventAnalysis->addSubTask(new GlobalAnalyzer(labelGlobal+labelGenerator, *requestedConfiguration));
-      if (getValueBool("Analysis:RunSpherocityAnalysisGen"))   eventAnalysis->addSubTask(new TransverseSpherocityAnalyzer(labelSpherocity+labelGenerator, *requestedConfiguration));
-      if (getValueBool("Analysis:RunPartSingleAnalysisGen"))   eventAnalysis->addSubTask(new ParticleSingleAnalyzer(labelSingle+labelGenerator, *requestedConfiguration));
-      if (getValueBool("Analysis:RunPartPairAnalysisGen"))     eventAnalysis->addSubTask(new ParticlePairAnalyzer(labelPair+labelGenerator, *requestedConfiguration));
-      if (getValueBool("Analysis:RunNuDynAnalysisGen"))        eventAnalysis->addSubTask(new NuDynAnalyzer(labelNuDyn+labelGenerator,*requestedConfiguration));
+      // these tasks read a shared input file or draw from the global gRandom and cannot be replicated across threads.
+      throw ConfigurationException("Analysis:nThreads","nThreads>1 is only supported with the Pythia generator.","RunAnalysis::configure()");
       }
-
-    if (getValueBool("RunEventAnalysisReco"))
+    for (int iThread=0; iThread<nThreads; iThread++) addEventAnalysisTasks(eventAnalysis,iThread);
+    if (nProcesses>1)
       {
-      if (getValueBool("Analysis:RunGlobalAnalysisReco"))      eventAnalysis->addSubTask(new GlobalAnalyzer(labelGlobal+labelReconstruction,*requestedConfiguration));
-      if (getValueBool("Analysis:RunSpherocityAnalysisReco"))  eventAnalysis->addSubTask(new TransverseSpherocityAnalyzer(labelSpherocity+labelReconstruction, *requestedConfiguration));
-      if (getValueBool("Analysis:RunPartSingleAnalysisReco"))  eventAnalysis->addSubTask(new ParticleSingleAnalyzer(labelSingle+labelReconstruction, *requestedConfiguration));
-      if (getValueBool("Analysis:RunPartPairAnalysisReco"))    eventAnalysis->addSubTask(new ParticlePairAnalyzer(labelPair+labelReconstruction, *requestedConfiguration));
-      if (getValueBool("Analysis:RunNuDynAnalysisReco"))       eventAnalysis->addSubTask(new NuDynAnalyzer(labelNuDyn+labelReconstruction,*requestedConfiguration));
-      if (getValueBool("Analysis:RunPerformanceAna"))          eventAnalysis->addSubTask(new ParticlePerformanceAnalyzer(labelSimAna,*requestedConfiguration));
+      // worker processes are not given disjoint input ranges: each would read the same events.
+      for (unsigned int  iTask=0; iTask<eventAnalysis->getNSubTasks(); iTask++)
+        if (dynamic_cast<RootTreeReader*>(eventAnalysis->getSubTaskAt(iTask)))
+          throw ConfigurationException("nProcesses","nProcesses>1 is not supported with event readers.","RunAnalysis::configure()");
       }
 
     // make sure the subtasks get the right import and export paths for histograms...
     // this way, we do not have to specify the path in the ini file for eacu sub task.
     //
-    if (eventAnalysis->hasSubTasks())
-      for (unsigned int  iTask=0; iTask<eventAnalysis->getNSubTasks(); iTask++)
+    for (int iThread=0; iThread<nThreads; iThread++)
+      for (unsigned int  iTask=0; iTask<eventAnalysis->getNThreadSubTasks(iThread); iTask++)
         {
-        Task * task = eventAnalysis->getSubTaskAt(iTask);
+        Task * task = eventAnalysis->getThreadSubTaskAt(iThread,iTask);
         task->configure();
         task->addParameter("HistogramsImportPath",histoImportPath);
         task->addParameter("HistogramsExportPath",histoExportPath);
+        // each thread generates its own events: replica generators get distinct seeds
+        if (iThread>0 && dynamic_cast<PythiaEventGenerator*>(task))
+          task->addParameter("SeedValue",task->getValueLong("SeedValue")+long(iThread));
         }
     if (reportInfo(__FUNCTION__)) cout << "Event Analysis Setup Completed" << std::endl;
+
+    //
+    // With nProcesses>1, the workers export their histograms in histoExportPath/BUNCHnn/. Sum them (unbunched sub-sample
+    // calculation) before the derived and balance function stages.
+    //
+    if (nProcesses>1)
+      {
+      if (histoExportPath.EqualTo("DEFAULT"))
+        throw ConfigurationException("HistogramsExportPath","An explicit export path is required with nProcesses>1.","RunAnalysis::configure()");
+      int maximumDepth = 2;
+      if (getValueBool("RunEventAnalysisGen"))
+        {
+        if (getValueBool("Analysis:RunGlobalAnalysisGen"))     addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelGlobal+labelGenerator);
+        if (getValueBool("Analysis:RunSpherocityAnalysisGen")) addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelSpherocity+labelGenerator);
+        if (getValueBool("Analysis:RunPartSingleAnalysisGen")) addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelSingle+labelGenerator);
+        if (getValueBool("Analysis:RunPartPairAnalysisGen"))   addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelPair+labelGenerator);
+        if (getValueBool("Analysis:RunNuDynAnalysisGen"))      addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelNuDyn+labelGenerator);
+        }
+      if (getValueBool("RunEventAnalysisReco"))
+        {
+        if (getValueBool("Analysis:RunGlobalAnalysisReco"))     addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelGlobal+labelReconstruction);
+        if (getValueBool("Analysis:RunSpherocityAnalysisReco")) addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelSpherocity+labelReconstruction);
+        if (getValueBool("Analysis:RunPartSingleAnalysisReco")) addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelSingle+labelReconstruction);
+        if (getValueBool("Analysis:RunPartPairAnalysisReco"))   addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelPair+labelReconstruction);
+        if (getValueBool("Analysis:RunNuDynAnalysisReco"))      addBaseSubSampleTask(histoExportPath,labelBunch,0,labelSubBunch,maximumDepth,labelNuDyn+labelReconstruction);
+        }
+      }
     }
 
   //
@@ -342,6 +417,7 @@ void RunAnalysis::configure()
       dConfig.addParameter(configPath+"ExcludedPattern1",TString("BalFct"));
       dConfig.addParameter(configPath+"ExcludedPattern2",TString("Derived"));
       dConfig.addParameter(configPath+"nBunches",nBunches);
+      dConfig.addParameter(configPath+"maxConcurrentFiles",maxConcurrentFiles);
 
       DerivedHistoIterator * derived = new DerivedHistoIterator(taskName,dConfig);
       addSubTask(derived);
@@ -366,7 +442,9 @@ void RunAnalysis::configure()
         subConfig.addParameter(subConfigPath+"ExcludedPattern0",TString("Reco"));
         subConfig.addParameter(subConfigPath+"ExcludedPattern2",TString("Derived"));
         subConfig.addParameter(subConfigPath+"ExcludedPattern1",TString("BalFct"));
-        derived->addSubTask(new ParticleSingleAnalyzer(subTaskName, subConfig));
+        // one copy of the analyzer per concurrent file
+        for (int iWorker=0; iWorker<maxConcurrentFiles; iWorker++)
+          derived->addWorkerSubTask(iWorker,new ParticleSingleAnalyzer(subTaskName, subConfig));
         }
 
       if (getValueBool("Analysis:RunPartPairAnalysisGen"))
@@ -381,7 +459,8 @@ void RunAnalysis::configure()
         subConfig.addParameter(subConfigPath+"ExcludedPattern0",TString("Reco"));
         subConfig.addParameter(subConfigPath+"ExcludedPattern1",TString("BalFct"));
         subConfig.addParameter(subConfigPath+"ExcludedPattern2",TString("Derived"));
-        derived->addSubTask(new ParticlePairAnalyzer(subTaskName, subConfig));
+        for (int iWorker=0; iWorker<maxConcurrentFiles; iWorker++)
+          derived->addWorkerSubTask(iWorker,new ParticlePairAnalyzer(subTaskName, subConfig));
         }
 
       //    if (runNuDynAnalysisGen)           derived->addSubTask(new NuDynAnalyzer(labelNuDyn+labelGenerator,configuration));
@@ -412,6 +491,7 @@ void RunAnalysis::configure()
         dConfig.addParameter(configPath+"ExcludedPattern1",TString("BalFct"));
         dConfig.addParameter(configPath+"ExcludedPattern2",TString("Single"));
         dConfig.addParameter(configPath+"AppendedString",  TString("BalFct"));
+        dConfig.addParameter(configPath+"maxConcurrentFiles",maxConcurrentFiles);
         dConfig.printConfiguration(cout);
         addSubTask(new BalanceFunctionCalculator(taskName,dConfig));
         }
@@ -444,7 +524,8 @@ void RunAnalysis::configure()
       printItem("Analysis:RunNuDynAnalysisGen");
       }
 
-    if (getValueBool("RunSubsampleBase"))
+    // the worker outputs are already summed when running with nProcesses>1
+    if (getValueBool("RunSubsampleBase") && nProcesses==1)
       {
       int maximumDepth = 2;
       if (getValueBool("RunSubsampleBaseGen"))
@@ -542,6 +623,18 @@ void RunAnalysis::configure()
         }
       }
 
+    //
+    // configuration complete: the event analysis tasks only look up their own parameters from here on.
+    //
+    if (eventAnalysis)
+      {
+      int nThreads = eventAnalysis->getNThreads();
+      eventAnalysis->freezeConfiguration();
+      for (int iThread=0; iThread<nThreads; iThread++)
+        for (unsigned int  iTask=0; iTask<eventAnalysis->getNThreadSubTasks(iThread); iTask++)
+          eventAnalysis->getThreadSubTaskAt(iThread,iTask)->freezeConfiguration();
+      }
+
     if (reportInfo(__FUNCTION__)) cout << "Completed configuration of tasks and their subtasks" << std::endl;
     }
 
@@ -593,8 +686,16 @@ void RunAnalysis::execute()
     cout << "RunAnalysis::execute() Started" << std::endl;
     cout << "==================================================================================" << std::endl;
     }
-  initializeSubTasks();
-  executeSubTasks();
+  if (nProcesses>1 && eventAnalysis)
+    {
+    executeProcesses();
+    }
+  else
+    {
+    initializeSubTasks();
+    executeSubTasks();
+    }
+  if (TaskProfile::isEnabled()) exportProfile(getValueString("HistogramsExportPath"));
   if (reportInfo(__FUNCTION__))
     {
     cout << endl;
@@ -641,6 +742,118 @@ void RunAnalysis::execute()
 
 }
 
+void RunAnalysis::executeProcesses()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  unsigned int iAnalysis = 0;
+  while (iAnalysis<getNSubTasks() && getSubTaskAt(iAnalysis)!=eventAnalysis) iAnalysis++;
+  long nEventsRequested = eventAnalysis->getNEventsRequested();
+  // drawn before the fork so that each worker derives a distinct but reproducible seed from it
+  unsigned int baseSeed = gRandom->Integer(1000000000);
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("nProcesses",nProcesses);
+    printItem("nEventsRequested",nEventsRequested);
+    }
+
+  vector<pid_t> workers;
+  for (int iProcess=0; iProcess<nProcesses; iProcess++)
+    {
+    long nEvents = nEventsRequested/nProcesses;
+    if (iProcess < nEventsRequested%nProcesses) nEvents++;
+    cout << flush;
+    pid_t pid = fork();
+    if (pid<0) throw TaskException("Unable to fork a worker process.","RunAnalysis::executeProcesses()");
+    if (pid==0)
+      {
+      int status = 0;
+      try
+      {
+      executeProcess(iProcess,nEvents,baseSeed,iAnalysis);
+      }
+      catch (Exception & e)
+      {
+      e.print(); status = 1;
+      }
+      cout << flush;
+      _exit(status);
+      }
+    workers.push_back(pid);
+    }
+
+  int nFailed = 0;
+  for (unsigned int iWorker=0; iWorker<workers.size(); iWorker++)
+    {
+    int status = 0;
+    if (waitpid(workers[iWorker],&status,0)<0 || !WIFEXITED(status) || WEXITSTATUS(status)!=0) nFailed++;
+    }
+  if (nFailed>0)
+    {
+    String message = "Worker processes failed: ";
+    message += nFailed;
+    throw TaskException(message,"RunAnalysis::executeProcesses()");
+    }
+
+  // all workers are done: run the remaining stages on their outputs.
+  for (unsigned int iTask=0; iTask<getNSubTasks(); iTask++)
+    if (iTask!=iAnalysis) getSubTaskAt(iTask)->profiledInitialize();
+  for (unsigned int iTask=0; iTask<getNSubTasks(); iTask++)
+    if (iTask!=iAnalysis) getSubTaskAt(iTask)->profiledExecute();
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void RunAnalysis::executeProcess(int iProcess, long nEvents, unsigned int baseSeed, unsigned int iAnalysis)
+{
+  String workerPath = getValueString("HistogramsExportPath");
+  workerPath += "/";
+  workerPath += labelBunch;
+  workerPath += Form("%02d",iProcess+1);
+  workerPath += "/";
+  gRandom->SetSeed(baseSeed+iProcess+1);
+
+  int nThreads = eventAnalysis->getNThreads();
+  for (int iThread=0; iThread<nThreads; iThread++)
+    for (unsigned int iTask=0; iTask<eventAnalysis->getNThreadSubTasks(iThread); iTask++)
+      {
+      Task * task = eventAnalysis->getThreadSubTaskAt(iThread,iTask);
+      task->setHistosExportPath(workerPath);
+      task->addParameter("HistogramsExportPath",workerPath);
+      // seeds of thread k of process p: SeedValue + p*nThreads + k
+      if (dynamic_cast<PythiaEventGenerator*>(task))
+        task->addParameter("SeedValue",task->getValueLong("SeedValue")+long(iProcess*nThreads));
+      }
+  eventAnalysis->addParameter("HistogramsExportPath",workerPath);
+  eventAnalysis->setGrid(true);
+  eventAnalysis->setNEventsRequested(nEvents);
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("iProcess",iProcess);
+    printItem("nEvents",nEvents);
+    printItem("HistogramsExportPath",workerPath);
+    }
+  for (unsigned int iTask=0; iTask<=iAnalysis; iTask++) getSubTaskAt(iTask)->profiledInitialize();
+  for (unsigned int iTask=0; iTask<=iAnalysis; iTask++) getSubTaskAt(iTask)->profiledExecute();
+  if (TaskProfile::isEnabled()) exportProfile(workerPath);
+}
+
+void RunAnalysis::exportProfile(const String & exportPath)
+{
+  printProfile(cout);
+  String fileName = exportPath;
+  if (fileName.Length()>0 && !fileName.EndsWith("/")) fileName += "/";
+  if (fileName.Length()>2) gSystem->mkdir(fileName,1);
+  fileName += getName();
+  fileName += "Profile.json";
+  std::ofstream output(fileName.Data());
+  if (!output.is_open()) throw FileException(fileName,"Unable to open profile output file","RunAnalysis::exportProfile()");
+  writeProfile(output);
+  if (reportInfo(__FUNCTION__)) cout << "Profile written to " << fileName << endl;
+}
+
 void RunAnalysis::addBaseSubSampleTask(const String & basePath,
                                        const String & labelBunch,
                                        int   nBunches,
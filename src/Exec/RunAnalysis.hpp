@@ -21,6 +21,8 @@ using std::vector;
 
 namespace CAP
 {
+class TaskIterator;
+
 class RunAnalysis : public Task
 {
 public:
@@ -45,11 +47,36 @@ public:
   //!
   virtual void configure();
 
+  //!
+  //! Add the generator and analyzer tasks of the event analysis to the given iterator, as regular subtasks (iThread==0)
+  //! or as the replica set of thread iThread (iThread>0).
+  //!
+  virtual void addEventAnalysisTasks(TaskIterator * eventAnalysis, unsigned int iThread);
+
   //!
   //! Execute this task
   //!
   void execute();
 
+  //!
+  //! Run the event analysis in nProcesses forked worker processes, wait for them to complete, and then run the remaining
+  //! (sum, derived, balance function) tasks in this process. Each worker generates its own events: configurations with event
+  //! readers are rejected since the workers would all read the same events.
+  //!
+  virtual void executeProcesses();
+
+  //!
+  //! Body of worker process iProcess: run the tasks up to and including the event analysis on nEvents events with distinct
+  //! seeds, and export the histograms in the worker's own bunch directory.
+  //!
+  virtual void executeProcess(int iProcess, long nEvents, unsigned int baseSeed, unsigned int iAnalysis);
+
+  //!
+  //! Print the profile of all tasks and write it, in JSON format, to file <name>Profile.json in the given directory.
+  //! Called at the end of execute() when the "Profiling" parameter is set.
+  //!
+  virtual void exportProfile(const String & exportPath);
+
   void addBaseSubSampleTask(const String & basePath,
                             const String & bunchLabel,
                             int   nBunches,
@@ -102,6 +129,9 @@ protected:
   String labelResonance;
   String labelPerformance;
 
+  int            nProcesses;
+  TaskIterator * eventAnalysis;
+
   ClassDef(RunAnalysis,0)
 };
 
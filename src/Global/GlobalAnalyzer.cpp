@@ -32,6 +32,7 @@ b(),
 ptSum()
 {
   appendClassName("GlobalAnalyzer");
+  eventsReadOnly = true;
 }
 
 //!
@@ -220,7 +221,34 @@ void GlobalAnalyzer::importHistograms(TFile & inputFile)
 
 void GlobalAnalyzer::analyzeEvent()
 {
-  Event & event = * getEventStream(0);
+  fetchEventFilterHistos();
+  analyzeEvent(* getEventStream(0));
+}
+
+unsigned int GlobalAnalyzer::getDataWritten() const
+{
+  unsigned int data = EventTask::getDataWritten();
+  if (setEvent && data!=AllData) data |= getEventStreamsData() & PropertiesData;
+  return data;
+}
+
+void GlobalAnalyzer::analyzeEvents(const vector<Event*> & events)
+{
+  fetchEventFilterHistos();
+  for (unsigned int iEvent=0; iEvent<events.size(); iEvent++) analyzeEvent(* events[iEvent]);
+}
+
+void GlobalAnalyzer::fetchEventFilterHistos()
+{
+  unsigned int nEventFilters = eventFilters.size();
+  eventFilterHistos.assign(nEventFilters,nullptr);
+  if (histogramManager.getNSets()<1) return;
+  for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    eventFilterHistos[iEventFilter] = (GlobalHistos * ) histogramManager.getGroup(0,iEventFilter);
+}
+
+void GlobalAnalyzer::analyzeEvent(Event & event)
+{
   // count eventStreams used to fill histograms and for scaling at the end..
   // resetParticleCounters();
   unsigned int nEventFilters    = eventFilters.size();
@@ -248,25 +276,24 @@ void GlobalAnalyzer::analyzeEvent()
     s.assign(nParticleFilters,0.0);
     b.assign(nParticleFilters,0.0);
     ptSum.assign(nParticleFilters,0.0);
-    for (unsigned int iParticle=0; iParticle<event.getNParticles(); iParticle++)
+    const EventColumns & columns = event.getColumns();
+    selectParticles(event);
+    for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
       {
-      Particle & particle = * event.getParticleAt(iParticle);
-      for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      const vector<unsigned int> & accepted = particleSelections[iParticleFilter]->indices;
+      for (unsigned int iAccepted=0; iAccepted<accepted.size(); iAccepted++)
         {
-        //cout << iParticleFilter << "  " << particle.getType().getName() << endl;
-        if (particleFilters[iParticleFilter]->accept(particle))
-          {
-          incrementNParticlesAccepted(iEventFilter,iParticleFilter);
-          // // incrementParticlesAccepted();
-          ParticleType & type = particle.getType();
-          LorentzVector & momentum = particle.getMomentum();
-          n[iParticleFilter]++;
-          e[iParticleFilter] += momentum.E();
-          q[iParticleFilter] += type.getCharge();
-          s[iParticleFilter] += type.getStrangessNumber();
-          b[iParticleFilter] += type.getBaryonNumber();
-          ptSum[iParticleFilter] += momentum.Pt();
-          }
+        unsigned int iParticle = accepted[iAccepted];
+        Particle & particle = * event.getParticleAt(iParticle);
+        incrementNParticlesAccepted(iEventFilter,iParticleFilter);
+        // // incrementParticlesAccepted();
+        ParticleType & type = particle.getType();
+        n[iParticleFilter]++;
+        e[iParticleFilter] += columns.e[iParticle];
+        q[iParticleFilter] += columns.charge[iParticle];
+        s[iParticleFilter] += type.getStrangessNumber();
+        b[iParticleFilter] += type.getBaryonNumber();
+        ptSum[iParticleFilter] += columns.pt[iParticle];
         }
       }
 //    if (reportInfo(__FUNCTION__))
@@ -290,8 +317,7 @@ void GlobalAnalyzer::analyzeEvent()
       }
     //Sexit(1);
     //cout << "Global counts " << n[0] << " charge: " << q[0]  << endl;
-    GlobalHistos * globalHistos = (GlobalHistos * ) histogramManager.getGroup(0,iEventFilter);
-    globalHistos->fill(n,ptSum,e,q,s,b,1.0);
+    eventFilterHistos[iEventFilter]->fill(n,ptSum,e,q,s,b,1.0);
     }
 }
 
@@ -20,6 +20,8 @@
 namespace CAP
 {
 
+class GlobalHistos;
+
 //!
 //! This class implements a basic analyzer of the multiplicity, energy, net charge, net strangeness, and net baryon number of the particles composing an event.
 //! A global analyzer task can be used to determine the multiplcity (or other characteristics) of an event and set the event record with these values. The values
@@ -71,6 +73,16 @@ public:
   //! and particle filters operated by this task. It is also involves the filling of corresponding histograms.
   //!
   virtual void analyzeEvent();
+
+  //!
+  //! Analyze a block of events. The histogram groups and filter counts are fetched once for the whole block.
+  //!
+  virtual void analyzeEvents(const vector<Event*> & events);
+
+  //!
+  //! Returns the data written by this task. The EventProperties of the analyzed events are written if setEvent is true.
+  //!
+  virtual unsigned int getDataWritten() const;
   
   //!
   //!Create required histograms to be filled at run time.
@@ -97,6 +109,17 @@ protected:
   vector<double> s; //!< array of net strangeness corresponding to the different particle filters operated by this task.
   vector<double> b; //!< array of net baryon number corresponding to the different particle filters operated by this task.
   vector<double> ptSum; //!< array of transverse momentum sums  corresponding to the different particle filters operated by this task.
+  vector<GlobalHistos*> eventFilterHistos; //!< histogram group of each event filter, fetched once per event or block of events.
+
+  //!
+  //! Fetch the histogram group of each event filter.
+  //!
+  void fetchEventFilterHistos();
+
+  //!
+  //! Analyze the given event using the histogram groups fetched by fetchEventFilterHistos().
+  //!
+  void analyzeEvent(Event & event);
 
   ClassDef(GlobalAnalyzer,0)
 };
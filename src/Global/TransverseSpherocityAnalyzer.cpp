@@ -26,6 +26,7 @@ nSteps(360),
 stepSize(CAP::Math::twoPi()/360.0)
 {
   appendClassName("TransverseSpherocityAnalyzer");
+  eventsReadOnly = true;
 }
 
 //!
@@ -151,6 +152,13 @@ void TransverseSpherocityAnalyzer::importHistograms(TFile & inputFile)
     ;
 }
 
+unsigned int TransverseSpherocityAnalyzer::getDataWritten() const
+{
+  unsigned int data = EventTask::getDataWritten();
+  if (setEvent && data!=AllData) data |= getEventStreamsData() & PropertiesData;
+  return data;
+}
+
 void TransverseSpherocityAnalyzer::analyzeEvent()
 {
   static double factor = CAP::Math::pi()*CAP::Math::pi()/4.0;
@@ -168,8 +176,11 @@ void TransverseSpherocityAnalyzer::analyzeEvent()
     if (nParticles<1) continue;
     vector<double> s0Filtered(nParticleFilters,0.0);
     vector<double> s1Filtered(nParticleFilters,0.0);
+    const EventColumns & columns = event.getColumns();
+    selectParticles(event);
     for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
       {
+      const vector<unsigned int> & accepted = particleSelections[iParticleFilter]->indices;
       double  s0 = 1.0E10;
       double  s1 = 1.0E10;
       double  num0, num1, nx, ny, px, py, pt;
@@ -183,14 +194,12 @@ void TransverseSpherocityAnalyzer::analyzeEvent()
         ny = sin(refPhi); // y component of a unitary vector n
         num0 = 0;
         num1 = 0;
-        for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+        for (unsigned int iAccepted=0; iAccepted<accepted.size(); iAccepted++)
           {
-          Particle & particle = * event.getParticleAt(iParticle);
-          if (!particleFilters[iParticleFilter]->accept(particle)) continue;
-          LorentzVector & momentum = particle.getMomentum();
-          pt = momentum.Pt();
-          px = momentum.Px();
-          py = momentum.Py();
+          unsigned int iParticle = accepted[iAccepted];
+          pt = columns.pt[iParticle];
+          px = columns.px[iParticle];
+          py = columns.py[iParticle];
           if (fillS0)
             {
             num0 += TMath::Abs(ny*px - nx*py);
@@ -61,6 +61,11 @@ public:
   //! Execute the spherocity analysis on one event of the incoming event stream. Optionally set the EventProperty of the event for analysis by other tasks.
   //!
   virtual void analyzeEvent();
+
+  //!
+  //! Returns the data written by this task. The EventProperties of the analyzed events are written if setEvent is true.
+  //!
+  virtual unsigned int getDataWritten() const;
   
   //!
   //! Creates the histograms  filled by this task at execution
@@ -20,9 +20,12 @@ NuDynAnalyzer::NuDynAnalyzer(const String & _name,
                              const Configuration & _configuration)
 :
 EventTask(_name, _configuration),
-multiplicityType(1)
+multiplicityType(1),
+singleEvent(1,nullptr),
+filterHistos()
 {
   appendClassName("NuDynAnalyzer");
+  eventsReadOnly = true;
 }
 
 void NuDynAnalyzer::setDefaultConfiguration()
@@ -158,44 +161,60 @@ void NuDynAnalyzer::importHistograms(TFile & inputFile)
 }
 
 void NuDynAnalyzer::analyzeEvent()
+{
+  singleEvent[0] = eventStreams[0];
+  analyzeEvents(singleEvent);
+}
+
+void NuDynAnalyzer::analyzeEvents(const vector<Event*> & events)
+{
+  unsigned int nEventFilters = eventFilters.size();
+  filterHistos.resize(nEventFilters);
+  for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    filterHistos[iEventFilter] = (NuDynHistos *)  histogramManager.getGroup(0,iEventFilter);
+  for (unsigned int iEvent=0; iEvent<events.size(); iEvent++) analyzeEvent(*events[iEvent],filterHistos);
+}
+
+void NuDynAnalyzer::analyzeEvent(Event & event, const vector<NuDynHistos*> & histos)
 {
   unsigned int nEventFilters    = eventFilters.size();
   //unsigned int nParticleFilters = particleFilters.size();
-  Event * event = eventStreams[0];
+  int nBins_rapidity = deltaRapidtyBin.size();
   resetNParticlesAcceptedEvent();
   for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
     {
-    if (!eventFilters[iEventFilter]->accept(*event)) continue;
+    if (!eventFilters[iEventFilter]->accept(event)) continue;
     incrementNEventsAccepted(iEventFilter); // count eventStreams used to fill histograms and for scaling at the end..
 
-    int nBins_rapidity = deltaRapidtyBin.size();
-    vector<double> nAccepted0(nBins_rapidity,0.0);
-    vector<double> nAccepted1(nBins_rapidity,0.0);
+    nAccepted0.assign(nBins_rapidity,0.0);
+    nAccepted1.assign(nBins_rapidity,0.0);
     double rapidity;
-    for (unsigned long  iParticle=0; iParticle<event->getNParticles(); iParticle++)
+    const EventColumns & columns = event.getColumns();
+    const vector<unsigned char> & accepted0 = event.getSelection(*particleFilters[0]).accepted;
+    const vector<unsigned char> & accepted1 = event.getSelection(*particleFilters[1]).accepted;
+    for (unsigned long  iParticle=0; iParticle<event.getNParticles(); iParticle++)
       {
-      Particle & particle = * event->getParticleAt(iParticle);
-      if (particleFilters[0]->accept(particle))
+      if (accepted0[iParticle])
         {
         incrementNParticlesAccepted(iEventFilter,0);
-        rapidity = fabs(particle.getMomentum().Rapidity());
+        rapidity = fabs(columns.y[iParticle]);
         for (int iY=0; iY<nBins_rapidity; iY++)
           {
           if (rapidity<deltaRapidtyBin[iY]) nAccepted0[iY]++;
           }
         }
-      if (particleFilters[1]->accept(particle))
+      if (accepted1[iParticle])
         {
         incrementNParticlesAccepted(iEventFilter,1);
-        rapidity = fabs(particle.getMomentum().Rapidity());
+        rapidity = fabs(columns.y[iParticle]);
         for (int iY=0; iY<nBins_rapidity; iY++)
           {
           if (rapidity<deltaRapidtyBin[iY]) nAccepted1[iY]++;
           }
         }
       }
-    EventProperties ep = * event->getEventProperties();
-    NuDynHistos * nuDynHistos = (NuDynHistos *)  histogramManager.getGroup(0,iEventFilter);
+    EventProperties & ep = * event.getEventProperties();
+    NuDynHistos * nuDynHistos = histos[iEventFilter];
     switch ( multiplicityType )
       {
         case 0: nuDynHistos->fill(ep.fractionalXSection, nAccepted0, nAccepted1, 1.0); break;
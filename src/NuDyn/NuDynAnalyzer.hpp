@@ -19,6 +19,8 @@
 namespace CAP
 {
 
+class NuDynHistos;
+
 
 //!
 //!Task used for the determination of multiplicity moments of second, third, and fourth order. These moments
@@ -68,6 +70,11 @@ public:
   //! Execute this task based on the configuration and class variables specified at construction
   //!
   virtual void analyzeEvent();
+
+  //!
+  //! Analyze a block of events. The histogram groups and the multiplicity arrays are set up once for the whole block.
+  //!
+  virtual void analyzeEvents(const vector<Event*> & events);
   
   //!
   //! Creates the histograms  filled by this task at execution
@@ -92,6 +99,15 @@ protected:
   double max_rapidity;
   double width_rapidity;
   vector<double> deltaRapidtyBin;
+  vector<double> nAccepted0; //!< multiplicities of particle filter 0 in each rapidity range
+  vector<double> nAccepted1; //!< multiplicities of particle filter 1 in each rapidity range
+  vector<Event*> singleEvent;         //!< block holding the current event, reused by analyzeEvent()
+  vector<NuDynHistos*> filterHistos;  //!< histogram group of each event filter, reused by analyzeEvents()
+
+  //!
+  //! Analyze the given event, filling the given histogram groups (one per event filter).
+  //!
+  void analyzeEvent(Event & event, const vector<NuDynHistos*> & histos);
 
 
   ClassDef(NuDynAnalyzer,0)
@@ -33,7 +33,13 @@ h_eventStreams_vsMult(nullptr),
 h_f1_vsMult(),
 h_f2_vsMult(),
 h_f3_vsMult(),
-h_f4_vsMult()
+h_f4_vsMult(),
+b_eventStreams(nullptr),
+b_eventStreams_vsMult(nullptr),
+b_f1(),
+b_f2(),
+b_f3(),
+b_f4()
 {
   appendClassName("NuDynHistos");
 }
@@ -128,6 +134,7 @@ void NuDynHistos::createHistograms()
   h_f4_vsMult.push_back( createProfile(createName(bn,"f4_0111",suffix),nBins_mult,min_mult,max_mult,nBins_rapidity,min_rapidity,max_rapidity,xTitle, yTitle,"f_{4}^{0111}") );
   h_f4_vsMult.push_back( createProfile(createName(bn,"f4_1111",suffix),nBins_mult,min_mult,max_mult,nBins_rapidity,min_rapidity,max_rapidity,xTitle, yTitle,"f_{4}^{1111}") );
 
+  createBuffers();
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -205,15 +212,30 @@ void NuDynHistos::importHistograms(TFile & inputFile)
   h_f4_vsMult.push_back( loadProfile2D(inputFile,createName(bn,"f4_0111",suffix)));
   h_f4_vsMult.push_back( loadProfile2D(inputFile,createName(bn,"f4_1111",suffix)));
 
+  createBuffers();
   if (reportEnd(__FUNCTION__))
     ;
 }
 
+void NuDynHistos::createBuffers()
+{
+  b_eventStreams        = createBuffer(h_eventStreams);
+  b_eventStreams_vsMult = createBuffer(h_eventStreams_vsMult);
+  b_f1.clear();
+  b_f2.clear();
+  b_f3.clear();
+  b_f4.clear();
+  for (auto & h : h_f1_vsMult) b_f1.push_back(createBuffer(h));
+  for (auto & h : h_f2_vsMult) b_f2.push_back(createBuffer(h));
+  for (auto & h : h_f3_vsMult) b_f3.push_back(createBuffer(h));
+  for (auto & h : h_f4_vsMult) b_f4.push_back(createBuffer(h));
+}
+
 
 void NuDynHistos::fill(double mult, vector<double> & nAccepted0, vector<double> & nAccepted1,  double weight __attribute__((unused)))
 {
-  h_eventStreams->Fill(mult);
-  h_eventStreams_vsMult->Fill(mult);
+  b_eventStreams->fill(mult,1.0);
+  b_eventStreams_vsMult->fill(mult,1.0);
   double n1_0, n1_1;
   double n2_00, n2_01, n2_11;
   double n3_000, n3_001, n3_011, n3_111;
@@ -242,23 +264,23 @@ void NuDynHistos::fill(double mult, vector<double> & nAccepted0, vector<double>
     n4_0111  = n1_0 * n1_1 * (n1_1 - 1) * (n1_1 - 2);
     n4_1111  = n1_1 * (n1_1 - 1) * (n1_1 - 2) * (n1_1 - 3);
     deltaY = deltaRapidtyBin[iY];
-    h_f1[0]->Fill(mult,deltaY,n1_0);
-    h_f1[1]->Fill(mult,deltaY,n1_1);
-
-    h_f2[0]->Fill(mult,deltaY,n2_00);
-    h_f2[1]->Fill(mult,deltaY,n2_01);
-    h_f2[2]->Fill(mult,deltaY,n2_11);
-
-    h_f3[0]->Fill(mult,deltaY,n3_000);
-    h_f3[1]->Fill(mult,deltaY,n3_001);
-    h_f3[2]->Fill(mult,deltaY,n3_011);
-    h_f3[3]->Fill(mult,deltaY,n3_111);
-
-    h_f4[0]->Fill(mult,deltaY,n4_0000);
-    h_f4[1]->Fill(mult,deltaY,n4_0001);
-    h_f4[2]->Fill(mult,deltaY,n4_0011);
-    h_f4[3]->Fill(mult,deltaY,n4_0111);
-    h_f4[4]->Fill(mult,deltaY,n4_1111);
+    b_f1[0]->fillProfile(mult,deltaY,n1_0,1.0);
+    b_f1[1]->fillProfile(mult,deltaY,n1_1,1.0);
+
+    b_f2[0]->fillProfile(mult,deltaY,n2_00,1.0);
+    b_f2[1]->fillProfile(mult,deltaY,n2_01,1.0);
+    b_f2[2]->fillProfile(mult,deltaY,n2_11,1.0);
+
+    b_f3[0]->fillProfile(mult,deltaY,n3_000,1.0);
+    b_f3[1]->fillProfile(mult,deltaY,n3_001,1.0);
+    b_f3[2]->fillProfile(mult,deltaY,n3_011,1.0);
+    b_f3[3]->fillProfile(mult,deltaY,n3_111,1.0);
+
+    b_f4[0]->fillProfile(mult,deltaY,n4_0000,1.0);
+    b_f4[1]->fillProfile(mult,deltaY,n4_0001,1.0);
+    b_f4[2]->fillProfile(mult,deltaY,n4_0011,1.0);
+    b_f4[3]->fillProfile(mult,deltaY,n4_0111,1.0);
+    b_f4[4]->fillProfile(mult,deltaY,n4_1111,1.0);
     }
 }
 
@@ -103,7 +103,24 @@ public:
   vector<TProfile2D *> h_f2_vsMult;
   vector<TProfile2D *> h_f3_vsMult;
   vector<TProfile2D *> h_f4_vsMult;
- 
+
+  // accumulation buffers of the event streams and of the vs mult profiles, flushed by HistogramGroup::flush()
+  HistogramBuffer *         b_eventStreams;
+  HistogramBuffer *         b_eventStreams_vsMult;
+  vector<HistogramBuffer *> b_f1;
+  vector<HistogramBuffer *> b_f2;
+  vector<HistogramBuffer *> b_f3;
+  vector<HistogramBuffer *> b_f4;
+
+protected:
+
+  //!
+  //! Create the accumulation buffers of the histograms of this group.
+  //!
+  void createBuffers();
+
+public:
+
   ClassDef(NuDynHistos,0)
 };
 
@@ -16,12 +16,18 @@
 #include "TH2.h"
 #include <string>
 #include <stdio.h>
+#include <mutex>
 #include "BalanceFunctionCalculator.hpp"
 using CAP::createName;
 using CAP::BalanceFunctionCalculator;
 
 ClassImp(BalanceFunctionCalculator)
 
+namespace
+{
+std::mutex countersMutex;
+}
+
 
 BalanceFunctionCalculator::BalanceFunctionCalculator(const TString & _name,
                                                      const Configuration & _configuration)
@@ -34,7 +40,9 @@ appendedString("BalFct"),
 calculateCI(1),
 calculateCD(1),
 calculateBF(1),
-calculateDiffs(0)
+calculateDiffs(0),
+maxConcurrentFiles(1),
+filePool()
 {
   appendClassName("BalanceFunctionCalculator");
 }
@@ -52,6 +60,7 @@ void BalanceFunctionCalculator::setDefaultConfiguration()
   addParameter("calculateCD",            true);
   addParameter("calculateBF",          true);
   addParameter("calculateDiffs",         false);
+  addParameter("maxConcurrentFiles",     int(1));
   addParameter("FillEta",                true);
   addParameter("FillY",                  false);
   addParameter("FillP2",                 false);
@@ -406,6 +415,7 @@ void BalanceFunctionCalculator::configure()
   calculateCD         = getValueBool("calculateCD" );
   calculateBF         = getValueBool("calculateBF" );
   calculateDiffs      = getValueBool("calculateDiffs" );
+  maxConcurrentFiles  = getValueInt( "maxConcurrentFiles");
 
   if (reportInfo(__FUNCTION__))
     {
@@ -421,6 +431,7 @@ void BalanceFunctionCalculator::configure()
     printItem("calculateCD",           calculateCD);
     printItem("calculateBF",           calculateBF);
     printItem("calculateDiffs",        calculateDiffs);
+    printItem("maxConcurrentFiles",    maxConcurrentFiles);
     cout << endl;
     }
 }
@@ -513,158 +524,172 @@ void BalanceFunctionCalculator::execute()
     cout << endl;
     }
 
-  for (int iFile =0; iFile<nFilesToAnalyze; iFile++)
+  filePool.setMaxConcurrentFiles(maxConcurrentFiles);
+  filePool.run(allFilesToAnalyze,maxConcurrentFiles,[&](unsigned int iWorker __attribute__((unused)), unsigned int iFile)
     {
-    histosImportFile  = allFilesToAnalyze[iFile];
-    histosExportFile  = removeRootExtension(histosImportFile);
-    histosExportFile.ReplaceAll(TString("Derived"),appendedString);
-    TFile & inputFile = *openRootFile("",histosImportFile,"OLD");
-    String option = "NEW";
-    if (histosForceRewrite) option = "RECREATE";
-    TFile & outputFile = *openRootFile("",histosExportFile,option);
-    if (reportInfo(__FUNCTION__))
-      {
-      cout << endl;
-      printItem("From",histosImportFile);
-      printItem("Saved to",histosExportFile);
-      }
+    processFile(allFilesToAnalyze[iFile]);
+    });
+  if (reportInfo(__FUNCTION__)) filePool.printReport(cout);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
 
-    // Use histogramGroup  as helper to load and calculate histograms, etc.
-    HistogramGroup * histogramGroup  = new HistogramGroup(this,getName(), configuration);
-    histogramGroup ->setOwnership(false);
-    loadNEexecutedTask(inputFile);
-    loadNEventsAccepted(inputFile);
-
-    unsigned int nSpecies = particleFilters.size()/2;
-    vector<TString>  sObservableNames;
-    vector<TString>  pObservableNames;
-    int observableSelection = 5;
-    switch (observableSelection)
-      {
-        default:
-        case 0: // eta based observables, full complement
-        sObservableNames.push_back("n1_eta");
-        sObservableNames.push_back("n1_phi");
-        pObservableNames.push_back("R2_ptpt");
-        pObservableNames.push_back("R2_phiPhi");
-        pObservableNames.push_back("R2_etaEta");
-        pObservableNames.push_back("R2_DetaDphi_shft");
-        break;
-
-        case 1: // eta based observables, only DeltaEta vs DeltaPhi
-        sObservableNames.push_back("n1_eta");
-        sObservableNames.push_back("n1_phi");
-        pObservableNames.push_back("rho2_DetaDphi_shft");
-        break;
-
-        case 2: // y based observables, full complement
-        sObservableNames.push_back("n1_y");
-        sObservableNames.push_back("n1_phi");
-        pObservableNames.push_back("R2_ptpt");
-        pObservableNames.push_back("R2_phiPhi");
-        pObservableNames.push_back("R2_yY");
-        pObservableNames.push_back("R2_DyDphi_shft");
-        break;
-
-        case 3: // y based observables, only DeltaY vs DeltaPhi
-        sObservableNames.push_back("n1_y");
-        sObservableNames.push_back("n1_phi");
-        pObservableNames.push_back("R2_DyDphi_shft");
-        break;
-
-        case 4: // eta based observables, only DeltaEta vs DeltaPhi
-        sObservableNames.push_back("n1_eta");
-        sObservableNames.push_back("n1_phi");
-        pObservableNames.push_back("rho2_DetaDphi_shft");
-        pObservableNames.push_back("R2_DetaDphi_shft");
-        //pObservableNames.push_back("B2AB_DetaDphi_shft");
-        //pObservableNames.push_back("B2BA_DetaDphi_shft");
-        //        pObservableNames.push_back("n2_phiPhi");
-        break;
-
-        case 5: // y based observables
-        sObservableNames.push_back("n1_y");
-        sObservableNames.push_back("n1_phi");
-        pObservableNames.push_back("A2_DyDphi_shft");
-        pObservableNames.push_back("B2_DyDphi_shft");
-        pObservableNames.push_back("C2_DyDphi_shft");
-        pObservableNames.push_back("D2_DyDphi_shft");
-        pObservableNames.push_back("R2_DyDphi_shft");
-        pObservableNames.push_back("B2_yY");
-        //pObservableNames.push_back("B2_phiPhi");
-        break;
-      }
+//!
+//! Compute the balance functions of the given input file and save them in the output file whose name is derived from it. Files are
+//! independent of one another and may be processed concurrently.
+//!
+void BalanceFunctionCalculator::processFile(const String & importFile)
+{
+  String exportFile = removeRootExtension(importFile);
+  exportFile.ReplaceAll(TString("Derived"),appendedString);
+  TFile & inputFile = *openRootFile("",importFile,"OLD");
+  String option = "NEW";
+  if (histosForceRewrite) option = "RECREATE";
+  TFile & outputFile = *openRootFile("",exportFile,option);
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("From",importFile);
+    printItem("Saved to",exportFile);
+    }
 
+  // Use histogramGroup  as helper to load and calculate histograms, etc.
+  HistogramGroup * histogramGroup  = new HistogramGroup(this,getName(), configuration);
+  histogramGroup ->setOwnership(false);
 
-    if (reportInfo(__FUNCTION__))
+  unsigned int nSpecies = particleFilters.size()/2;
+  vector<TString>  sObservableNames;
+  vector<TString>  pObservableNames;
+  int observableSelection = 5;
+  switch (observableSelection)
+    {
+      default:
+      case 0: // eta based observables, full complement
+      sObservableNames.push_back("n1_eta");
+      sObservableNames.push_back("n1_phi");
+      pObservableNames.push_back("R2_ptpt");
+      pObservableNames.push_back("R2_phiPhi");
+      pObservableNames.push_back("R2_etaEta");
+      pObservableNames.push_back("R2_DetaDphi_shft");
+      break;
+
+      case 1: // eta based observables, only DeltaEta vs DeltaPhi
+      sObservableNames.push_back("n1_eta");
+      sObservableNames.push_back("n1_phi");
+      pObservableNames.push_back("rho2_DetaDphi_shft");
+      break;
+
+      case 2: // y based observables, full complement
+      sObservableNames.push_back("n1_y");
+      sObservableNames.push_back("n1_phi");
+      pObservableNames.push_back("R2_ptpt");
+      pObservableNames.push_back("R2_phiPhi");
+      pObservableNames.push_back("R2_yY");
+      pObservableNames.push_back("R2_DyDphi_shft");
+      break;
+
+      case 3: // y based observables, only DeltaY vs DeltaPhi
+      sObservableNames.push_back("n1_y");
+      sObservableNames.push_back("n1_phi");
+      pObservableNames.push_back("R2_DyDphi_shft");
+      break;
+
+      case 4: // eta based observables, only DeltaEta vs DeltaPhi
+      sObservableNames.push_back("n1_eta");
+      sObservableNames.push_back("n1_phi");
+      pObservableNames.push_back("rho2_DetaDphi_shft");
+      pObservableNames.push_back("R2_DetaDphi_shft");
+      //pObservableNames.push_back("B2AB_DetaDphi_shft");
+      //pObservableNames.push_back("B2BA_DetaDphi_shft");
+      //        pObservableNames.push_back("n2_phiPhi");
+      break;
+
+      case 5: // y based observables
+      sObservableNames.push_back("n1_y");
+      sObservableNames.push_back("n1_phi");
+      pObservableNames.push_back("A2_DyDphi_shft");
+      pObservableNames.push_back("B2_DyDphi_shft");
+      pObservableNames.push_back("C2_DyDphi_shft");
+      pObservableNames.push_back("D2_DyDphi_shft");
+      pObservableNames.push_back("R2_DyDphi_shft");
+      pObservableNames.push_back("B2_yY");
+      //pObservableNames.push_back("B2_phiPhi");
+      break;
+    }
+
+
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("nSpecies",nSpecies);
+    for (unsigned int iPart1=0; iPart1<nSpecies; iPart1++)
       {
-      cout << endl;
-      printItem("nSpecies",nSpecies);
-      for (unsigned int iPart1=0; iPart1<nSpecies; iPart1++)
-        {
-        cout << "iPart1:" <<  iPart1 << "  named: "<< particleFilters[iPart1]->getName() << endl;
-        }
-      printItem("sObservableNames.size()",int(sObservableNames.size()));
-      for (unsigned int k=0; k<sObservableNames.size(); k++)
-        printItem("   ",sObservableNames[k]);
-      printItem("pObservableNames.size()",int(pObservableNames.size()));
-      for (unsigned int k=0; k<pObservableNames.size(); k++)
-        printItem("   ",pObservableNames[k]);
+      cout << "iPart1:" <<  iPart1 << "  named: "<< particleFilters[iPart1]->getName() << endl;
       }
-     for (unsigned int iObservable = 0; iObservable<pObservableNames.size();iObservable++)
+    printItem("sObservableNames.size()",int(sObservableNames.size()));
+    for (unsigned int k=0; k<sObservableNames.size(); k++)
+      printItem("   ",sObservableNames[k]);
+    printItem("pObservableNames.size()",int(pObservableNames.size()));
+    for (unsigned int k=0; k<pObservableNames.size(); k++)
+      printItem("   ",pObservableNames[k]);
+    }
+   for (unsigned int iObservable = 0; iObservable<pObservableNames.size();iObservable++)
+    {
+    for (unsigned int iPart1=0; iPart1<nSpecies; iPart1++)
       {
-      for (unsigned int iPart1=0; iPart1<nSpecies; iPart1++)
+      for (unsigned int iPart2=0; iPart2<nSpecies; iPart2++)
         {
-        for (unsigned int iPart2=0; iPart2<nSpecies; iPart2++)
+        for (unsigned int iEventClass = 0; iEventClass<eventFilters.size();iEventClass++)
           {
-          for (unsigned int iEventClass = 0; iEventClass<eventFilters.size();iEventClass++)
+          // load histogram and compute derived files.
+          TString eventClassName   = eventFilters[iEventClass]->getName();
+          TString particleName1    = particleFilters[iPart1]->getName();
+          TString particleName1Bar = particleFilters[iPart1+nSpecies]->getName();
+          TString particleName2    = particleFilters[iPart2]->getName();
+          TString particleName2Bar = particleFilters[iPart2+nSpecies]->getName();
+          TH1 * rho1_1             = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName1,   sObservableNames[0]));
+          TH1 * rho1_1Bar          = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName1Bar,sObservableNames[0]));
+          TH1 * rho1_2             = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName2,   sObservableNames[0]));
+          TH1 * rho1_2Bar          = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName2Bar,sObservableNames[0]));
+          TH2 * obs_1_2            = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1,    particleName2,    pObservableNames[iObservable]));
+          TH2 * obs_1Bar_2         = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1Bar, particleName2,    pObservableNames[iObservable]));
+          TH2 * obs_1_2Bar         = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1,    particleName2Bar, pObservableNames[iObservable]));
+          TH2 * obs_1Bar_2Bar      = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1Bar, particleName2Bar, pObservableNames[iObservable]));
+
+          if (calculateCI)
+            calculate_CI(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable],obs_1_2,obs_1Bar_2,obs_1_2Bar,obs_1Bar_2Bar,histogramGroup );
+
+          if (calculateCD)
+            calculate_CD(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable],obs_1_2,obs_1Bar_2,obs_1_2Bar,obs_1Bar_2Bar,histogramGroup );
+
+          if (calculateBF)
             {
-            // load histogram and compute derived files.
-            TString eventClassName   = eventFilters[iEventClass]->getName();
-            TString particleName1    = particleFilters[iPart1]->getName();
-            TString particleName1Bar = particleFilters[iPart1+nSpecies]->getName();
-            TString particleName2    = particleFilters[iPart2]->getName();
-            TString particleName2Bar = particleFilters[iPart2+nSpecies]->getName();
-            TH1 * rho1_1             = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName1,   sObservableNames[0]));
-            TH1 * rho1_1Bar          = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName1Bar,sObservableNames[0]));
-            TH1 * rho1_2             = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName2,   sObservableNames[0]));
-            TH1 * rho1_2Bar          = histogramGroup ->loadH1(inputFile,createName(getName(),eventClassName,particleName2Bar,sObservableNames[0]));
-            TH2 * obs_1_2            = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1,    particleName2,    pObservableNames[iObservable]));
-            TH2 * obs_1Bar_2         = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1Bar, particleName2,    pObservableNames[iObservable]));
-            TH2 * obs_1_2Bar         = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1,    particleName2Bar, pObservableNames[iObservable]));
-            TH2 * obs_1Bar_2Bar      = histogramGroup ->loadH2(inputFile,createName(getName(),eventClassName,particleName1Bar, particleName2Bar, pObservableNames[iObservable]));
-
-            if (calculateCI)
-              calculate_CI(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable],obs_1_2,obs_1Bar_2,obs_1_2Bar,obs_1Bar_2Bar,histogramGroup );
-
-            if (calculateCD)
-              calculate_CD(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable],obs_1_2,obs_1Bar_2,obs_1_2Bar,obs_1Bar_2Bar,histogramGroup );
-
-            if (calculateBF)
-              {
-              TH2* bfa = calculate_BalFct(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "B2_1_2Bar",rho1_2Bar, obs_1_2Bar, obs_1Bar_2Bar,histogramGroup );
-              TH2* bfb = calculate_BalFct(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "B2_1Bar_2",rho1_2,    obs_1Bar_2, obs_1_2,histogramGroup );
-              calculate_BalFctSum(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "B2_12Sum",bfa,bfb,histogramGroup );
-              }
-            if (calculateDiffs)
-              {
-              calculate_Diff(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "Diff_US",   obs_1Bar_2,    obs_1_2Bar,histogramGroup );
-              calculate_Diff(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "Diff_LS",   obs_1Bar_2Bar, obs_1_2,histogramGroup );
-              }
+            TH2* bfa = calculate_BalFct(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "B2_1_2Bar",rho1_2Bar, obs_1_2Bar, obs_1Bar_2Bar,histogramGroup );
+            TH2* bfb = calculate_BalFct(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "B2_1Bar_2",rho1_2,    obs_1Bar_2, obs_1_2,histogramGroup );
+            calculate_BalFctSum(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "B2_12Sum",bfa,bfb,histogramGroup );
+            }
+          if (calculateDiffs)
+            {
+            calculate_Diff(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "Diff_US",   obs_1Bar_2,    obs_1_2Bar,histogramGroup );
+            calculate_Diff(getName(),eventClassName,particleName1,particleName2, pObservableNames[iObservable], "Diff_LS",   obs_1Bar_2Bar, obs_1_2,histogramGroup );
             }
           }
         }
       }
-    outputFile.cd();
-    histogramGroup->exportHistograms(outputFile);
-    writeNEventsAccepted(outputFile);
-    writeNEexecutedTask(outputFile);
-
-    inputFile.Close();
-    outputFile.Close();
-    histogramGroup->clear();
-    delete histogramGroup ;
     }
-  if (reportEnd(__FUNCTION__))
-    ;
+  outputFile.cd();
+  histogramGroup->exportHistograms(outputFile);
+  {
+  // the event counters are copied from input to output through the (shared) members of this task
+  std::lock_guard<std::mutex> lock(countersMutex);
+  loadNEexecutedTask(inputFile);
+  loadNEventsAccepted(inputFile);
+  writeNEventsAccepted(outputFile);
+  writeNEexecutedTask(outputFile);
+  }
+
+  inputFile.Close();
+  outputFile.Close();
+  histogramGroup->clear();
+  delete histogramGroup ;
 }
@@ -12,6 +12,7 @@
 #ifndef CAP__BalanceFunctionCalculator
 #define CAP__BalanceFunctionCalculator
 #include "EventTask.hpp"
+#include "FileTaskPool.hpp"
 
 
 namespace CAP
@@ -207,6 +208,11 @@ public:
                               HistogramGroup * histogramGroup);
 
 
+  //!
+  //! Compute the balance functions of the given input file and export them. Called concurrently for up to maxConcurrentFiles files.
+  //!
+  virtual void processFile(const String & importFile);
+
 protected:
   
   //!
@@ -226,6 +232,8 @@ protected:
   bool calculateCD;
   bool calculateBF;
   bool calculateDiffs;
+  int  maxConcurrentFiles;
+  FileTaskPool filePool; //!
 
   ClassDef(BalanceFunctionCalculator,0)
 };
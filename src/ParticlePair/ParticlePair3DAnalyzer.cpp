@@ -23,6 +23,7 @@ fillY(false),
 fillP2(false)
 {
   appendClassName("ParticlePair3DAnalyzer");
+  eventsReadOnly = true;
   for (unsigned int k=0; k<particleFilters.size(); k++)
     {
     vector<ParticleDigit*> list;
@@ -23,12 +23,29 @@ ParticlePairAnalyzer::ParticlePairAnalyzer(const String & _name,
 EventTask(_name, _configuration),
 fillEta(true),
 fillY(false),
-fillP2(false)
+fillP2(false),
+nPairThreads(1),
+pairThreadsMinPairs(1000000),
+parallelFiller(nullptr),
+mixingDepth(0),
+mixingObservable(11),
+mixingObservableIndex(0),
+nBins_mixing(1),
+min_mixing(0.0),
+max_mixing(1.0),
+mixingPool(),
+nMixedEvents()
 {
   appendClassName("ParticlePairAnalyzer");
+  eventsReadOnly = true;
 
 }
 
+ParticlePairAnalyzer::~ParticlePairAnalyzer()
+{
+  delete parallelFiller;
+}
+
 void ParticlePairAnalyzer::setDefaultConfiguration()
 {
   EventTask::setDefaultConfiguration();
@@ -85,6 +102,14 @@ void ParticlePairAnalyzer::setDefaultConfiguration()
   addParameter("Min_DeltaP",   -4.0);
   addParameter("Max_DeltaP",    4.0);
   addParameter("binCorrPP",     1.0);
+  addParameter("nPairThreads",        nPairThreads);
+  addParameter("PairThreadsMinPairs", pairThreadsMinPairs);
+  addParameter("MixingDepth",           mixingDepth);
+  addParameter("MixingObservable",      mixingObservable);
+  addParameter("MixingObservableIndex", mixingObservableIndex);
+  addParameter("nBins_mixing",          nBins_mixing);
+  addParameter("Min_mixing",            min_mixing);
+  addParameter("Max_mixing",            max_mixing);
 }
 
 void ParticlePairAnalyzer::configure()
@@ -93,6 +118,15 @@ void ParticlePairAnalyzer::configure()
   fillEta = getValueBool("FillEta");
   fillY   = getValueBool("FillY");
   fillP2  = getValueBool("FillP2");
+  nPairThreads        = getValueInt("nPairThreads");
+  pairThreadsMinPairs = getValueLong("PairThreadsMinPairs");
+  mixingDepth           = getValueInt("MixingDepth");
+  mixingObservable      = getValueInt("MixingObservable");
+  mixingObservableIndex = getValueInt("MixingObservableIndex");
+  nBins_mixing          = getValueInt("nBins_mixing");
+  min_mixing            = getValueDouble("Min_mixing");
+  max_mixing            = getValueDouble("Max_mixing");
+  if (nBins_mixing<1) nBins_mixing = 1;
 
 
   if (reportInfo(__FUNCTION__))
@@ -108,6 +142,9 @@ void ParticlePairAnalyzer::configure()
     printItem("FillEta",fillEta);
     printItem("FillY",fillY);
     printItem("FillP2",fillP2);
+    printItem("nPairThreads",nPairThreads);
+    printItem("PairThreadsMinPairs",pairThreadsMinPairs);
+    printItem("MixingDepth",mixingDepth);
     printItem("nBins_n1");
     printItem("Min_n1");
     printItem("Max_n1");
@@ -164,6 +201,9 @@ void ParticlePairAnalyzer::initialize()
     vector<ParticleDigit*> list;
     filteredParticles.push_back(list);
     }
+  if (nPairThreads>1 && !parallelFiller) parallelFiller = new ParticlePairParallelFiller(nPairThreads);
+  mixingPool.initialize(mixingDepth>0 ? nEventFilters*nBins_mixing : 0, mixingDepth>0 ? mixingDepth : 0, nParticleFilters);
+  nMixedEvents.assign(nEventFilters,0);
 }
 
 void ParticlePairAnalyzer::initializeHistogramManager()
@@ -172,6 +212,7 @@ void ParticlePairAnalyzer::initializeHistogramManager()
   histogramManager.addSet("pair");
   histogramManager.addSet("singleDerived");
   histogramManager.addSet("pairDerived");
+  histogramManager.addSet("pairMixed");
 }
 
 
@@ -191,6 +232,9 @@ void ParticlePairAnalyzer::createHistograms()
     printItem("FillEta",fillEta);
     printItem("FillY",fillY);
     printItem("FillP2",fillP2);
+    printItem("nPairThreads",nPairThreads);
+    printItem("PairThreadsMinPairs",pairThreadsMinPairs);
+    printItem("MixingDepth",mixingDepth);
     cout << endl;
     }
 
@@ -220,6 +264,22 @@ void ParticlePairAnalyzer::createHistograms()
         histogramManager.addGroupInSet(1,histos);
         }
       }
+
+    // mixed event pairs
+    if (mixingDepth>0)
+      {
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          histos = new ParticlePairHistos(this,createName(bn,"Mixed",efn,pfn1,pfn2),configuration);
+          histos->createHistograms();
+          histogramManager.addGroupInSet(4,histos);
+          }
+        }
+      }
     }
   if (reportEnd(__FUNCTION__))
     ;
@@ -235,6 +295,15 @@ void ParticlePairAnalyzer::importHistograms(TFile & inputFile)
   fillEta = getValueBool("FillEta");
   fillY   = getValueBool("FillY");
   fillP2  = getValueBool("FillP2");
+  nPairThreads        = getValueInt("nPairThreads");
+  pairThreadsMinPairs = getValueLong("PairThreadsMinPairs");
+  mixingDepth           = getValueInt("MixingDepth");
+  mixingObservable      = getValueInt("MixingObservable");
+  mixingObservableIndex = getValueInt("MixingObservableIndex");
+  nBins_mixing          = getValueInt("nBins_mixing");
+  min_mixing            = getValueDouble("Min_mixing");
+  max_mixing            = getValueDouble("Max_mixing");
+  if (nBins_mixing<1) nBins_mixing = 1;
 
   if (reportInfo(__FUNCTION__))
     {
@@ -245,6 +314,9 @@ void ParticlePairAnalyzer::importHistograms(TFile & inputFile)
     printItem("FillEta",fillEta);
     printItem("FillY",fillY);
     printItem("FillP2",fillP2);
+    printItem("nPairThreads",nPairThreads);
+    printItem("PairThreadsMinPairs",pairThreadsMinPairs);
+    printItem("MixingDepth",mixingDepth);
     cout << endl;
     }
   for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
@@ -273,6 +345,22 @@ void ParticlePairAnalyzer::importHistograms(TFile & inputFile)
         histogramManager.addGroupInSet(1,histos);
         }
       }
+
+    // mixed event pairs
+    if (mixingDepth>0)
+      {
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          histos = new ParticlePairHistos(this,createName(bn,"Mixed",efn,pfn1,pfn2),configuration);
+          histos->importHistograms(inputFile);
+          histogramManager.addGroupInSet(4,histos);
+          }
+        }
+      }
     }
   if (reportEnd(__FUNCTION__))
     ;
@@ -284,163 +372,144 @@ void ParticlePairAnalyzer::analyzeEvent()
   Event & event = *eventStreams[0];
   vector<Particle*> & particles = event.getParticles();
   unsigned int nParticles = particles.size();
-  if (false)
+  bool digitized = false;
+  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
     {
-    //Is this event accepted by this task's event filters?
-    bool analyzeThisEvent = false;
-    unsigned int nEventFilters = eventFilters.size();
-    vector<unsigned int> eventFilterPassed;
-    eventFilterPassed.clear();
-    resetNParticlesAcceptedEvent();
-    for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    if (!eventFilters[iEventFilter]->accept(event)) continue;
+    incrementNEventsAccepted(iEventFilter);
+    // particles are filtered and digitized once per event, not once per event filter or per pair
+    if (!digitized)
       {
-      if (!eventFilters[iEventFilter]->accept(event)) continue;
-      incrementNEventsAccepted(iEventFilter);
-      eventFilterPassed.push_back(iEventFilter);
-      analyzeThisEvent = true;
+      digitizeParticles(event);
+      digitized = true;
       }
-    //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 2 --" << endl;
-    if (!analyzeThisEvent) return;
-    if (nParticles<2) return;
-
-    // in this branch we pixelize before filling histograms...
-    Factory<ParticleDigit> * factory = ParticleDigit::getFactory();
-    factory->reset();
-
-    //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 4 --" << endl;
-
-    // produce sublists with ParticleDigits so we do not have to digitize too many
-    // times..
-    // The histo instance fetched here is used for digitization only. So
-    // we use instance [0];
-    ParticlePairHistos * histos = (ParticlePairHistos *) histogramManager.getGroup(0,0);
-    unsigned int nParticleFilters = particleFilters.size();
-    for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ ) filteredParticles[iParticleFilter].clear();
+    unsigned int  baseSingle   = iEventFilter*nParticleFilters;
+    unsigned int  basePair     = iEventFilter*nParticleFilters*nParticleFilters;
+    unsigned int  index;
     for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
       {
-      Particle & particle = * (particles[iParticle]);
-      float pt, e, phi;
-      int iPt, iPhi, iEta, iY;
-      ParticleDigit * pd;
-      bool digitized = false;
-      for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
-        {
-        if (particleFilters[iParticleFilter]->accept(particle))
-          {
-          if (!digitized)
-            {
-            LorentzVector & momentum = particle.getMomentum();
-            pt        = momentum.Pt();
-            e         = momentum.E();
-            phi       = momentum.Phi();
-            if (phi<0.0) phi += CAP::Math::twoPi();
-            iPt       = histos->getPtBinFor(pt);
-            if (iPt==0) continue;
-            iPhi      = histos->getPhiBinFor(phi);
-            if (iPhi==0) continue;
-            iEta = fillEta ? histos->getEtaBinFor(momentum.Eta())    : 0;
-            iY   = fillY   ? histos->getYBinFor(momentum.Rapidity()) : 0;
-            if (iEta==0 && iY==0) continue;
-            pd        = factory->getNextObject();
-            pd->iY    = iY;
-            pd->iEta  = iEta;
-            pd->iPt   = iPt;
-            pd->iPhi  = iPhi;
-            pd->pt    = pt;
-            pd->e     = e;
-            digitized = true; // so no need to digitize this particle again..
-            }
-          filteredParticles[iParticleFilter].push_back(pd);
-          //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 7 --" << endl;
-          } // particle accepted by filter
-        } //particle loop
-      } // particle filter loop
-    //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 8 --" << endl;
-    // use the filtered particles to fill the histos for the accepted event filters
-    for (unsigned int jEventFilter=0; jEventFilter<eventFilterPassed.size(); jEventFilter++ )
+      int iParticleFilter = firstParticleFilter[iParticle];
+      if (iParticleFilter<0) continue;
+      // single particle histograms are filled for the first filter accepting the particle (mutually exclusive filters)
+      incrementNParticlesAccepted(iEventFilter,iParticleFilter);
+      index = baseSingle + iParticleFilter;
+      ParticleSingleHistos * histos = (ParticleSingleHistos *)  histogramManager.getGroup(0,index);
+      histos->fill(*particles[iParticle],1.0);
+      }
+    for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
       {
-      //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 9 --" << endl;
-      unsigned int  iEventFilter = eventFilterPassed[jEventFilter];
-      unsigned int  baseSingle   = iEventFilter*nParticleFilters;
-      unsigned int  basePair     = iEventFilter*nParticleFilters*nParticleFilters;
-      unsigned int  index;
-      for (unsigned int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+      for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
         {
-        incrementNParticlesAccepted(iEventFilter,iParticleFilter1);
-        //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 10 --" << endl;
-        index = baseSingle + iParticleFilter1;
-        ParticleSingleHistos * histos = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
-        histos->fill(filteredParticles[iParticleFilter1],1.0);
-        for (unsigned int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
-          {
-          //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 11 --" << endl;
-          index = basePair + iParticleFilter1*nParticleFilters + iParticleFilter2;
-          ParticlePairHistos * histos = (ParticlePairHistos *)  histogramManager.getGroup(1,index);
-          histos->fill(filteredParticles[iParticleFilter1],filteredParticles[iParticleFilter2],iParticleFilter1==iParticleFilter2,1.0);
-          //if (reportInfo("ParticlePairAnalyzer",getName(),"HistogramsCreate()")) cout << " -- 13 --" << endl;
-          }
+        index = basePair + iParticleFilter1*nParticleFilters + iParticleFilter2;
+        ParticlePairHistos * histos = (ParticlePairHistos *)  histogramManager.getGroup(1,index);
+        const ParticleDigitColumns & columns1 = filteredColumns[iParticleFilter1];
+        const ParticleDigitColumns & columns2 = filteredColumns[iParticleFilter2];
+        bool same = iParticleFilter1==iParticleFilter2;
+        long n1 = columns1.size();
+        long nPairs = same ? n1*(n1-1)/2 : n1*long(columns2.size());
+        if (parallelFiller && nPairs>=pairThreadsMinPairs)
+          parallelFiller->fill(*histos,columns1,columns2,same,1.0);
+        else
+          histos->fill(columns1,columns2,same,1.0);
         }
       }
+    if (mixingDepth>0) mixEvent(event,iEventFilter);
     }
-  else
+}
+
+int ParticlePairAnalyzer::getMixingClass(Event & event, int iEventFilter)
+{
+  if (nBins_mixing<=1) return iEventFilter;
+  EventProperties * eventProperties = event.getEventProperties();
+  if (!eventProperties) throw TaskException("Event does NOT have properties","ParticlePairAnalyzer::getMixingClass()");
+  double value = EventFilter::getObservable(*eventProperties,mixingObservable,mixingObservableIndex);
+  if (value<min_mixing || value>=max_mixing) return -1;
+  int iBin = int(double(nBins_mixing)*(value-min_mixing)/(max_mixing-min_mixing));
+  if (iBin>=nBins_mixing) iBin = nBins_mixing-1;
+  return iEventFilter*nBins_mixing + iBin;
+}
+
+void ParticlePairAnalyzer::mixEvent(Event & event, int iEventFilter)
+{
+  int iClass = getMixingClass(event,iEventFilter);
+  if (iClass<0) return;
+  unsigned int basePair = iEventFilter*nParticleFilters*nParticleFilters;
+  unsigned int nEvents  = mixingPool.getNEvents(iClass);
+  for (unsigned int iEvent=0; iEvent<nEvents; iEvent++)
     {
-    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    const vector<ParticleDigitColumns> & mixedColumns = mixingPool.getEvent(iClass,iEvent);
+    for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
       {
-      if (!eventFilters[iEventFilter]->accept(event)) continue;
-      incrementNEventsAccepted(iEventFilter);
-      unsigned int  baseSingle   = iEventFilter*nParticleFilters;
-      unsigned int  basePair     = iEventFilter*nParticleFilters*nParticleFilters;
-      unsigned int  index;
-      for (unsigned int iParticle1=0; iParticle1<nParticles; iParticle1++)
+      for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
         {
-        Particle & particle1 = *(particles[iParticle1]);
-        //bool accepted = false;
-        for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
-          {
+        unsigned int index = basePair + iParticleFilter1*nParticleFilters + iParticleFilter2;
+        ParticlePairHistos * histos = (ParticlePairHistos *)  histogramManager.getGroup(4,index);
+        const ParticleDigitColumns & columns1 = filteredColumns[iParticleFilter1];
+        const ParticleDigitColumns & columns2 = mixedColumns[iParticleFilter2];
+        if (parallelFiller && long(columns1.size())*long(columns2.size())>=pairThreadsMinPairs)
+          parallelFiller->fill(*histos,columns1,columns2,false,1.0,true);
+        else
+          histos->fillMixed(columns1,columns2,1.0);
+        }
+      }
+    nMixedEvents[iEventFilter]++;
+    }
+  mixingPool.add(iClass,filteredColumns);
+}
 
-          if (particleFilters[iParticleFilter1]->accept(particle1))
-            {
-            //cout << " ACCEPTED" << endl;
-            incrementNParticlesAccepted(iEventFilter,iParticleFilter1);
-            index = baseSingle + iParticleFilter1;
-            ParticleSingleHistos * histos = (ParticleSingleHistos *)  histogramManager.getGroup(0,index);
-            histos->fill(particle1,1.0);
-            //accepted = true;
-            break; // mutually exclusive tests...
-            }
-          }
-//        cout << "Accepted:" << accepted << endl;
-//        LorentzVector & momentum1 = particle1.getMomentum();
-//        double pt1   = momentum1.Pt();
-//        //double e1    = momentum1.E();
-//        double phi1  = momentum1.Phi();
-//        double eta1  = momentum1.Eta();
-//        double y1    = momentum1.Rapidity();
-//        cout << "particle code: " << particle1.getType().getPdgCode() << " name: " << particle1.getType().getName() << "  y1: " << y1 << "  phi1: " << phi1 << " pt1: " << pt1 << endl;
-//        cout << endl;
-//        continue; // ZZZZZZZ
-        for (unsigned int iParticle2=0; iParticle2<nParticles; iParticle2++)
+void ParticlePairAnalyzer::digitizeParticles(Event & event)
+{
+  Factory<ParticleDigit> * factory = ParticleDigit::getFactory();
+  factory->reset();
+  // All pair histograms share the same binning: instance [0] is used for digitization only.
+  ParticlePairHistos * histos = (ParticlePairHistos *) histogramManager.getGroup(1,0);
+  const EventColumns & columns = event.getColumns();
+  selectParticles(event);
+  unsigned int nParticles = columns.size();
+  firstParticleFilter.assign(nParticles,-1);
+  filteredColumns.resize(nParticleFilters);
+  for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+    {
+    filteredParticles[iParticleFilter].clear();
+    filteredColumns[iParticleFilter].clear();
+    }
+  for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+    {
+    ParticleDigit * pd = nullptr;
+    bool digitized = false;
+    for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      {
+      if (!particleSelections[iParticleFilter]->accepted[iParticle]) continue;
+      if (firstParticleFilter[iParticle]<0) firstParticleFilter[iParticle] = iParticleFilter;
+      if (!digitized)
+        {
+        // particles outside the pt, phi, and eta/y ranges of the histograms are not paired
+        int iPt  = histos->getPtBinFor(columns.pt[iParticle]);
+        int iPhi = histos->getPhiBinFor(columns.phi[iParticle]);
+        int iEta = fillEta ? histos->getEtaBinFor(columns.eta[iParticle]) : 0;
+        int iY   = fillY   ? histos->getYBinFor(columns.y[iParticle])     : 0;
+        if (iPt>0 && iPhi>0 && (iEta>0 || iY>0))
           {
-          if (iParticle1==iParticle2) continue;
-          Particle & particle2 = *(particles[iParticle2]);
-          for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
-            {
-            bool accept1 = particleFilters[iParticleFilter1]->accept(particle1);
-            for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
-              {
-              bool accept2 = particleFilters[iParticleFilter2]->accept(particle2);
-              if (accept1 & accept2)
-                {
-                index = basePair + iParticleFilter1*nParticleFilters + iParticleFilter2;
-                ParticlePairHistos * histos = (ParticlePairHistos *)  histogramManager.getGroup(1,index);
-                histos->fill(particle1, particle2,1.0);
-                }
-              }
-            }
+          pd       = factory->getNextObject();
+          pd->iY   = iY;
+          pd->iEta = iEta;
+          pd->iPt  = iPt;
+          pd->iPhi = iPhi;
+          pd->pt   = columns.pt[iParticle];
+          pd->phi  = columns.phi[iParticle];
+          pd->eta  = columns.eta[iParticle];
+          pd->y    = columns.y[iParticle];
+          pd->e    = columns.e[iParticle];
           }
+        digitized = true; // so no need to digitize this particle again..
         }
-      }
-    }
+      if (pd)
+        {
+        filteredParticles[iParticleFilter].push_back(pd);
+        filteredColumns[iParticleFilter].add(*pd,iParticle);
+        }
+      } // particle filter loop
+    } // particle loop
 }
 
 
@@ -482,11 +551,77 @@ void ParticlePairAnalyzer::scaleHistograms()
         printItem("no scaling performed");
         }
       }
+    if (mixingDepth>0 && nMixedEvents[iEventFilter]>0)
+      {
+      // mixed event pairs are normalized per mixed event pair, like same event pairs are per event
+      scalingFactor = 1.0/double(nMixedEvents[iEventFilter]);
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          index = iEventFilter*nParticleFilters*nParticleFilters + iParticleFilter1*nParticleFilters + iParticleFilter2;
+          histogramManager.getGroup(4,index)->scale(scalingFactor);
+          }
+        }
+      }
     }
   if (reportEnd(__FUNCTION__))
     ;
 }
 
+void ParticlePairAnalyzer::reset()
+{
+  EventTask::reset();
+  nMixedEvents.assign(nEventFilters,0);
+}
+
+void ParticlePairAnalyzer::clear()
+{
+  EventTask::clear();
+  nMixedEvents.assign(nEventFilters,0);
+}
+
+void ParticlePairAnalyzer::mergeHistograms(Task & source)
+{
+  EventTask::mergeHistograms(source);
+  ParticlePairAnalyzer & replica = dynamic_cast<ParticlePairAnalyzer&>(source);
+  unsigned int n = nMixedEvents.size();
+  if (replica.nMixedEvents.size()!=n)
+    throw TaskException("Replica has a different number of mixed event counters.","ParticlePairAnalyzer::mergeHistograms(Task & source)");
+  for (unsigned int k=0; k<n; k++) nMixedEvents[k] += replica.nMixedEvents[k];
+}
+
+void ParticlePairAnalyzer::saveCheckpoint(TDirectory & directory)
+{
+  EventTask::saveCheckpoint(directory);
+  for (unsigned int k=0; k<nMixedEvents.size(); k++)
+    writeParameter(directory,Form("nMixedEvents%d",k),nMixedEvents[k]);
+}
+
+void ParticlePairAnalyzer::loadCheckpoint(TDirectory & directory)
+{
+  EventTask::loadCheckpoint(directory);
+  for (unsigned int k=0; k<nMixedEvents.size(); k++)
+    nMixedEvents[k] = readParameter(directory,Form("nMixedEvents%d",k));
+}
+
+void ParticlePairAnalyzer::writeNEventsAccepted(TFile & outputFile)
+{
+  EventTask::writeNEventsAccepted(outputFile);
+  if (mixingDepth<1) return;
+  for (unsigned int k=0; k<nMixedEvents.size(); k++)
+    writeParameter(outputFile,Form("MixedEventFilter%d",k),nMixedEvents[k]);
+}
+
+void ParticlePairAnalyzer::loadNEventsAccepted(TFile & inputFile)
+{
+  EventTask::loadNEventsAccepted(inputFile);
+  if (mixingDepth<1) return;
+  nMixedEvents.assign(nEventFilters,0);
+  for (int iFilter=0; iFilter<nEventFilters; iFilter++)
+    nMixedEvents[iFilter] = readParameter(inputFile,Form("MixedEventFilter%d",iFilter));
+}
+
 void ParticlePairAnalyzer::createDerivedHistograms()
 {
   if (reportStart(__FUNCTION__))
@@ -13,6 +13,9 @@
 #define CAP__ParticlePairAnalyzer
 #include "EventTask.hpp"
 #include "ParticleDigit.hpp"
+#include "ParticleDigitColumns.hpp"
+#include "ParticlePairParallelFiller.hpp"
+#include "EventMixingPool.hpp"
 using CAP::EventTask;
 using CAP::Configuration;
 using CAP::EventFilter;
@@ -75,7 +78,7 @@ public:
   //!
   //! DTOR
   //!
-  virtual ~ParticlePairAnalyzer() {}
+  virtual ~ParticlePairAnalyzer();
   
   //!
   //! Sets the default  values of the configuration parameters used by this task
@@ -90,6 +93,25 @@ public:
   //! Executes this task based on the configuration and class variable specified at construction
   //!
   virtual void analyzeEvent();
+
+  //!
+  //! Digitize the particles of the given event accepted by the particle filters of this task: each particle is given its pt, phi,
+  //! eta, and y bin indices once, and a list of the digitized particles is built for each particle filter. The pair loops then
+  //! work on bin indices only.
+  //!
+  virtual void digitizeParticles(Event & event);
+
+  //!
+  //! Mixing class of the given event accepted by the given event filter, or -1 if the event is not to be mixed. Events are mixed
+  //! with events of the same event filter and, if nBins_mixing>1, of the same bin of the mixing observable (see MixingObservable).
+  //!
+  virtual int getMixingClass(Event & event, int iEventFilter);
+
+  //!
+  //! Fill the mixed event pair histograms of the given event filter with the pairs formed by the digitized particles of the current
+  //! event and those of the events of the same mixing class held by the mixing pool, then store the current event in the pool.
+  //!
+  virtual void mixEvent(Event & event, int iEventFilter);
   
   //!
   //! Creates the histograms  filled by this task at execution
@@ -112,13 +134,61 @@ public:
 
   virtual void calculateDerivedHistograms();
 
+  //!
+  //! Reset this task and its numbers of mixed event pairs, e.g., after a partial save.
+  //!
+  virtual void reset();
+
+  //!
+  //! Clear this task and its numbers of mixed event pairs.
+  //!
+  virtual void clear();
+
+  //!
+  //! Add the histograms and counters of the given replica, including its numbers of mixed event pairs, to those of this task.
+  //!
+  virtual void mergeHistograms(Task & source);
+
+  //!
+  //! Save the histograms and counters of this task, including its numbers of mixed event pairs, in the given directory.
+  //!
+  virtual void saveCheckpoint(TDirectory & directory);
+
+  //!
+  //! Restore the histograms and counters saved by saveCheckpoint().
+  //!
+  virtual void loadCheckpoint(TDirectory & directory);
+
+  //!
+  //! Write the numbers of accepted events and, if events are mixed, of mixed event pairs of each event filter with the histograms.
+  //!
+  virtual void writeNEventsAccepted(TFile & outputFile);
+
+  //!
+  //! Read the numbers written by writeNEventsAccepted().
+  //!
+  virtual void loadNEventsAccepted(TFile & inputFile);
+
 protected:
   
   bool fillEta; //!< whether to fill pseudorapidity histograms (set from configuration at initialization)
   bool fillY;   //!< whether to fill rapidity histograms (set from configuration at initialization)
   bool fillP2;  //!< whether to fill P2 and G2 related histograms  (set from configuration at initialization)
   
-  vector< vector<ParticleDigit*> > filteredParticles;
+  vector< vector<ParticleDigit*> > filteredParticles; //!< digitized particles accepted by each particle filter
+  vector<ParticleDigitColumns> filteredColumns; //!< columns of the digitized particles accepted by each particle filter
+  vector<int> firstParticleFilter; //!< index of the first particle filter accepting each particle of the event, or -1
+  int  nPairThreads;        //!< number of threads filling the pairs of a single event (set from configuration at initialization)
+  long pairThreadsMinPairs; //!< minimum number of pairs of two particle lists filled with nPairThreads threads
+  ParticlePairParallelFiller * parallelFiller; //!< filler of the pairs of high multiplicity events, if nPairThreads>1
+  int    mixingDepth;           //!< number of events of each mixing class kept for event mixing; no mixing if 0
+  int    mixingObservable;      //!< type of the event observable binning the mixing classes (see EventFilter::getObservable())
+  int    mixingObservableIndex; //!< index of the event observable binning the mixing classes
+  int    nBins_mixing;          //!< number of bins of the mixing observable within each event filter
+  double min_mixing;            //!< lower edge of the bins of the mixing observable
+  double max_mixing;            //!< upper edge of the bins of the mixing observable
+  EventMixingPool mixingPool;   //!< recent events of each mixing class
+  vector<long> nMixedEvents;    //!< number of mixed event pairs for each event filter
 
    ClassDef(ParticlePairAnalyzer,0)
 };
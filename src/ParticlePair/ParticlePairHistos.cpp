@@ -9,8 +9,10 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <unordered_map>
 #include "ParticlePairHistos.hpp"
 using CAP::ParticlePairHistos;
+using CAP::ParticlePairKernel;
 
 ClassImp(ParticlePairHistos);
 
@@ -72,11 +74,32 @@ h_DptDpt_yY(nullptr),
 h_n2_DetaDphi(nullptr),
 h_DptDpt_DetaDphi(nullptr),
 h_n2_DyDphi(nullptr),
-h_DptDpt_DyDphi(nullptr)
+h_DptDpt_DyDphi(nullptr),
+b_n2(nullptr),
+b_n2_ptpt(nullptr),
+b_n2_etaEta(nullptr),
+b_DptDpt_etaEta(nullptr),
+b_n2_phiPhi(nullptr),
+b_DptDpt_phiPhi(nullptr),
+b_n2_yY(nullptr),
+b_DptDpt_yY(nullptr),
+b_n2_DetaDphi(nullptr),
+b_DptDpt_DetaDphi(nullptr),
+b_n2_DyDphi(nullptr),
+b_DptDpt_DyDphi(nullptr),
+kernel(nullptr),
+columns1(),
+columns2(),
+partners()
 {
   appendClassName("ParticlePairHistos");
 }
 
+ParticlePairHistos::~ParticlePairHistos()
+{
+  delete kernel;
+}
+
 void ParticlePairHistos::createHistograms()
 {
   if ( reportStart(__FUNCTION__))
@@ -234,6 +257,7 @@ void ParticlePairHistos::createHistograms()
   //                                     "p_{s}","p_{o}", "p_{l}","n_{2}");
   //    }
 
+  createBuffers();
   if ( reportEnd(__FUNCTION__))
     { }
 }
@@ -288,176 +312,111 @@ void ParticlePairHistos::importHistograms(TFile & inputFile)
       h_DptDpt_DyDphi = loadH2(inputFile, CAP::createName(bn,"ptpt_DyDphi"));
       }
     }
+  createBuffers();
   if (reportEnd(__FUNCTION__))
     ;
 }
 
+void ParticlePairHistos::createBuffers()
+{
+  b_n2              = createBuffer(h_n2);
+  b_n2_ptpt         = createBuffer(h_n2_ptpt);
+  b_n2_phiPhi       = createBuffer(h_n2_phiPhi);
+  b_DptDpt_phiPhi   = createBuffer(h_DptDpt_phiPhi);
+  b_n2_etaEta       = createBuffer(h_n2_etaEta);
+  b_n2_DetaDphi     = createBuffer(h_n2_DetaDphi);
+  b_DptDpt_etaEta   = createBuffer(h_DptDpt_etaEta);
+  b_DptDpt_DetaDphi = createBuffer(h_DptDpt_DetaDphi);
+  b_n2_yY           = createBuffer(h_n2_yY);
+  b_n2_DyDphi       = createBuffer(h_n2_DyDphi);
+  b_DptDpt_yY       = createBuffer(h_DptDpt_yY);
+  b_DptDpt_DyDphi   = createBuffer(h_DptDpt_DyDphi);
+  delete kernel;
+  kernel = new ParticlePairKernel();
+  kernel->setBuffers(b_n2_ptpt,
+                     b_n2_phiPhi,   b_DptDpt_phiPhi,
+                     b_n2_etaEta,   b_DptDpt_etaEta,
+                     b_n2_DetaDphi, b_DptDpt_DetaDphi,
+                     b_n2_yY,       b_DptDpt_yY,
+                     b_n2_DyDphi,   b_DptDpt_DyDphi,
+                     nBins_phi, nBins_eta, nBins_y,
+                     fillEta, fillY, fillP2);
+}
+
 void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<ParticleDigit*> & particle2, bool same, double weight)
 {
-//  double nPairs    = 0;
-//  double nPairsEta = 0;
-//  double nPairsY   = 0;
-//  int iG;
-//
-//  for (unsigned int iPart1=0; iPart1<particle1.size(); iPart1++)
-//    {
-//    float pt1 = particle1[iPart1]->pt;
-//    float dpt1 = pt1; // - avgPt1
-//    unsigned int iPt_1  = particle1[iPart1]->iPt;
-//    unsigned int iPhi_1 = particle1[iPart1]->iPhi;
-//    unsigned int iEta_1 = particle1[iPart1]->iEta;
-//    unsigned int iY_1   = particle1[iPart1]->iY;
-//
-//    for (unsigned int iPart2=(same?iPart1+1: 0); iPart2<particle2.size(); iPart2++)
-//      {
-//      float pt2 = particle2[iPart2]->pt;
-//      float dpt2 = pt2; // - avgPt2
-//      unsigned int iPt_2  = particle2[iPart2]->iPt;
-//      unsigned int iPhi_2 = particle2[iPart2]->iPhi;
-//      unsigned int iEta_2 = particle2[iPart2]->iEta;
-//      unsigned int iY_2   = particle2[iPart2]->iY;
-//
-//      nPairs++;
-//      iG = h_n2_ptpt->GetBin(iPt_1,iPt_2);
-//      h_n2_ptpt->AddBinContent(iG,  weight);
-//
-//      iG = h_n2_phiPhi->GetBin(iPhi_1,iPhi_2);
-//      h_n2_phiPhi->AddBinContent(iG,  weight);
-//      if (fillP2)
-//        {
-//        h_DptDpt_phiPhi ->AddBinContent(iG,weight*dpt1*dpt2);
-//        }
-//      if (same)
-//        {
-//        nPairs++;
-//        iG = h_n2_ptpt->GetBin(iPt_2,iPt_1);
-//        h_n2_ptpt->AddBinContent(iG,  weight);
-//        iG = h_n2_phiPhi->GetBin(iPhi_2,iPhi_1);
-//        h_n2_phiPhi->AddBinContent(iG,  weight);
-//        if (fillP2)
-//          {
-//          h_DptDpt_phiPhi->AddBinContent(iG,weight*pt1*pt2);
-//          }
-//        }
-//
-//      if (fillEta && iEta_1!=0 && iEta_2!=0 )
-//        {
-//        nPairsEta++;
-//        // delta-eta maps onto a 2n-1 range i.e., 0 to 2n-2
-//        int iDeltaEta  = iEta_1-iEta_2 + nBins_eta-1;
-//        int iDeltaPhi  = iPhi_1-iPhi_2;
-//        if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
-//
-//        iG = h_n2_etaEta->GetBin(iEta_1,iEta_2);
-//        h_n2_etaEta->AddBinContent(iG,weight);
-//        if (fillP2)
-//          {
-//          h_DptDpt_etaEta->AddBinContent(iG,weight*pt1*pt2);
-//          }
-//
-//        iG = h_n2_DetaDphi->GetBin(iDeltaEta+1,iDeltaPhi+1);
-//        h_n2_DetaDphi->AddBinContent(iG,weight);
-//        if (fillP2)
-//          {
-//          h_DptDpt_DetaDphi->AddBinContent(iG,weight*pt1*pt2);
-//          }
-//        if (same)
-//          {
-//          nPairsEta++;
-//          // delta-eta maps onto a 2n-1 range i.e., 0 to 2n-2
-//          iDeltaEta  = iEta_2-iEta_1 + nBins_eta-1;
-//          iDeltaPhi  = iPhi_2-iPhi_1;
-//          if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
-//          iG = h_n2_etaEta->GetBin(iEta_2,iEta_1);
-//          h_n2_etaEta->AddBinContent(iG,weight);
-//          if (fillP2)
-//            {
-//            h_DptDpt_etaEta->AddBinContent(iG,weight*pt1*pt2);
-//            }
-//
-//          iG = h_n2_DetaDphi->GetBin(iDeltaEta+1,iDeltaPhi+1);
-//          h_n2_DetaDphi->AddBinContent(iG,weight);
-//          if (fillP2)
-//            {
-//            h_DptDpt_DetaDphi->AddBinContent(iG,weight*pt1*pt2);
-//            }
-//          }
-//        }
-//
-//      if (fillY && iY_1!=0 && iY_2!=0 )
-//        {
-//        nPairsY++;
-//        int iDeltaY    = iY_1-iY_2 + nBins_y-1;
-//        int iDeltaPhi  = iPhi_1-iPhi_2;
-//        if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
-//
-//        iG = h_n2_yY->GetBin(iY_1,iY_2);
-//        h_n2_yY->AddBinContent(iG,weight);
-//        if (fillP2)
-//          {
-//          h_DptDpt_yY->AddBinContent(iG,weight*pt1*pt2);
-//          }
-//
-//        iG = h_n2_DyDphi->GetBin(iDeltaY+1,iDeltaPhi+1);
-//        h_n2_DyDphi  ->AddBinContent(iG,weight);
-//        if (fillP2)
-//          {
-//          h_DptDpt_DyDphi->AddBinContent(iG,weight*pt1*pt2);
-//          }
-//        if (same)
-//          {
-//          nPairsY++;
-//          int iDeltaY   = iY_2-iY_1 + nBins_y-1;
-//          int iDeltaPhi  = iPhi_2-iPhi_1;
-//          if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
-//
-//          iG = h_n2_yY->GetBin(iY_1,iY_2);
-//          h_n2_yY->AddBinContent(iG,weight);
-//          if (fillP2)
-//            {
-//            h_DptDpt_yY->AddBinContent(iG,weight*pt1*pt2);
-//            }
-//
-//          iG = h_n2_DyDphi->GetBin(iDeltaY+1,iDeltaPhi+1);
-//          h_n2_DyDphi  ->AddBinContent(iG,weight);
-//          if (fillP2)
-//            {
-//            h_DptDpt_DyDphi->AddBinContent(iG,weight*pt1*pt2);
-//            }
-//          }
-//        }
-//      }
-//    }
-//
-//  // Update number of entries
-//  h_n2_ptpt->SetEntries(h_n2_ptpt->GetEntries()+nPairs);
-//  h_n2_phiPhi->SetEntries(h_n2_phiPhi->GetEntries()+nPairs);
-//  if (fillP2)
-//    {
-//    h_DptDpt_phiPhi->SetEntries(h_DptDpt_phiPhi->GetEntries()+nPairs);
-//    }
-//  if (fillEta)
-//    {
-//    h_n2_etaEta->SetEntries(h_n2_etaEta->GetEntries()+nPairsEta);
-//    h_n2_DetaDphi->SetEntries(h_n2_DetaDphi->GetEntries()+nPairsEta);
-//    if (fillP2)
-//      {
-//      h_DptDpt_etaEta->SetEntries(h_DptDpt_etaEta->GetEntries()+nPairsEta);
-//      h_DptDpt_DetaDphi->SetEntries(h_DptDpt_DetaDphi->GetEntries()+nPairsEta);
-//      }
-//    }
-//
-//  if (fillY)
-//    {
-//    h_n2_yY->SetEntries(h_n2_yY->GetEntries()+nPairsY);
-//    h_n2_DyDphi->SetEntries(h_n2_DyDphi->GetEntries()+nPairsY);
-//    if (fillP2)
-//      {
-//      h_DptDpt_yY->SetEntries(h_DptDpt_yY->GetEntries()+nPairsY);
-//      h_DptDpt_DyDphi->SetEntries(h_DptDpt_DyDphi->GetEntries()+nPairsY);
-//      }
-//    }
-//  h_n2->Fill(double(nPairs),weight);
+  // A particle accepted by both filters has the same digit in both lists: it is not paired with itself.
+  unsigned int n1 = particle1.size();
+  unsigned int n2 = particle2.size();
+  columns1.clear();
+  for (unsigned int iPart1=0; iPart1<n1; iPart1++) columns1.add(*particle1[iPart1],iPart1);
+  if (same)
+    {
+    kernel->fill(columns1,columns1,partners,true,weight);
+    }
+  else
+    {
+    std::unordered_map<const ParticleDigit*,int> index2;
+    columns2.clear();
+    for (unsigned int iPart2=0; iPart2<n2; iPart2++)
+      {
+      columns2.add(*particle2[iPart2],iPart2);
+      index2[particle2[iPart2]] = iPart2;
+      }
+    partners.assign(n1,-1);
+    for (unsigned int iPart1=0; iPart1<n1; iPart1++)
+      {
+      auto found = index2.find(particle1[iPart1]);
+      if (found!=index2.end()) partners[iPart1] = found->second;
+      }
+    kernel->fill(columns1,columns2,partners,false,weight);
+    }
+  addPairEntries(kernel->getNPairs(),kernel->getNPairsEta(),kernel->getNPairsY(),weight);
+}
+
+void ParticlePairHistos::fill(const ParticleDigitColumns & particle1, const ParticleDigitColumns & particle2, bool same, double weight)
+{
+  // Pairs are filled in both orders (1,2) and (2,1) when the two lists are the same so the triangular loop gives the same
+  // histograms as a loop over all ordered pairs.
+  if (!same) particle1.getPartners(particle2,partners);
+  kernel->fill(particle1,particle2,partners,same,weight);
+  addPairEntries(kernel->getNPairs(),kernel->getNPairsEta(),kernel->getNPairsY(),weight);
+}
+
+void ParticlePairHistos::fillMixed(const ParticleDigitColumns & particle1, const ParticleDigitColumns & particle2, double weight)
+{
+  // particles of different events: none is paired with itself
+  partners.assign(particle1.size(),-1);
+  kernel->fill(particle1,particle2,partners,false,weight);
+  addPairEntries(kernel->getNPairs(),kernel->getNPairsEta(),kernel->getNPairsY(),weight);
+}
+
+void ParticlePairHistos::addPairEntries(long nPairs, long nPairsEta, long nPairsY, double weight)
+{
+  b_n2_ptpt->addEntries(nPairs);
+  b_n2_phiPhi->addEntries(nPairs);
+  if (fillP2) b_DptDpt_phiPhi->addEntries(nPairs);
+  if (fillEta)
+    {
+    b_n2_etaEta->addEntries(nPairsEta);
+    b_n2_DetaDphi->addEntries(nPairsEta);
+    if (fillP2)
+      {
+      b_DptDpt_etaEta->addEntries(nPairsEta);
+      b_DptDpt_DetaDphi->addEntries(nPairsEta);
+      }
+    }
+  if (fillY)
+    {
+    b_n2_yY->addEntries(nPairsY);
+    b_n2_DyDphi->addEntries(nPairsY);
+    if (fillP2)
+      {
+      b_DptDpt_yY->addEntries(nPairsY);
+      b_DptDpt_DyDphi->addEntries(nPairsY);
+      }
+    }
+  b_n2->fill(double(nPairs),weight);
 }
 
 void ParticlePairHistos::fill(Particle & particle1, Particle & particle2, double weight)
@@ -474,17 +433,15 @@ void ParticlePairHistos::fill(Particle & particle1, Particle & particle2, double
   int iGDeltaEtaDeltaPhi;
   int iGDeltaYDeltaPhi;
 
-  LorentzVector & momentum1 = particle1.getMomentum();
-  double pt1   = momentum1.Pt();        iPt1 = getPtBinFor(pt1);
-  double phi1  = momentum1.Phi();       if (phi1<0.0) phi1 += CAP::Math::twoPi(); iPhi1 = getPhiBinFor(phi1);
-  double eta1  = momentum1.Eta();       iEta1 = fillEta ? getEtaBinFor(eta1) : 0;
-  double y1    = momentum1.Rapidity();  iY1   = fillY   ? getYBinFor(y1)     : 0;
+  double pt1   = particle1.getPt();        iPt1 = getPtBinFor(pt1);
+  double phi1  = particle1.getPhi();       iPhi1 = getPhiBinFor(phi1);
+  double eta1  = particle1.getEta();       iEta1 = fillEta ? getEtaBinFor(eta1) : 0;
+  double y1    = particle1.getRapidity();  iY1   = fillY   ? getYBinFor(y1)     : 0;
 
-  LorentzVector & momentum2 = particle2.getMomentum();
-  double pt2   = momentum2.Pt();        iPt2 = getPtBinFor(pt2);
-  double phi2  = momentum2.Phi();       if (phi2<0.0) phi2 += CAP::Math::twoPi(); iPhi2 = getPhiBinFor(phi2);
-  double eta2  = momentum2.Eta();       iEta2 = fillEta ? getEtaBinFor(eta2) : 0;
-  double y2    = momentum2.Rapidity();  iY2   = fillY   ? getYBinFor(y2)     : 0;
+  double pt2   = particle2.getPt();        iPt2 = getPtBinFor(pt2);
+  double phi2  = particle2.getPhi();       iPhi2 = getPhiBinFor(phi2);
+  double eta2  = particle2.getEta();       iEta2 = fillEta ? getEtaBinFor(eta2) : 0;
+  double y2    = particle2.getRapidity();  iY2   = fillY   ? getYBinFor(y2)     : 0;
 
 //  cout <<  "pt1:" << pt1 << " phi1:" << phi1 << " y1:" << y1 << " iPt1: " << iPt1 << " iPhi1:" <<  iPhi1 << " iY1:" <<  iY1 << endl;
 //  cout <<  "pt2:" << pt2 << " phi2:" << phi2 << " y2:" << y2 << " iPt2: " << iPt2 << " iPhi2:" <<  iPhi2 << " iY2:" <<  iY2 << endl;
@@ -501,42 +458,42 @@ void ParticlePairHistos::fill(Particle & particle1, Particle & particle2, double
   fillP2 = false;
   fillY  = true;
 
-  iGPtPt   = h_n2_ptpt->GetBin(iPt1,iPt2);
-  iGPhiPhi = h_n2_phiPhi->GetBin(iPhi1,iPhi2);
+  iGPtPt   = b_n2_ptpt->getBin(iPt1,iPt2);
+  iGPhiPhi = b_n2_phiPhi->getBin(iPhi1,iPhi2);
 
-  h_n2_ptpt   ->AddBinContent(iGPtPt,    weight);  h_n2_ptpt  ->SetEntries(h_n2_ptpt  ->GetEntries()+1);
-  h_n2_phiPhi ->AddBinContent(iGPhiPhi,  weight);  h_n2_phiPhi->SetEntries(h_n2_phiPhi->GetEntries()+1);
+  b_n2_ptpt   ->add(iGPtPt,    weight);  b_n2_ptpt  ->addEntries(1);
+  b_n2_phiPhi ->add(iGPhiPhi,  weight);  b_n2_phiPhi->addEntries(1);
 
   if (fillP2)
     {
-    h_DptDpt_phiPhi->AddBinContent(iGPhiPhi,weight*pt1*pt2);
-    h_DptDpt_phiPhi->SetEntries(h_DptDpt_phiPhi->GetEntries()+1);
+    b_DptDpt_phiPhi->add(iGPhiPhi,weight*pt1*pt2);
+    b_DptDpt_phiPhi->addEntries(1);
     }
 
   if (fillEta && iEta1!=0 && iEta2!=0 )
     {
-    iGEtaEta           = h_n2_etaEta->GetBin(iEta1,iEta2);
-    iGDeltaEtaDeltaPhi = h_n2_DetaDphi->GetBin(iDeltaEta+1,iDeltaPhi+1);
-    h_n2_etaEta->AddBinContent(iGEtaEta,weight);             h_n2_etaEta  ->SetEntries(h_n2_etaEta  ->GetEntries()+1);
-    h_n2_DetaDphi->AddBinContent(iGDeltaEtaDeltaPhi,weight); h_n2_DetaDphi->SetEntries(h_n2_DetaDphi->GetEntries()+1);
+    iGEtaEta           = b_n2_etaEta->getBin(iEta1,iEta2);
+    iGDeltaEtaDeltaPhi = b_n2_DetaDphi->getBin(iDeltaEta+1,iDeltaPhi+1);
+    b_n2_etaEta->add(iGEtaEta,weight);             b_n2_etaEta  ->addEntries(1);
+    b_n2_DetaDphi->add(iGDeltaEtaDeltaPhi,weight); b_n2_DetaDphi->addEntries(1);
 
     if (fillP2)
       {
-      h_DptDpt_etaEta   ->AddBinContent(iGEtaEta,           weight*pt1*pt2); h_DptDpt_etaEta->SetEntries(h_DptDpt_etaEta    ->GetEntries()+1);
-      h_DptDpt_DetaDphi ->AddBinContent(iGDeltaEtaDeltaPhi, weight*pt1*pt2); h_DptDpt_DetaDphi->SetEntries(h_DptDpt_DetaDphi->GetEntries()+1);
+      b_DptDpt_etaEta   ->add(iGEtaEta,           weight*pt1*pt2); b_DptDpt_etaEta  ->addEntries(1);
+      b_DptDpt_DetaDphi ->add(iGDeltaEtaDeltaPhi, weight*pt1*pt2); b_DptDpt_DetaDphi->addEntries(1);
       }
     }
 
   if (fillY && iY1!=0 && iY2!=0 )
     {
-    iGYY             = h_n2_yY->GetBin(iY1,iY2);
-    iGDeltaYDeltaPhi = h_n2_DyDphi->GetBin(iDeltaY+1,iDeltaPhi+1);
-    h_n2_yY      ->AddBinContent(iGYY,weight);              h_n2_yY      ->SetEntries(h_n2_yY      ->GetEntries()+1);
-    h_n2_DyDphi  ->AddBinContent(iGDeltaYDeltaPhi,weight);  h_n2_DyDphi  ->SetEntries(h_n2_DyDphi  ->GetEntries()+1);
+    iGYY             = b_n2_yY->getBin(iY1,iY2);
+    iGDeltaYDeltaPhi = b_n2_DyDphi->getBin(iDeltaY+1,iDeltaPhi+1);
+    b_n2_yY      ->add(iGYY,weight);              b_n2_yY      ->addEntries(1);
+    b_n2_DyDphi  ->add(iGDeltaYDeltaPhi,weight);  b_n2_DyDphi  ->addEntries(1);
     if (fillP2)
       {
-      h_DptDpt_yY     ->AddBinContent(iGYY, weight*pt1*pt2);               h_DptDpt_yY ->SetEntries(   h_DptDpt_yY     ->GetEntries()+1);
-      h_DptDpt_DyDphi ->AddBinContent(iGDeltaEtaDeltaPhi, weight*pt1*pt2); h_DptDpt_DyDphi->SetEntries(h_DptDpt_DyDphi->GetEntries()+1);
+      b_DptDpt_yY     ->add(iGYY, weight*pt1*pt2);             b_DptDpt_yY    ->addEntries(1);
+      b_DptDpt_DyDphi ->add(iGDeltaYDeltaPhi, weight*pt1*pt2); b_DptDpt_DyDphi->addEntries(1);
       }
     }
 }
@@ -15,6 +15,8 @@
 #include "HistogramGroup.hpp"
 #include "Particle.hpp"
 #include "ParticleDigit.hpp"
+#include "ParticleDigitColumns.hpp"
+#include "ParticlePairKernel.hpp"
 
 namespace CAP
 {
@@ -27,11 +29,38 @@ public:
   ParticlePairHistos(Task * _parent,
                      const String & _name,
                      const Configuration & _configuration);
-  virtual ~ParticlePairHistos() {}
+  virtual ~ParticlePairHistos();
   virtual void createHistograms();
   virtual void importHistograms(TFile & inputFile);
 
   virtual void fill(vector<ParticleDigit*> & particle1, vector<ParticleDigit*> & particle2, bool same, double weight);
+
+  //!
+  //! Fill the pairs of the two given lists of digitized particles with the pair kernel (see ParticlePairKernel). If same is
+  //! true, the two lists are the same. Otherwise, particles present in both lists are found from their positions in the event
+  //! and are not paired with themselves.
+  //!
+  virtual void fill(const ParticleDigitColumns & particle1, const ParticleDigitColumns & particle2, bool same, double weight);
+
+  //!
+  //! Fill all the pairs formed by a particle of the first list and a particle of the second list, which belong to different
+  //! events, e.g., to build mixed event pairs. Pairs are filled in the order (1,2) only.
+  //!
+  virtual void fillMixed(const ParticleDigitColumns & particle1, const ParticleDigitColumns & particle2, double weight);
+
+  //!
+  //! Update the number of entries of the pair histograms with the given numbers of pairs filled in the buffers, in total and with
+  //! valid eta or y bins, and fill the pair multiplicity histogram.
+  //!
+  void addPairEntries(long nPairs, long nPairsEta, long nPairsY, double weight);
+
+  //!
+  //! Kernel filling the buffers of the pair histograms of this group.
+  //!
+  const ParticlePairKernel & getKernel() const
+  {
+  return *kernel;
+  }
   virtual void fill(Particle & particle1, Particle & particle2, double weight);
 
   inline int getPtBinFor(float v) const
@@ -144,6 +173,34 @@ public:
 
   TH3 * h_n2_DeltaP;
 
+  // accumulation buffers of the pair histograms, flushed by HistogramGroup::flush()
+  HistogramBuffer * b_n2;
+  HistogramBuffer * b_n2_ptpt;
+  HistogramBuffer * b_n2_etaEta;
+  HistogramBuffer * b_DptDpt_etaEta;
+  HistogramBuffer * b_n2_phiPhi;
+  HistogramBuffer * b_DptDpt_phiPhi;
+  HistogramBuffer * b_n2_yY;
+  HistogramBuffer * b_DptDpt_yY;
+  HistogramBuffer * b_n2_DetaDphi;
+  HistogramBuffer * b_DptDpt_DetaDphi;
+  HistogramBuffer * b_n2_DyDphi;
+  HistogramBuffer * b_DptDpt_DyDphi;
+
+protected:
+
+  //!
+  //! Create the accumulation buffers of the histograms of this group.
+  //!
+  void createBuffers();
+
+  ParticlePairKernel * kernel;   //!
+  ParticleDigitColumns columns1; //!
+  ParticleDigitColumns columns2; //!
+  vector<int>          partners; //!
+
+public:
+
   ClassDef(ParticlePairHistos,0)
 };
 
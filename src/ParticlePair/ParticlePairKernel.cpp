@@ -0,0 +1,427 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "ParticlePairKernel.hpp"
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CAP_PAIR_KERNEL_X86
+#include <immintrin.h>
+#endif
+using CAP::ParticlePairKernel;
+
+ParticlePairKernel::ParticlePairKernel()
+:
+n2_ptpt(nullptr),
+n2_phiPhi(nullptr),
+DptDpt_phiPhi(nullptr),
+n2_etaEta(nullptr),
+DptDpt_etaEta(nullptr),
+n2_DetaDphi(nullptr),
+DptDpt_DetaDphi(nullptr),
+n2_yY(nullptr),
+DptDpt_yY(nullptr),
+n2_DyDphi(nullptr),
+DptDpt_DyDphi(nullptr),
+nBins_phi(0),
+nBins_eta(0),
+nBins_y(0),
+stride_pt(0),
+stride_phi(0),
+stride_eta(0),
+stride_Deta(0),
+stride_y(0),
+stride_Dy(0),
+fillEta(false),
+fillY(false),
+fillP2(false),
+same(false),
+weight(1.0),
+nPairs(0),
+nPairsEta(0),
+nPairsY(0),
+instructionSet(Scalar),
+nLanes(1),
+block()
+{
+  setInstructionSet(getSupportedInstructionSet());
+}
+
+void ParticlePairKernel::setBuffers(HistogramBuffer * _n2_ptpt,
+                                    HistogramBuffer * _n2_phiPhi,
+                                    HistogramBuffer * _DptDpt_phiPhi,
+                                    HistogramBuffer * _n2_etaEta,
+                                    HistogramBuffer * _DptDpt_etaEta,
+                                    HistogramBuffer * _n2_DetaDphi,
+                                    HistogramBuffer * _DptDpt_DetaDphi,
+                                    HistogramBuffer * _n2_yY,
+                                    HistogramBuffer * _DptDpt_yY,
+                                    HistogramBuffer * _n2_DyDphi,
+                                    HistogramBuffer * _DptDpt_DyDphi,
+                                    int _nBins_phi,
+                                    int _nBins_eta,
+                                    int _nBins_y,
+                                    bool _fillEta,
+                                    bool _fillY,
+                                    bool _fillP2)
+{
+  n2_ptpt         = _n2_ptpt;
+  n2_phiPhi       = _n2_phiPhi;
+  DptDpt_phiPhi   = _DptDpt_phiPhi;
+  n2_etaEta       = _n2_etaEta;
+  DptDpt_etaEta   = _DptDpt_etaEta;
+  n2_DetaDphi     = _n2_DetaDphi;
+  DptDpt_DetaDphi = _DptDpt_DetaDphi;
+  n2_yY           = _n2_yY;
+  DptDpt_yY       = _DptDpt_yY;
+  n2_DyDphi       = _n2_DyDphi;
+  DptDpt_DyDphi   = _DptDpt_DyDphi;
+  nBins_phi       = _nBins_phi;
+  nBins_eta       = _nBins_eta;
+  nBins_y         = _nBins_y;
+  fillEta         = _fillEta;
+  fillY           = _fillY;
+  fillP2          = _fillP2;
+  stride_pt       = n2_ptpt->getStrideX();
+  stride_phi      = n2_phiPhi->getStrideX();
+  stride_eta      = fillEta ? n2_etaEta->getStrideX()   : 0;
+  stride_Deta     = fillEta ? n2_DetaDphi->getStrideX() : 0;
+  stride_y        = fillY   ? n2_yY->getStrideX()       : 0;
+  stride_Dy       = fillY   ? n2_DyDphi->getStrideX()   : 0;
+}
+
+void ParticlePairKernel::setBuffers(const ParticlePairKernel & model, const vector<HistogramBuffer*> & buffers)
+{
+  setBuffers(buffers[0],buffers[1],buffers[2],buffers[3],buffers[4],buffers[5],buffers[6],buffers[7],buffers[8],buffers[9],buffers[10],
+             model.nBins_phi,model.nBins_eta,model.nBins_y,model.fillEta,model.fillY,model.fillP2);
+  setInstructionSet(model.instructionSet);
+}
+
+void ParticlePairKernel::getBuffers(vector<HistogramBuffer*> & buffers) const
+{
+  buffers.assign({ n2_ptpt,
+                   n2_phiPhi,   DptDpt_phiPhi,
+                   n2_etaEta,   DptDpt_etaEta,
+                   n2_DetaDphi, DptDpt_DetaDphi,
+                   n2_yY,       DptDpt_yY,
+                   n2_DyDphi,   DptDpt_DyDphi });
+}
+
+ParticlePairKernel::InstructionSet ParticlePairKernel::getSupportedInstructionSet()
+{
+#ifdef CAP_PAIR_KERNEL_X86
+  static const InstructionSet supported = []()
+    {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return AVX512;
+    if (__builtin_cpu_supports("avx2"))    return AVX2;
+    return Scalar;
+    }();
+  return supported;
+#else
+  return Scalar;
+#endif
+}
+
+void ParticlePairKernel::setInstructionSet(InstructionSet _instructionSet)
+{
+  instructionSet = (_instructionSet<=getSupportedInstructionSet()) ? _instructionSet : getSupportedInstructionSet();
+  switch (instructionSet)
+    {
+      case Scalar: nLanes = 1;  break;
+      case AVX2:   nLanes = 8;  break;
+      case AVX512: nLanes = 16; break;
+    }
+}
+
+void ParticlePairKernel::fill(const ParticleDigitColumns & particles1,
+                              const ParticleDigitColumns & particles2,
+                              const vector<int> & partners,
+                              bool _same,
+                              double _weight)
+{
+  resetCounts();
+  fillRows(particles1,particles2,partners,_same,_weight,0,particles1.size());
+}
+
+void ParticlePairKernel::fillRows(const ParticleDigitColumns & particles1,
+                                  const ParticleDigitColumns & particles2,
+                                  const vector<int> & partners,
+                                  bool _same,
+                                  double _weight,
+                                  unsigned int firstRow,
+                                  unsigned int lastRow)
+{
+  same   = _same;
+  weight = _weight;
+  unsigned int n2 = particles2.size();
+  for (unsigned int iPart1=firstRow; iPart1<lastRow; iPart1++)
+    {
+    Row row;
+    row.iPt  = particles1.iPt[iPart1];
+    row.iPhi = particles1.iPhi[iPart1];
+    row.iEta = particles1.iEta[iPart1];
+    row.iY   = particles1.iY[iPart1];
+    row.wpt  = weight*particles1.pt[iPart1];
+    if (same)
+      {
+      fillRange(row,particles2,iPart1+1,n2);
+      }
+    else if (partners[iPart1]<0)
+      {
+      fillRange(row,particles2,0,n2);
+      }
+    else
+      {
+      // skip the particle itself
+      fillRange(row,particles2,0,partners[iPart1]);
+      fillRange(row,particles2,partners[iPart1]+1,n2);
+      }
+    }
+}
+
+void ParticlePairKernel::resetCounts()
+{
+  nPairs    = 0;
+  nPairsEta = 0;
+  nPairsY   = 0;
+}
+
+void ParticlePairKernel::fillRange(const Row & row, const ParticleDigitColumns & particles2, unsigned int first, unsigned int last)
+{
+  unsigned int iPart2 = first;
+  if (nLanes>1)
+    {
+    while (iPart2+nLanes<=last)
+      {
+      if (instructionSet==AVX512)
+        computeAVX512(row,particles2,iPart2);
+      else
+        computeAVX2(row,particles2,iPart2);
+      scatter(nLanes);
+      iPart2 += nLanes;
+      }
+    }
+  while (iPart2<last)
+    {
+    unsigned int count = (last-iPart2<(unsigned int) maxLanes) ? last-iPart2 : maxLanes;
+    computeScalar(row,particles2,iPart2,count);
+    scatter(count);
+    iPart2 += count;
+    }
+}
+
+void ParticlePairKernel::computeScalar(const Row & row, const ParticleDigitColumns & particles2, unsigned int first, unsigned int count)
+{
+  for (unsigned int k=0; k<count; k++)
+    {
+    unsigned int iPart2 = first+k;
+    int iPt2  = particles2.iPt[iPart2];
+    int iPhi2 = particles2.iPhi[iPart2];
+    int iEta2 = particles2.iEta[iPart2];
+    int iY2   = particles2.iY[iPart2];
+    int iDeltaPhi0 = row.iPhi-iPhi2;  if (iDeltaPhi0<0) iDeltaPhi0 += nBins_phi;
+    int iDeltaPhi1 = iPhi2-row.iPhi;  if (iDeltaPhi1<0) iDeltaPhi1 += nBins_phi;
+    block.ptpt[0][k]   = row.iPt  + stride_pt*iPt2;
+    block.ptpt[1][k]   = iPt2     + stride_pt*row.iPt;
+    block.phiPhi[0][k] = row.iPhi + stride_phi*iPhi2;
+    block.phiPhi[1][k] = iPhi2    + stride_phi*row.iPhi;
+    if (fillEta)
+      {
+      // delta-eta maps onto a 2n-1 range i.e., 0 to 2n-2
+      block.validEta[k]    = (row.iEta!=0 && iEta2!=0) ? 1 : 0;
+      block.etaEta[0][k]   = row.iEta + stride_eta*iEta2;
+      block.etaEta[1][k]   = iEta2    + stride_eta*row.iEta;
+      block.DetaDphi[0][k] = row.iEta-iEta2+nBins_eta + stride_Deta*(iDeltaPhi0+1);
+      block.DetaDphi[1][k] = iEta2-row.iEta+nBins_eta + stride_Deta*(iDeltaPhi1+1);
+      }
+    if (fillY)
+      {
+      block.validY[k]    = (row.iY!=0 && iY2!=0) ? 1 : 0;
+      block.yY[0][k]     = row.iY + stride_y*iY2;
+      block.yY[1][k]     = iY2    + stride_y*row.iY;
+      block.DyDphi[0][k] = row.iY-iY2+nBins_y + stride_Dy*(iDeltaPhi0+1);
+      block.DyDphi[1][k] = iY2-row.iY+nBins_y + stride_Dy*(iDeltaPhi1+1);
+      }
+    if (fillP2) block.ptpt_w[k] = row.wpt*particles2.pt[iPart2];
+    }
+}
+
+#ifdef CAP_PAIR_KERNEL_X86
+
+__attribute__((target("avx2")))
+void ParticlePairKernel::computeAVX2(const Row & row, const ParticleDigitColumns & particles2, unsigned int first)
+{
+  const __m256i zero  = _mm256_setzero_si256();
+  const __m256i one   = _mm256_set1_epi32(1);
+  const __m256i nPhi  = _mm256_set1_epi32(nBins_phi);
+  const __m256i iPt1  = _mm256_set1_epi32(row.iPt);
+  const __m256i iPhi1 = _mm256_set1_epi32(row.iPhi);
+  const __m256i iPt2  = _mm256_loadu_si256((const __m256i*) &particles2.iPt[first]);
+  const __m256i iPhi2 = _mm256_loadu_si256((const __m256i*) &particles2.iPhi[first]);
+
+  __m256i iDeltaPhi0 = _mm256_sub_epi32(iPhi1,iPhi2);
+  __m256i iDeltaPhi1 = _mm256_sub_epi32(iPhi2,iPhi1);
+  iDeltaPhi0 = _mm256_add_epi32(iDeltaPhi0,_mm256_and_si256(_mm256_cmpgt_epi32(zero,iDeltaPhi0),nPhi));
+  iDeltaPhi1 = _mm256_add_epi32(iDeltaPhi1,_mm256_and_si256(_mm256_cmpgt_epi32(zero,iDeltaPhi1),nPhi));
+  iDeltaPhi0 = _mm256_add_epi32(iDeltaPhi0,one);
+  iDeltaPhi1 = _mm256_add_epi32(iDeltaPhi1,one);
+
+  _mm256_storeu_si256((__m256i*) block.ptpt[0],   _mm256_add_epi32(iPt1, _mm256_mullo_epi32(_mm256_set1_epi32(stride_pt),iPt2)));
+  _mm256_storeu_si256((__m256i*) block.ptpt[1],   _mm256_add_epi32(iPt2, _mm256_set1_epi32(stride_pt*row.iPt)));
+  _mm256_storeu_si256((__m256i*) block.phiPhi[0], _mm256_add_epi32(iPhi1,_mm256_mullo_epi32(_mm256_set1_epi32(stride_phi),iPhi2)));
+  _mm256_storeu_si256((__m256i*) block.phiPhi[1], _mm256_add_epi32(iPhi2,_mm256_set1_epi32(stride_phi*row.iPhi)));
+
+  if (fillEta)
+    {
+    const __m256i iEta1  = _mm256_set1_epi32(row.iEta);
+    const __m256i iEta2  = _mm256_loadu_si256((const __m256i*) &particles2.iEta[first]);
+    const __m256i nEta   = _mm256_set1_epi32(nBins_eta);
+    const __m256i sDeta  = _mm256_set1_epi32(stride_Deta);
+    __m256i valid = (row.iEta!=0) ? _mm256_andnot_si256(_mm256_cmpeq_epi32(iEta2,zero),one) : zero;
+    _mm256_storeu_si256((__m256i*) block.validEta,    valid);
+    _mm256_storeu_si256((__m256i*) block.etaEta[0],   _mm256_add_epi32(iEta1,_mm256_mullo_epi32(_mm256_set1_epi32(stride_eta),iEta2)));
+    _mm256_storeu_si256((__m256i*) block.etaEta[1],   _mm256_add_epi32(iEta2,_mm256_set1_epi32(stride_eta*row.iEta)));
+    _mm256_storeu_si256((__m256i*) block.DetaDphi[0], _mm256_add_epi32(_mm256_add_epi32(_mm256_sub_epi32(iEta1,iEta2),nEta),_mm256_mullo_epi32(sDeta,iDeltaPhi0)));
+    _mm256_storeu_si256((__m256i*) block.DetaDphi[1], _mm256_add_epi32(_mm256_add_epi32(_mm256_sub_epi32(iEta2,iEta1),nEta),_mm256_mullo_epi32(sDeta,iDeltaPhi1)));
+    }
+
+  if (fillY)
+    {
+    const __m256i iY1  = _mm256_set1_epi32(row.iY);
+    const __m256i iY2  = _mm256_loadu_si256((const __m256i*) &particles2.iY[first]);
+    const __m256i nY   = _mm256_set1_epi32(nBins_y);
+    const __m256i sDy  = _mm256_set1_epi32(stride_Dy);
+    __m256i valid = (row.iY!=0) ? _mm256_andnot_si256(_mm256_cmpeq_epi32(iY2,zero),one) : zero;
+    _mm256_storeu_si256((__m256i*) block.validY,    valid);
+    _mm256_storeu_si256((__m256i*) block.yY[0],     _mm256_add_epi32(iY1,_mm256_mullo_epi32(_mm256_set1_epi32(stride_y),iY2)));
+    _mm256_storeu_si256((__m256i*) block.yY[1],     _mm256_add_epi32(iY2,_mm256_set1_epi32(stride_y*row.iY)));
+    _mm256_storeu_si256((__m256i*) block.DyDphi[0], _mm256_add_epi32(_mm256_add_epi32(_mm256_sub_epi32(iY1,iY2),nY),_mm256_mullo_epi32(sDy,iDeltaPhi0)));
+    _mm256_storeu_si256((__m256i*) block.DyDphi[1], _mm256_add_epi32(_mm256_add_epi32(_mm256_sub_epi32(iY2,iY1),nY),_mm256_mullo_epi32(sDy,iDeltaPhi1)));
+    }
+
+  if (fillP2)
+    {
+    const __m256d wpt = _mm256_set1_pd(row.wpt);
+    _mm256_storeu_pd(&block.ptpt_w[0],_mm256_mul_pd(wpt,_mm256_loadu_pd(&particles2.pt[first])));
+    _mm256_storeu_pd(&block.ptpt_w[4],_mm256_mul_pd(wpt,_mm256_loadu_pd(&particles2.pt[first+4])));
+    }
+}
+
+__attribute__((target("avx512f")))
+void ParticlePairKernel::computeAVX512(const Row & row, const ParticleDigitColumns & particles2, unsigned int first)
+{
+  const __m512i zero  = _mm512_setzero_si512();
+  const __m512i one   = _mm512_set1_epi32(1);
+  const __m512i nPhi  = _mm512_set1_epi32(nBins_phi);
+  const __m512i iPt1  = _mm512_set1_epi32(row.iPt);
+  const __m512i iPhi1 = _mm512_set1_epi32(row.iPhi);
+  const __m512i iPt2  = _mm512_loadu_si512(&particles2.iPt[first]);
+  const __m512i iPhi2 = _mm512_loadu_si512(&particles2.iPhi[first]);
+
+  __m512i iDeltaPhi0 = _mm512_sub_epi32(iPhi1,iPhi2);
+  __m512i iDeltaPhi1 = _mm512_sub_epi32(iPhi2,iPhi1);
+  iDeltaPhi0 = _mm512_mask_add_epi32(iDeltaPhi0,_mm512_cmplt_epi32_mask(iDeltaPhi0,zero),iDeltaPhi0,nPhi);
+  iDeltaPhi1 = _mm512_mask_add_epi32(iDeltaPhi1,_mm512_cmplt_epi32_mask(iDeltaPhi1,zero),iDeltaPhi1,nPhi);
+  iDeltaPhi0 = _mm512_add_epi32(iDeltaPhi0,one);
+  iDeltaPhi1 = _mm512_add_epi32(iDeltaPhi1,one);
+
+  _mm512_storeu_si512(block.ptpt[0],   _mm512_add_epi32(iPt1, _mm512_mullo_epi32(_mm512_set1_epi32(stride_pt),iPt2)));
+  _mm512_storeu_si512(block.ptpt[1],   _mm512_add_epi32(iPt2, _mm512_set1_epi32(stride_pt*row.iPt)));
+  _mm512_storeu_si512(block.phiPhi[0], _mm512_add_epi32(iPhi1,_mm512_mullo_epi32(_mm512_set1_epi32(stride_phi),iPhi2)));
+  _mm512_storeu_si512(block.phiPhi[1], _mm512_add_epi32(iPhi2,_mm512_set1_epi32(stride_phi*row.iPhi)));
+
+  if (fillEta)
+    {
+    const __m512i iEta1  = _mm512_set1_epi32(row.iEta);
+    const __m512i iEta2  = _mm512_loadu_si512(&particles2.iEta[first]);
+    const __m512i nEta   = _mm512_set1_epi32(nBins_eta);
+    const __m512i sDeta  = _mm512_set1_epi32(stride_Deta);
+    __m512i valid = (row.iEta!=0) ? _mm512_maskz_mov_epi32(_mm512_cmpneq_epi32_mask(iEta2,zero),one) : zero;
+    _mm512_storeu_si512(block.validEta,    valid);
+    _mm512_storeu_si512(block.etaEta[0],   _mm512_add_epi32(iEta1,_mm512_mullo_epi32(_mm512_set1_epi32(stride_eta),iEta2)));
+    _mm512_storeu_si512(block.etaEta[1],   _mm512_add_epi32(iEta2,_mm512_set1_epi32(stride_eta*row.iEta)));
+    _mm512_storeu_si512(block.DetaDphi[0], _mm512_add_epi32(_mm512_add_epi32(_mm512_sub_epi32(iEta1,iEta2),nEta),_mm512_mullo_epi32(sDeta,iDeltaPhi0)));
+    _mm512_storeu_si512(block.DetaDphi[1], _mm512_add_epi32(_mm512_add_epi32(_mm512_sub_epi32(iEta2,iEta1),nEta),_mm512_mullo_epi32(sDeta,iDeltaPhi1)));
+    }
+
+  if (fillY)
+    {
+    const __m512i iY1  = _mm512_set1_epi32(row.iY);
+    const __m512i iY2  = _mm512_loadu_si512(&particles2.iY[first]);
+    const __m512i nY   = _mm512_set1_epi32(nBins_y);
+    const __m512i sDy  = _mm512_set1_epi32(stride_Dy);
+    __m512i valid = (row.iY!=0) ? _mm512_maskz_mov_epi32(_mm512_cmpneq_epi32_mask(iY2,zero),one) : zero;
+    _mm512_storeu_si512(block.validY,    valid);
+    _mm512_storeu_si512(block.yY[0],     _mm512_add_epi32(iY1,_mm512_mullo_epi32(_mm512_set1_epi32(stride_y),iY2)));
+    _mm512_storeu_si512(block.yY[1],     _mm512_add_epi32(iY2,_mm512_set1_epi32(stride_y*row.iY)));
+    _mm512_storeu_si512(block.DyDphi[0], _mm512_add_epi32(_mm512_add_epi32(_mm512_sub_epi32(iY1,iY2),nY),_mm512_mullo_epi32(sDy,iDeltaPhi0)));
+    _mm512_storeu_si512(block.DyDphi[1], _mm512_add_epi32(_mm512_add_epi32(_mm512_sub_epi32(iY2,iY1),nY),_mm512_mullo_epi32(sDy,iDeltaPhi1)));
+    }
+
+  if (fillP2)
+    {
+    const __m512d wpt = _mm512_set1_pd(row.wpt);
+    _mm512_storeu_pd(&block.ptpt_w[0],_mm512_mul_pd(wpt,_mm512_loadu_pd(&particles2.pt[first])));
+    _mm512_storeu_pd(&block.ptpt_w[8],_mm512_mul_pd(wpt,_mm512_loadu_pd(&particles2.pt[first+8])));
+    }
+}
+
+#else
+
+void ParticlePairKernel::computeAVX2(const Row & row, const ParticleDigitColumns & particles2, unsigned int first)
+{
+  computeScalar(row,particles2,first,8);
+}
+
+void ParticlePairKernel::computeAVX512(const Row & row, const ParticleDigitColumns & particles2, unsigned int first)
+{
+  computeScalar(row,particles2,first,16);
+}
+
+#endif
+
+void ParticlePairKernel::scatter(unsigned int count)
+{
+  // pairs are added one at a time, in the order of the scalar loop, so pairs of the block falling in the same bin do not conflict
+  int nOrders = same ? 2 : 1;
+  for (unsigned int k=0; k<count; k++)
+    {
+    double ptpt = block.ptpt_w[k];
+    for (int iOrder=0; iOrder<nOrders; iOrder++)
+      {
+      n2_ptpt  ->add(block.ptpt[iOrder][k],  weight);
+      n2_phiPhi->add(block.phiPhi[iOrder][k],weight);
+      if (fillP2) DptDpt_phiPhi->add(block.phiPhi[iOrder][k],ptpt);
+      if (fillEta && block.validEta[k])
+        {
+        n2_etaEta  ->add(block.etaEta[iOrder][k],  weight);
+        n2_DetaDphi->add(block.DetaDphi[iOrder][k],weight);
+        if (fillP2)
+          {
+          DptDpt_etaEta  ->add(block.etaEta[iOrder][k],  ptpt);
+          DptDpt_DetaDphi->add(block.DetaDphi[iOrder][k],ptpt);
+          }
+        nPairsEta++;
+        }
+      if (fillY && block.validY[k])
+        {
+        n2_yY    ->add(block.yY[iOrder][k],    weight);
+        n2_DyDphi->add(block.DyDphi[iOrder][k],weight);
+        if (fillP2)
+          {
+          DptDpt_yY    ->add(block.yY[iOrder][k],    ptpt);
+          DptDpt_DyDphi->add(block.DyDphi[iOrder][k],ptpt);
+          }
+        nPairsY++;
+        }
+      nPairs++;
+      }
+    }
+}
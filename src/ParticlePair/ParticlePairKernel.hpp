@@ -0,0 +1,204 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticlePairKernel
+#define CAP__ParticlePairKernel
+#include <vector>
+#include "HistogramBuffer.hpp"
+#include "ParticleDigitColumns.hpp"
+
+namespace CAP
+{
+
+//!
+//! Inner loop of the pair analysis of digitized particles: fills the pair histograms of a ParticlePairHistos (ptpt, phiPhi,
+//! etaEta, yY, DetaDphi, DyDphi and their DptDpt counterparts) for all pairs of two lists of particles given as columns of bin
+//! indices and transverse momenta (see ParticleDigitColumns).
+//!
+//! The bin indices and the weights of the pairs formed by a particle of the first list with a block of particles of the second
+//! list are computed 8 (AVX2) or 16 (AVX-512) at a time, with the azimuthal difference wrapped by a comparison rather than
+//! a modulo. The pairs of the block are then added lane by lane to the buffers of the histograms, so two pairs falling in the
+//! same bin never conflict and the histograms are filled with the same additions, in the same order, as by the scalar loop.
+//! The instruction set is selected at run time from those supported by the processor; the scalar loop is used on other
+//! processors and for the last pairs of each row.
+//!
+class ParticlePairKernel
+{
+public:
+
+  enum InstructionSet { Scalar=0, AVX2=1, AVX512=2 };
+
+  ParticlePairKernel();
+
+  virtual ~ParticlePairKernel() {}
+
+  //!
+  //! Set the buffers filled by the kernel and the binning of the single particle variables. The DptDpt buffers are used only
+  //! if fillP2 is true, the eta (y) buffers only if fillEta (fillY) is true.
+  //!
+  void setBuffers(HistogramBuffer * _n2_ptpt,
+                  HistogramBuffer * _n2_phiPhi,
+                  HistogramBuffer * _DptDpt_phiPhi,
+                  HistogramBuffer * _n2_etaEta,
+                  HistogramBuffer * _DptDpt_etaEta,
+                  HistogramBuffer * _n2_DetaDphi,
+                  HistogramBuffer * _DptDpt_DetaDphi,
+                  HistogramBuffer * _n2_yY,
+                  HistogramBuffer * _DptDpt_yY,
+                  HistogramBuffer * _n2_DyDphi,
+                  HistogramBuffer * _DptDpt_DyDphi,
+                  int _nBins_phi,
+                  int _nBins_eta,
+                  int _nBins_y,
+                  bool _fillEta,
+                  bool _fillY,
+                  bool _fillP2);
+
+  //!
+  //! Set this kernel to fill the given buffers, listed in the order of the arguments of setBuffers(), with the binning and
+  //! options of the given kernel. Used to give each thread filling the pairs of an event its own buffers.
+  //!
+  void setBuffers(const ParticlePairKernel & model, const vector<HistogramBuffer*> & buffers);
+
+  //!
+  //! Get the buffers filled by this kernel in the order of the arguments of setBuffers(). Unused buffers are null.
+  //!
+  void getBuffers(vector<HistogramBuffer*> & buffers) const;
+
+  //!
+  //! Fill the pairs of particles of the two lists with the given weight. If same is true, the two lists are the same and each
+  //! pair is filled in both orders. Otherwise, partners[k] is the index in the second list of particle k of the first list, or -1
+  //! (see ParticleDigitColumns::getPartners()): a particle is never paired with itself.
+  //!
+  void fill(const ParticleDigitColumns & particles1,
+            const ParticleDigitColumns & particles2,
+            const vector<int> & partners,
+            bool same,
+            double weight);
+
+  //!
+  //! Fill the pairs formed by particles firstRow to lastRow-1 of the first list, as fill() does, and add their number to the
+  //! counts of pairs of this kernel. The rows of the pair loop can thus be split among several kernels.
+  //!
+  void fillRows(const ParticleDigitColumns & particles1,
+                const ParticleDigitColumns & particles2,
+                const vector<int> & partners,
+                bool same,
+                double weight,
+                unsigned int firstRow,
+                unsigned int lastRow);
+
+  //!
+  //! Zero the counts of pairs.
+  //!
+  void resetCounts();
+
+  //!
+  //! Number of pairs filled since the last call to fill() or resetCounts(), in total and with valid eta or y bins.
+  //!
+  long getNPairs() const    { return nPairs;    }
+  long getNPairsEta() const { return nPairsEta; }
+  long getNPairsY() const   { return nPairsY;   }
+
+  //!
+  //! Instruction set used by the kernel.
+  //!
+  InstructionSet getInstructionSet() const
+  {
+  return instructionSet;
+  }
+
+  //!
+  //! Force the instruction set used by the kernel, e.g., the scalar loop for validation. Instruction sets not supported by the
+  //! processor are ignored.
+  //!
+  void setInstructionSet(InstructionSet _instructionSet);
+
+  //!
+  //! Best instruction set supported by the processor.
+  //!
+  static InstructionSet getSupportedInstructionSet();
+
+  static constexpr int maxLanes = 16;
+
+protected:
+
+  //!
+  //! Particle of the first list paired with a block of the second list.
+  //!
+  struct Row
+  {
+    int    iPt;
+    int    iPhi;
+    int    iEta;
+    int    iY;
+    double wpt; // weight times pt
+  };
+
+  //!
+  //! Bin indices (in each order) and weights of the pairs of a block.
+  //!
+  struct alignas(64) Block
+  {
+    int    ptpt[2][maxLanes];
+    int    phiPhi[2][maxLanes];
+    int    etaEta[2][maxLanes];
+    int    DetaDphi[2][maxLanes];
+    int    yY[2][maxLanes];
+    int    DyDphi[2][maxLanes];
+    int    validEta[maxLanes];
+    int    validY[maxLanes];
+    double ptpt_w[maxLanes];
+  };
+
+  void fillRange(const Row & row, const ParticleDigitColumns & particles2, unsigned int first, unsigned int last);
+  void computeScalar(const Row & row, const ParticleDigitColumns & particles2, unsigned int first, unsigned int count);
+  void computeAVX2(const Row & row, const ParticleDigitColumns & particles2, unsigned int first);
+  void computeAVX512(const Row & row, const ParticleDigitColumns & particles2, unsigned int first);
+  void scatter(unsigned int count);
+
+  HistogramBuffer * n2_ptpt;
+  HistogramBuffer * n2_phiPhi;
+  HistogramBuffer * DptDpt_phiPhi;
+  HistogramBuffer * n2_etaEta;
+  HistogramBuffer * DptDpt_etaEta;
+  HistogramBuffer * n2_DetaDphi;
+  HistogramBuffer * DptDpt_DetaDphi;
+  HistogramBuffer * n2_yY;
+  HistogramBuffer * DptDpt_yY;
+  HistogramBuffer * n2_DyDphi;
+  HistogramBuffer * DptDpt_DyDphi;
+  int    nBins_phi;
+  int    nBins_eta;
+  int    nBins_y;
+  int    stride_pt;
+  int    stride_phi;
+  int    stride_eta;
+  int    stride_Deta;
+  int    stride_y;
+  int    stride_Dy;
+  bool   fillEta;
+  bool   fillY;
+  bool   fillP2;
+  bool   same;
+  double weight;
+  long   nPairs;
+  long   nPairsEta;
+  long   nPairsY;
+  InstructionSet instructionSet;
+  unsigned int   nLanes;
+  Block  block;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticlePairKernel */
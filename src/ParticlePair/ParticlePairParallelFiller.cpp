@@ -0,0 +1,140 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "ParticlePairParallelFiller.hpp"
+using CAP::ParticlePairParallelFiller;
+using CAP::ParticlePairKernel;
+using CAP::HistogramBuffer;
+
+ParticlePairParallelFiller::ParticlePairParallelFiller(unsigned int _nThreads, unsigned int _nTilesPerThread)
+:
+pool(_nThreads),
+nTilesPerThread(_nTilesPerThread>0 ? _nTilesPerThread : 1),
+kernels(),
+buffers(),
+used(),
+tiles(),
+partners(),
+targets()
+{
+  // no ops
+}
+
+ParticlePairParallelFiller::~ParticlePairParallelFiller()
+{
+  for (unsigned int iThread=0; iThread<kernels.size(); iThread++)
+    {
+    delete kernels[iThread];
+    for (unsigned int iBuffer=0; iBuffer<buffers[iThread].size(); iBuffer++) delete buffers[iThread][iBuffer];
+    }
+}
+
+void ParticlePairParallelFiller::createThreadKernels(const ParticlePairKernel & model)
+{
+  unsigned int nThreads = pool.getNThreads();
+  model.getBuffers(targets);
+  for (unsigned int iThread=0; iThread<nThreads; iThread++)
+    {
+    vector<HistogramBuffer*> threadBuffers;
+    for (unsigned int iBuffer=0; iBuffer<targets.size(); iBuffer++)
+      {
+      HistogramBuffer * buffer = nullptr;
+      if (targets[iBuffer])
+        {
+        // the buffers are reduced after each fill(): only the bins filled by the thread are added and zeroed
+        buffer = new HistogramBuffer(targets[iBuffer]->getHistogram());
+        buffer->setTrackTouched(true);
+        }
+      threadBuffers.push_back(buffer);
+      }
+    ParticlePairKernel * kernel = new ParticlePairKernel();
+    kernel->setBuffers(model,threadBuffers);
+    kernels.push_back(kernel);
+    buffers.push_back(threadBuffers);
+    }
+  used.assign(nThreads,0);
+}
+
+void ParticlePairParallelFiller::createTiles(unsigned int n1, unsigned int n2, bool same)
+{
+  unsigned int nTiles = pool.getNThreads()*nTilesPerThread;
+  if (nTiles>n1) nTiles = n1;
+  // each row also costs a fixed amount of work, counted as one pair
+  double total  = same ? 0.5*double(n1)*double(n1-1) + double(n1) : double(n1)*double(n2+1);
+  double target = total/double(nTiles);
+  double cumulative = 0.0;
+  tiles.clear();
+  tiles.push_back(0);
+  for (unsigned int iRow=0; iRow<n1 && tiles.size()<nTiles; iRow++)
+    {
+    cumulative += same ? double(n2-iRow) : double(n2+1);
+    if (cumulative>=target*double(tiles.size())) tiles.push_back(iRow+1);
+    }
+  if (tiles.back()!=n1) tiles.push_back(n1);
+}
+
+void ParticlePairParallelFiller::fill(ParticlePairHistos & histos,
+                                      const ParticleDigitColumns & particles1,
+                                      const ParticleDigitColumns & particles2,
+                                      bool same,
+                                      double weight,
+                                      bool mixed)
+{
+  unsigned int n1 = particles1.size();
+  if (n1==0) return;
+  if (kernels.size()==0) createThreadKernels(histos.getKernel());
+  if (mixed)
+    {
+    same = false;
+    partners.assign(n1,-1);
+    }
+  else if (!same)
+    {
+    particles1.getPartners(particles2,partners);
+    }
+  createTiles(n1,particles2.size(),same);
+
+  unsigned int nThreads = kernels.size();
+  for (unsigned int iThread=0; iThread<nThreads; iThread++)
+    {
+    kernels[iThread]->resetCounts();
+    used[iThread] = 0;
+    }
+  pool.execute(tiles.size()-1,[&](unsigned int iThread, unsigned int iTile)
+    {
+    kernels[iThread]->fillRows(particles1,particles2,partners,same,weight,tiles[iTile],tiles[iTile+1]);
+    used[iThread] = 1;
+    });
+
+  // reduce the buffers of the threads, one histogram per item
+  histos.getKernel().getBuffers(targets);
+  pool.execute(targets.size(),[&](unsigned int iThread __attribute__((unused)), unsigned int iBuffer)
+    {
+    if (!targets[iBuffer]) return;
+    for (unsigned int jThread=0; jThread<nThreads; jThread++)
+      {
+      if (!used[jThread]) continue;
+      targets[iBuffer]->add(*buffers[jThread][iBuffer]);
+      buffers[jThread][iBuffer]->reset();
+      }
+    });
+
+  long nPairs    = 0;
+  long nPairsEta = 0;
+  long nPairsY   = 0;
+  for (unsigned int iThread=0; iThread<nThreads; iThread++)
+    {
+    nPairs    += kernels[iThread]->getNPairs();
+    nPairsEta += kernels[iThread]->getNPairsEta();
+    nPairsY   += kernels[iThread]->getNPairsY();
+    }
+  histos.addPairEntries(nPairs,nPairsEta,nPairsY,weight);
+}
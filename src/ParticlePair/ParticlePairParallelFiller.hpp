@@ -0,0 +1,83 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticlePairParallelFiller
+#define CAP__ParticlePairParallelFiller
+#include <vector>
+#include "WorkerPool.hpp"
+#include "ParticlePairHistos.hpp"
+
+namespace CAP
+{
+
+//!
+//! Fills the pairs of a single event on several threads, for events of such high multiplicity that the pair loop dominates
+//! the processing time. The rows of the pair loop, i.e., the particles of the first list, are split into tiles of contiguous rows
+//! holding about the same number of pairs; the triangular pair space of identical lists thus gives tiles of increasing numbers of
+//! rows. The tiles are handed out to the threads of a WorkerPool, several tiles per thread so the load remains balanced. Each thread
+//! fills its own kernel and buffers, which are added to the buffers of the histogram group once all the tiles are done. The thread
+//! buffers track the blocks of bins they fill, so this reduction only visits the bins filled by the pairs of the call.
+//!
+//! A single set of thread buffers is used for all the pair histogram groups of a task, which must therefore all have the same
+//! binning: the memory used is that of one pair histogram group per thread, whatever the number of event and particle filters.
+//! Sums are reduced in a different order than by the serial loop, so the histograms are equal to those of the serial loop
+//! within rounding.
+//!
+class ParticlePairParallelFiller
+{
+public:
+
+  ParticlePairParallelFiller(unsigned int _nThreads, unsigned int _nTilesPerThread=4);
+
+  virtual ~ParticlePairParallelFiller();
+
+  //!
+  //! Fill the pairs of the two given lists in the given histograms, as ParticlePairHistos::fill() does or, if mixed is true, as
+  //! ParticlePairHistos::fillMixed() does.
+  //!
+  void fill(ParticlePairHistos & histos,
+            const ParticleDigitColumns & particles1,
+            const ParticleDigitColumns & particles2,
+            bool same,
+            double weight,
+            bool mixed=false);
+
+  unsigned int getNThreads() const
+  {
+  return pool.getNThreads();
+  }
+
+protected:
+
+  //!
+  //! Create the kernel and buffers of each thread after those of the given kernel.
+  //!
+  void createThreadKernels(const ParticlePairKernel & model);
+
+  //!
+  //! Split the rows of the pair loop into tiles with about the same number of pairs.
+  //!
+  void createTiles(unsigned int n1, unsigned int n2, bool same);
+
+  WorkerPool                           pool;
+  unsigned int                         nTilesPerThread;
+  vector<ParticlePairKernel*>          kernels;   // kernel of each thread
+  vector< vector<HistogramBuffer*> >   buffers;   // buffers of each thread
+  vector<unsigned char>                used;      // whether each thread filled pairs
+  vector<unsigned int>                 tiles;     // first row of each tile, followed by the number of rows
+  vector<int>                          partners;
+  vector<HistogramBuffer*>             targets;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticlePairParallelFiller */
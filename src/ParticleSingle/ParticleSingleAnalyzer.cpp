@@ -28,6 +28,7 @@ EventTask(_name,_configuration)
 //fillP2(false)
 {
   appendClassName("ParticleSingleAnalyzer");
+  eventsReadOnly = true;
 }
 
 void ParticleSingleAnalyzer::setDefaultConfiguration()
@@ -244,29 +245,28 @@ void ParticleSingleAnalyzer::analyzeEvent()
     for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ ) filteredParticles[iParticleFilter].clear();
 
     resetNParticlesAcceptedEvent();
+    const EventColumns & columns = event.getColumns();
+    selectParticles(event);
     for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
       {
-      Particle & particle = * event.getParticleAt(iParticle);
       double  pt,e,phi;
       int iPt, iPhi, iEta, iY;
       ParticleDigit * pd;
       bool digitized = false;
       for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
         {
-        if (particleFilters[iParticleFilter]->accept(particle))
+        if (particleSelections[iParticleFilter]->accepted[iParticle])
           {
           incrementNParticlesAccepted(iEventFilter,iParticleFilter);
           if (!digitized)
             {
-            LorentzVector & momentum = particle.getMomentum();
-            pt     = momentum.Pt();
-            e      = momentum.E();
-            phi    = momentum.Phi();
-            if (phi<0.0) phi += CAP::Math::twoPi();
+            pt     = columns.pt[iParticle];
+            e      = columns.e[iParticle];
+            phi    = columns.phi[iParticle];
             iPt    = histos->getPtBinFor(pt);
             iPhi   = histos->getPhiBinFor(phi);
-            iEta   = histos->getEtaBinFor(momentum.Eta());
-            iY     = histos->getYBinFor(momentum.Rapidity());
+            iEta   = histos->getEtaBinFor(columns.eta[iParticle]);
+            iY     = histos->getYBinFor(columns.y[iParticle]);
             pd     = factory->getNextObject();
             pd->iY   = iY;
             pd->iEta = iEta;
@@ -305,17 +305,16 @@ void ParticleSingleAnalyzer::analyzeEvent()
     int iEventFilter = eventFilterPassed[0];
     int index = iParticleFilter+iEventFilter*nParticleFilters;
    ParticleSingleHistos * histos = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
-   for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+   ParticleView accepted = event.getView(*particleFilters[iParticleFilter]);
+   const EventColumns & columns = accepted.getColumns();
+   for (unsigned int iAccepted=0; iAccepted<accepted.size(); iAccepted++)
       {
-      Particle & particle = * event.getParticleAt(iParticle);
+      Particle & particle = * accepted[iAccepted];
       //particle.printProperties();
-      if (particleFilters[iParticleFilter]->accept(particle))
-        {
-        incrementNParticlesAccepted(0,0);
-        nAccepted[iParticleFilter]++;
-        totalEnergy[iParticleFilter] += particle.getMomentum().E();
-        histos->fill(particle,1.0);
-        }
+      incrementNParticlesAccepted(0,0);
+      nAccepted[iParticleFilter]++;
+      totalEnergy[iParticleFilter] += columns.e[accepted.getPosition(iAccepted)];
+      histos->fill(particle,1.0);
       }
     histos->fillMultiplicity(nAccepted[iParticleFilter],totalEnergy[iParticleFilter],1.0);
     }
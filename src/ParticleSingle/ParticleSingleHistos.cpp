@@ -52,7 +52,16 @@ h_n1_phiEta(nullptr),
 h_spt_phiEta(nullptr),
 h_n1_phiY(nullptr),
 h_spt_phiY(nullptr),
-h_pdgId(nullptr)
+h_pdgId(nullptr),
+b_n1(nullptr),
+b_n1_eTotal(nullptr),
+b_n1_pt(nullptr),
+b_n1_ptXS(nullptr),
+b_n1_phiEta(nullptr),
+b_spt_phiEta(nullptr),
+b_n1_phiY(nullptr),
+b_spt_phiY(nullptr),
+b_pdgId(nullptr)
 {
   appendClassName("ParticleSingleHistos");
 }
@@ -156,6 +165,7 @@ void ParticleSingleHistos::createHistograms()
 
   h_pdgId  = createHistogram(createName(bn,"n1_indexId"),   400,  -0.5, 399.5, "Index", "N");
 
+  createBuffers();
   if ( reportEnd(__FUNCTION__))
     { }
 }
@@ -210,10 +220,24 @@ void ParticleSingleHistos::importHistograms(TFile & inputFile)
 
   h_pdgId  = loadH2(inputFile,  createName(bn,"n1_indexId"));
 
+  createBuffers();
   if (reportEnd(__FUNCTION__))
     ;
 }
 
+void ParticleSingleHistos::createBuffers()
+{
+  b_n1         = createBuffer(h_n1);
+  b_n1_eTotal  = createBuffer(h_n1_eTotal);
+  b_n1_pt      = createBuffer(h_n1_pt);
+  b_n1_ptXS    = createBuffer(h_n1_ptXS);
+  b_n1_phiEta  = createBuffer(h_n1_phiEta);
+  b_spt_phiEta = createBuffer(h_spt_phiEta);
+  b_n1_phiY    = createBuffer(h_n1_phiY);
+  b_spt_phiY   = createBuffer(h_spt_phiY);
+  b_pdgId      = createBuffer(h_pdgId);
+}
+
 void ParticleSingleHistos::loadCalibration(TFile & inputFile)
 {
   if (reportStart(__FUNCTION__))
@@ -265,9 +289,9 @@ void ParticleSingleHistos::loadCalibration(TFile & inputFile)
 //!
 void ParticleSingleHistos::fill(vector<ParticleDigit*> & particles, double weight)
 {
-  double nSingles      = 0;
-  double nSinglesEta   = 0;
-  double nSinglesY     = 0;
+  long   nSingles      = 0;
+  long   nSinglesEta   = 0;
+  long   nSinglesY     = 0;
   double totalEnergy   = 0;
 
   for (unsigned int iPart=0; iPart<particles.size(); iPart++)
@@ -319,48 +343,40 @@ void ParticleSingleHistos::fill(vector<ParticleDigit*> & particles, double weigh
     nSingles++;
     totalEnergy += e;
 
-    int iG = h_n1_pt->GetBin(iPt);
-    h_n1_pt  ->AddBinContent(iG,weight);
-    h_n1_ptXS->AddBinContent(iG,weight/pt);
+    int iG = iPt;
+    b_n1_pt  ->add(iG,weight);
+    b_n1_ptXS->add(iG,weight/pt);
 
     if (fillEta)
       {
-      iG = h_n1_phiEta->GetBin(iEta,iPhi);
-      if (iG<=0)
-        {
-        cout << "iG:" << iG << endl;
-        }
+      iG = b_n1_phiEta->getBin(iEta,iPhi);
       nSinglesEta++;
-      h_n1_phiEta->AddBinContent(iG,weight);
-      if (fillP2) h_spt_phiEta->AddBinContent(iG,weight*pt);
+      b_n1_phiEta->add(iG,weight);
+      if (fillP2) b_spt_phiEta->add(iG,weight*pt);
       }
 
     if (fillY)
       {
-      iG = h_n1_phiY->GetBin(iY,iPhi);
-      if (iG<=0)
-        {
-        cout << "iG:" << iG << endl;
-        }
+      iG = b_n1_phiY->getBin(iY,iPhi);
       nSinglesY++;
-      h_n1_phiY->AddBinContent(iG,weight);
-      if (fillP2) h_spt_phiY->AddBinContent(iG,weight*pt);
+      b_n1_phiY->add(iG,weight);
+      if (fillP2) b_spt_phiY->add(iG,weight*pt);
       }
     }
-  h_n1_pt->SetEntries(h_n1_pt->GetEntries()+nSingles);
-  h_n1_ptXS->SetEntries(h_n1_ptXS->GetEntries()+nSingles);
+  b_n1_pt->addEntries(nSingles);
+  b_n1_ptXS->addEntries(nSingles);
   if (fillEta)
     {
-    h_n1_phiEta->SetEntries(h_n1_phiEta->GetEntries()+nSinglesEta);
-    if (fillP2) h_spt_phiEta->SetEntries(h_spt_phiEta->GetEntries()+nSinglesEta);
+    b_n1_phiEta->addEntries(nSinglesEta);
+    if (fillP2) b_spt_phiEta->addEntries(nSinglesEta);
     }
   if (fillY)
     {
-    h_n1_phiY->SetEntries(h_n1_phiY->GetEntries()+nSinglesY);
-    if (fillP2) h_spt_phiY->SetEntries(h_spt_phiY->GetEntries()+nSinglesY);
+    b_n1_phiY->addEntries(nSinglesY);
+    if (fillP2) b_spt_phiY->addEntries(nSinglesY);
     }
-  h_n1->Fill(nSingles, weight);
-  h_n1_eTotal->Fill(totalEnergy, weight);
+  b_n1->fill(nSingles, weight);
+  b_n1_eTotal->fill(totalEnergy, weight);
 }
 
 //!
@@ -368,12 +384,10 @@ void ParticleSingleHistos::fill(vector<ParticleDigit*> & particles, double weigh
 //!
 void ParticleSingleHistos::fill(Particle & particle, double weight)
 {
-  LorentzVector & momentum = particle.getMomentum();
-  float pt   = momentum.Pt();
-  float eta  = momentum.Eta();
-  float phi  = momentum.Phi();
-  float rapidity = momentum.Rapidity();
-  if (phi<0) phi += CAP::Math::twoPi();
+  float pt   = particle.getPt();
+  float eta  = particle.getEta();
+  float phi  = particle.getPhi();
+  float rapidity = particle.getRapidity();
 
   if (useEffCorrection)
     {
@@ -409,21 +423,21 @@ void ParticleSingleHistos::fill(Particle & particle, double weight)
     if (eff>0) weight /= eff;
     }
 
-  h_n1_pt  ->Fill(pt,weight);
-  h_n1_ptXS->Fill(pt,weight/pt);
+  b_n1_pt  ->fill(pt,weight);
+  b_n1_ptXS->fill(pt,weight/pt);
   if (fillEta)
     {
-    h_n1_phiEta->Fill(eta,phi,weight);
-    if (fillP2) h_spt_phiEta->Fill(eta,phi,weight*pt);
+    b_n1_phiEta->fill(eta,phi,weight);
+    if (fillP2) b_spt_phiEta->fill(eta,phi,weight*pt);
     }
   if (fillY)
     {
-    h_n1_phiY->Fill(rapidity,phi,weight);
-    if (fillP2) h_spt_phiY->Fill(rapidity,phi,weight*pt);
+    b_n1_phiY->fill(rapidity,phi,weight);
+    if (fillP2) b_spt_phiY->fill(rapidity,phi,weight*pt);
     }
 
   double pdgIndex = ParticleDb::getDefaultParticleDb()->findIndexForType(particle.getTypePtr());
-  h_pdgId->Fill(pdgIndex);
+  b_pdgId->fill(pdgIndex,1.0);
 }
 
 //!
@@ -432,6 +446,6 @@ void ParticleSingleHistos::fill(Particle & particle, double weight)
 //!
 void ParticleSingleHistos::fillMultiplicity(double nAccepted, double totalEnergy, double weight)
 {
-  h_n1->Fill(nAccepted, weight);
-  h_n1_eTotal->Fill(totalEnergy, weight);
+  b_n1->fill(nAccepted, weight);
+  b_n1_eTotal->fill(totalEnergy, weight);
 }
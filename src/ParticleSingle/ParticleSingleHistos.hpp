@@ -118,6 +118,26 @@ public:
   TH3 * h_eff_ptPhiEta;
   TH3 * h_eff_ptPhiY;
 
+  // accumulation buffers of the primary histograms, flushed by HistogramGroup::flush()
+  HistogramBuffer * b_n1;
+  HistogramBuffer * b_n1_eTotal;
+  HistogramBuffer * b_n1_pt;
+  HistogramBuffer * b_n1_ptXS;
+  HistogramBuffer * b_n1_phiEta;
+  HistogramBuffer * b_spt_phiEta;
+  HistogramBuffer * b_n1_phiY;
+  HistogramBuffer * b_spt_phiY;
+  HistogramBuffer * b_pdgId;
+
+protected:
+
+  //!
+  //! Create the accumulation buffers of the primary histograms of this group.
+  //!
+  void createBuffers();
+
+public:
+
     ClassDef(ParticleSingleHistos,0)
 
 };
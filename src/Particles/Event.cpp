@@ -10,6 +10,7 @@
  *
  * *********************************************************************/
 #include "Event.hpp"
+#include "ParticleFilter.hpp"
 using CAP::Event;
 using CAP::Particle;
 
@@ -20,6 +21,13 @@ Event::Event()
 eventIndex(0),
 eventNumber(0),
 particles(),
+genealogy(),
+columns(),
+columnsFilled(false),
+columnsMutex(),
+particlesGeneration(1),
+selections(),
+selectionsMutex(),
 eventProperties(new EventProperties() ),
 //b(-9999.0),
 nucleusA(new Nucleus()),
@@ -53,6 +61,9 @@ void Event::clear()
   eventNumber     = 0;
   //b               = -99999;
   particles.clear();
+  genealogy.clear();
+  columns.clear();
+  invalidateColumns();
   if (nucleusA) nucleusA->clear();
   if (nucleusB) nucleusB->clear();
 //  if (binaryMoments) binaryMoments->reset();
@@ -70,6 +81,11 @@ void Event::reset()
   eventNumber   = 0;
   //b             = -99999;
   particles.clear();
+  genealogy.clear();
+  // the relations of the particles of this thread not bound to an event belong to the previous event as well.
+  Particle::getDefaultGenealogy()->clear();
+  columns.clear();
+  invalidateColumns();
   if (nucleusA) nucleusA->reset();
   if (nucleusB) nucleusB->reset();
 //  if (binaryMoments) binaryMoments->reset();
@@ -83,7 +99,33 @@ void Event::reset()
 // ====================================================
 void Event::add(Particle * particle)
 {
+  if (!particle->hasGenealogyIn(&genealogy) &&
+      !(particle->hasGenealogyIn(Particle::getDefaultGenealogy()) && (particle->getNParents()>0 || particle->getNChildren()>0)))
+    particle->setGenealogy(&genealogy);
   particles.push_back(particle);
+  invalidateColumns();
+}
+
+void Event::fillColumns()
+{
+  std::lock_guard<std::mutex> lock(columnsMutex);
+  if (columnsFilled.load(std::memory_order_relaxed)) return;
+  columns.fill(particles);
+  columnsFilled.store(true,std::memory_order_release);
+}
+
+const CAP::ParticleSelection & Event::getSelection(ParticleFilter & filter)
+{
+  const EventColumns & eventColumns = getColumns();
+  std::lock_guard<std::mutex> lock(selectionsMutex);
+  unsigned long generation = particlesGeneration.load(std::memory_order_acquire);
+  ParticleSelection & selection = selections[&filter];
+  if (selection.generation!=generation)
+    {
+    selection.fill(filter,particles,eventColumns);
+    selection.generation = generation;
+    }
+  return selection;
 }
 
 
@@ -92,6 +134,7 @@ Particle* Event::addInteraction(Particle* particleA,
 {
 
   Particle * interaction = Particle::getFactory()->getNextObject();
+  interaction->setGenealogy(&genealogy);
   interaction->setParents(particleA,particleB);
   interaction->setType(ParticleType::getInteractionType());
   interaction->setLive(true);
@@ -192,7 +235,7 @@ void Event::printProperties(ostream & output)
    }
  }
 
-vector<Event*> Event::eventStreamsStore;
+thread_local vector<Event*> Event::eventStreamsStore;
 
 Event * Event::getEventStream(unsigned int index)
 {
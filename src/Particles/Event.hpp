@@ -12,7 +12,14 @@
 #ifndef CAP__Event
 #define CAP__Event
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <map>
 #include "Particle.hpp"
+#include "EventColumns.hpp"
+#include "ParticleSelection.hpp"
+#include "ParticleView.hpp"
+#include "ParticleGenealogy.hpp"
 #include "Nucleus.hpp"
 #include "EventProperties.hpp"
 #include "CollisionGeometryMoments.hpp"
@@ -25,6 +32,8 @@ namespace CAP
 //!
 class Event
 {
+  friend class EventSlot;
+
 protected:
 
   //!
@@ -42,12 +51,15 @@ protected:
   virtual void clear();
 
   //!
-  //! Reset the event as an empty event
+  //! Reset the event as an empty event. The per thread arena of the particles not bound to an event is cleared as well (see
+  //! Particle::setGenealogy()).
   //!
   virtual void reset();
 
   //!
-  //! Add the given particle to this  event
+  //! Add the given particle to this  event. The particle is bound to the genealogy arena of this event, so the relations recorded
+  //! later are cleared along with the event, unless it already holds relations in this arena or in the per thread arena. The
+  //! arena the particle referred to before is not accessed, it may belong to an event deleted since.
   //!
   virtual void add(Particle * particle);
 
@@ -85,6 +97,58 @@ protected:
   //!
   const vector<Particle*> & getParticles() const { return particles;}
 
+  //!
+  //! Return the columnar view of the particles of this event. The view is filled on first use after the particles of the
+  //! event changed. It may be requested concurrently by several analyzers of the same event: only the first fills it.
+  //!
+  const EventColumns & getColumns()
+  {
+  if (!columnsFilled.load(std::memory_order_acquire)) fillColumns();
+  return columns;
+  }
+
+  //!
+  //! Fill the columnar view of the particles of this event, unless it is already up to date. Producers call this method once the
+  //! event is complete so analyzers find the view ready.
+  //!
+  void fillColumns();
+
+  //!
+  //! Mark the columnar view and the particle selections as out of date. Call this method after changing the particles of this event
+  //! in place. Adding particles or resetting the event does it automatically.
+  //!
+  void invalidateColumns()
+  {
+  columnsFilled.store(false,std::memory_order_release);
+  particlesGeneration.fetch_add(1,std::memory_order_acq_rel);
+  }
+
+  //!
+  //! Return the particles of this event accepted by the given filter. The selection is computed on first use after the particles
+  //! of the event changed, and then shared by all the analyzers using the same filter instance. It may be requested concurrently
+  //! by several analyzers of the same event.
+  //!
+  const ParticleSelection & getSelection(ParticleFilter & filter);
+
+  //!
+  //! Return a view of the particles of this event accepted by the given filter. The view refers to the particles, columns, and
+  //! selection of this event and copies none of them. It is valid until the particles of the event change.
+  //!
+  ParticleView getView(ParticleFilter & filter)
+  {
+  const ParticleSelection & selection = getSelection(filter);
+  return ParticleView(&particles,&columns,selection.indices.data(),0,selection.size());
+  }
+
+  //!
+  //! Return a view of all the particles of this event.
+  //!
+  ParticleView getView()
+  {
+  getColumns();
+  return ParticleView(&particles,&columns,nullptr,0,particles.size());
+  }
+
   //!
   //! Return the index of this event. The event index might correspond to the position of the event
   //! in the production or input stream.
@@ -148,6 +212,11 @@ protected:
 //  unsigned int getNNeutronNeutronCollisions() const;
 //  unsigned int getNBinaryCollisions() const           { return nnInteractions.size(); }
 
+  //!
+  //! Arena holding the parent and child relations of the particles of this event. It is cleared by reset() and clear().
+  //!
+  ParticleGenealogy & getGenealogy() { return genealogy; }
+
   EventProperties * getEventProperties() { return eventProperties; }
   EventProperties * getEventProperties() const { return eventProperties; }
 
@@ -173,6 +242,13 @@ protected:
   unsigned long eventIndex;
   unsigned long eventNumber;
   vector<Particle*> particles;
+  ParticleGenealogy genealogy;     //!
+  EventColumns      columns;       //!
+  std::atomic<bool> columnsFilled; //!
+  std::mutex        columnsMutex;  //!
+  std::atomic<unsigned long> particlesGeneration; //! incremented whenever the particles change
+  std::map<const ParticleFilter*,ParticleSelection> selections; //!
+  std::mutex        selectionsMutex; //!
   EventProperties * eventProperties;
   //double b;
   Nucleus * nucleusA;
@@ -180,7 +256,10 @@ protected:
   //CollisionGeometryMoments * binaryMoments;
   //CollisionGeometryMoments * participantMoments;
 
-  static vector<Event*> eventStreamsStore;
+  //!
+  //! Event streams are held per thread: each worker thread of a multi-threaded TaskIterator owns its own streams.
+  //!
+  static thread_local vector<Event*> eventStreamsStore;
 
   ClassDef(Event,0)
 
@@ -0,0 +1,111 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <algorithm>
+#include <cmath>
+#include "EventClassTable.hpp"
+#include "EventFilter.hpp"
+using CAP::EventClassTable;
+
+unsigned int EventClassTable::nTables = 0;
+
+EventClassTable::EventClassTable()
+:
+id(nTables++),
+nClasses(0),
+binned(false),
+uniform(false),
+observableType(0),
+observableIndex(0),
+uniformMinimum(0.0),
+uniformWidth(0.0),
+minima(),
+maxima(),
+classes()
+{
+  // no ops
+}
+
+void EventClassTable::build(const vector<EventFilter*> & filters)
+{
+  nClasses = filters.size();
+  binned   = false;
+  uniform  = false;
+  minima.clear();
+  maxima.clear();
+  classes.clear();
+  if (nClasses<1) return;
+
+  vector<const Condition*> bins;
+  for (unsigned int iFilter=0; iFilter<nClasses; iFilter++)
+    {
+    const vector<Condition*> & conditions = filters[iFilter]->getConditions();
+    if (conditions.size()!=1) return;
+    const Condition * condition = conditions[0];
+    if (dynamic_cast<const ConditionOr*>(condition)) return;
+    if (condition->filterType<10 || condition->filterType>15) return;
+    if (condition->filterSubtype<0) return;
+    if (!(condition->minimum<condition->maximum)) return;
+    if (iFilter>0 && (condition->filterType!=bins[0]->filterType || condition->filterSubtype!=bins[0]->filterSubtype)) return;
+    bins.push_back(condition);
+    }
+  observableType  = bins[0]->filterType;
+  observableIndex = bins[0]->filterSubtype;
+
+  vector<unsigned int> order(nClasses);
+  for (unsigned int k=0; k<nClasses; k++) order[k] = k;
+  std::sort(order.begin(),order.end(),[&bins](unsigned int k1, unsigned int k2) { return bins[k1]->minimum<bins[k2]->minimum; });
+  for (unsigned int k=0; k<nClasses; k++)
+    {
+    minima.push_back(bins[order[k]]->minimum);
+    maxima.push_back(bins[order[k]]->maximum);
+    classes.push_back(order[k]);
+    if (k>0 && minima[k]<maxima[k-1])
+      {
+      // overlapping bins: an event may belong to several classes
+      minima.clear();
+      maxima.clear();
+      classes.clear();
+      return;
+      }
+    }
+  binned = true;
+
+  uniformMinimum = minima[0];
+  uniformWidth   = maxima[0] - minima[0];
+  uniform = true;
+  for (unsigned int k=1; k<nClasses && uniform; k++)
+    {
+    double width = maxima[k] - minima[k];
+    uniform = (minima[k]==maxima[k-1]) && std::fabs(width-uniformWidth)<=1.0E-9*uniformWidth;
+    }
+}
+
+int EventClassTable::classify(const EventProperties & eventProperties) const
+{
+  double value = EventFilter::getObservable(eventProperties,observableType,observableIndex);
+  int bin;
+  if (uniform)
+    {
+    double x = (value-uniformMinimum)/uniformWidth;
+    if (!(x>=0.0)) return -1;
+    bin = (x<nClasses) ? int(x) : nClasses-1;
+    // guard against rounding at the bin edges
+    while (bin>0 && value<minima[bin]) bin--;
+    while (bin<int(nClasses)-1 && value>=maxima[bin]) bin++;
+    }
+  else
+    {
+    bin = int(std::upper_bound(minima.begin(),minima.end(),value) - minima.begin()) - 1;
+    if (bin<0) return -1;
+    }
+  return (value>=minima[bin] && value<maxima[bin]) ? classes[bin] : -1;
+}
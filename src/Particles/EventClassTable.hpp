@@ -0,0 +1,94 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventClassTable
+#define CAP__EventClassTable
+#include <vector>
+
+using std::vector;
+
+namespace CAP
+{
+
+class EventFilter;
+class EventProperties;
+
+//!
+//! Sorted table of the bins of a set of event filters defining event classes, e.g., centrality or multiplicity classes. The table
+//! applies when each filter of the set has a single range condition on the same event observable (condition types 10 to 15) and the
+//! ranges do not overlap. An event is then assigned its class, i.e., the index of the filter accepting it, with a single binary search
+//! on the lower edges of the bins, or with a direct bin computation when the bins are contiguous and of equal widths, rather than
+//! with the evaluation of each filter.
+//!
+//! The class of an event is computed once per event and stored by its EventProperties (see EventProperties::getEventClass()).
+//! Filter sets that do not qualify are not binned (isBinned() returns false) and their filters are evaluated directly.
+//!
+class EventClassTable
+{
+public:
+
+  EventClassTable();
+
+  virtual ~EventClassTable() {}
+
+  //!
+  //! Build the table for the given filters. Filter k defines class k.
+  //!
+  void build(const vector<EventFilter*> & filters);
+
+  //!
+  //! Returns true if the filters of the table define non overlapping bins of a single observable.
+  //!
+  bool isBinned() const
+  {
+  return binned;
+  }
+
+  //!
+  //! Returns the class of an event with the given properties, i.e., the index of the filter accepting it, or -1 if the event
+  //! falls in none of the bins. Must only be called for a binned table.
+  //!
+  int classify(const EventProperties & eventProperties) const;
+
+  //!
+  //! Unique identifier of this table, used by EventProperties to store the class of the event for each table.
+  //!
+  unsigned int getId() const
+  {
+  return id;
+  }
+
+  unsigned int getNClasses() const
+  {
+  return nClasses;
+  }
+
+protected:
+
+  unsigned int   id;
+  unsigned int   nClasses;
+  bool           binned;
+  bool           uniform;        //! bins are contiguous and of equal widths
+  int            observableType;
+  unsigned int   observableIndex;
+  double         uniformMinimum;
+  double         uniformWidth;
+  vector<double> minima;         //! lower edges of the bins, sorted
+  vector<double> maxima;         //! upper edges of the bins
+  vector<int>    classes;        //! class (filter index) of each bin
+
+  static unsigned int nTables;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventClassTable */
@@ -0,0 +1,91 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "EventColumns.hpp"
+using CAP::EventColumns;
+
+EventColumns::EventColumns()
+:
+px(),
+py(),
+pz(),
+e(),
+pt(),
+eta(),
+phi(),
+y(),
+charge(),
+pdg(),
+live(),
+typeIndex()
+{
+  // no ops
+}
+
+void EventColumns::clear()
+{
+  px.clear();
+  py.clear();
+  pz.clear();
+  e.clear();
+  pt.clear();
+  eta.clear();
+  phi.clear();
+  y.clear();
+  charge.clear();
+  pdg.clear();
+  live.clear();
+  typeIndex.clear();
+}
+
+void EventColumns::fill(const vector<Particle*> & particles)
+{
+  unsigned int nParticles = particles.size();
+  px.resize(nParticles);
+  py.resize(nParticles);
+  pz.resize(nParticles);
+  e.resize(nParticles);
+  pt.resize(nParticles);
+  eta.resize(nParticles);
+  phi.resize(nParticles);
+  y.resize(nParticles);
+  charge.resize(nParticles);
+  pdg.resize(nParticles);
+  live.resize(nParticles);
+  typeIndex.resize(nParticles);
+  for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+    {
+    const Particle & particle = *particles[iParticle];
+    const LorentzVector & momentum = particle.getMomentum();
+    px[iParticle]  = momentum.Px();
+    py[iParticle]  = momentum.Py();
+    pz[iParticle]  = momentum.Pz();
+    e[iParticle]   = momentum.E();
+    pt[iParticle]  = particle.getPt();
+    eta[iParticle] = particle.getEta();
+    phi[iParticle] = particle.getPhi();
+    y[iParticle]   = particle.getRapidity();
+    live[iParticle] = particle.isLive() ? 1 : 0;
+    ParticleType * type = particle.getTypePtr();
+    if (type)
+      {
+      charge[iParticle]    = type->getCharge();
+      pdg[iParticle]       = type->getPdgCode();
+      typeIndex[iParticle] = type->getIndex();
+      }
+    else
+      {
+      charge[iParticle]    = 0.0;
+      pdg[iParticle]       = 0;
+      typeIndex[iParticle] = -1;
+      }
+    }
+}
@@ -0,0 +1,71 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventColumns
+#define CAP__EventColumns
+#include <vector>
+#include "Particle.hpp"
+
+namespace CAP
+{
+
+//!
+//! Columnar (structure of arrays) copy of the kinematics and identity of the particles of an event. Element k of each
+//! array describes the particle at position k of the event, so analyzers can loop over contiguous arrays rather than
+//! follow a pointer to each Particle object. The arrays are filled by Event::fillColumns() and must not be modified by analyzers.
+//!
+//! Azimuthal angles are stored in the range [0,2pi[ used by all the histograms of the package. Particles without a type
+//! have charge 0, pdg code 0, and type index -1.
+//!
+class EventColumns
+{
+public:
+
+  EventColumns();
+
+  virtual ~EventColumns() {}
+
+  //!
+  //! Remove all entries. The capacity of the arrays is kept so the next event causes no allocation.
+  //!
+  void clear();
+
+  //!
+  //! Fill the arrays from the given particles.
+  //!
+  void fill(const vector<Particle*> & particles);
+
+  //!
+  //! Number of particles described by the arrays.
+  //!
+  unsigned int size() const
+  {
+  return px.size();
+  }
+
+  vector<double>        px;
+  vector<double>        py;
+  vector<double>        pz;
+  vector<double>        e;
+  vector<double>        pt;
+  vector<double>        eta;
+  vector<double>        phi;
+  vector<double>        y;
+  vector<double>        charge;
+  vector<int>           pdg;
+  vector<unsigned char> live;
+  vector<int>           typeIndex;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventColumns */
@@ -23,7 +23,9 @@ ClassImp(EventFilter);
 //!
 EventFilter::EventFilter()
 :
-Filter<Event>()
+Filter<Event>(),
+classTable(nullptr),
+classIndex(-1)
 {
   // no ops
 }
@@ -37,6 +39,44 @@ EventFilter::~EventFilter()
   // no ops
 }
 
+void EventFilter::setClassTable(EventClassTable * table, int iClass)
+{
+  classTable = (table && table->isBinned()) ? table : nullptr;
+  classIndex = iClass;
+}
+
+double EventFilter::getObservable(const EventProperties & eventProperties, int type, unsigned int index)
+{
+  switch (type)
+    {
+      case 10:
+      // model parameter
+      if (index>=eventProperties.modelParameters.size()) throw TaskException("index>=modelParameters.size()","EventFilter::getObservable()");
+      return eventProperties.modelParameters[index];
+      case 11:
+      // filtered n
+      if (index>=eventProperties.nFiltered.size()) throw TaskException("index>=eventProperties.nFiltered.size()","EventFilter::getObservable()");
+      return eventProperties.nFiltered[index];
+      case 12:
+      // filtered energy
+      if (index>=eventProperties.eFiltered.size()) throw TaskException("index>=eventProperties.eFiltered.size()","EventFilter::getObservable()");
+      return eventProperties.eFiltered[index];
+      case 13:
+      // filtered charge
+      if (index>=eventProperties.qFiltered.size()) throw TaskException("index>=eventProperties.qFiltered.size()","EventFilter::getObservable()");
+      return eventProperties.qFiltered[index];
+      case 14:
+      // filtered strangeness
+      if (index>=eventProperties.sFiltered.size())  throw TaskException("index>=eventProperties.sFiltered.size()","EventFilter::getObservable()");
+      return eventProperties.sFiltered[index];
+      case 15:
+      // filtered baryoness
+      if (index>=eventProperties.bFiltered.size()) throw TaskException("index>=eventProperties.bFiltered.size()","EventFilter::getObservable()");
+      return eventProperties.bFiltered[index];
+    }
+  throw TaskException("Unknown event observable type","EventFilter::getObservable()");
+}
+
 //!
 //! accept/reject the given Event based on filter parameter
 //!
@@ -46,46 +86,12 @@ bool EventFilter::accept(const Event & event)
   if (nComponents<1) return true;
   EventProperties * eventProperties = event.getEventProperties();
   if (!eventProperties) throw TaskException("Event does NOT have properties","EventFilter::accept(const Event & event)");
-  double value;
+  if (classTable) return eventProperties->getEventClass(*classTable)==classIndex;
   for (unsigned int k = 0; k<getNConditions(); k++)
     {
     Condition & condition = *(conditions[k]);
-    unsigned index   = condition.filterSubtype;
-    switch (condition.filterType)
-      {
-        case 10:
-        // model parameter
-        if (index>=eventProperties->modelParameters.size()) throw TaskException("index>=modelParameters.size()","EventFilter::accept(const Event & event)");
-        value = eventProperties->modelParameters[index]; break;
-        case 11:
-        // filtered n
-        if (index>=eventProperties->nFiltered.size()) throw TaskException("index>=eventProperties->nFiltered.size()","EventFilter::accept(const Event & event)");
-        value = eventProperties->nFiltered[index]; break;
-        case 12:
-        // filtered energy
-        if (index>=eventProperties->eFiltered.size()) throw TaskException("index>=eventProperties->eFiltered.size()","EventFilter::accept(const Event & event)");
-        value = eventProperties->eFiltered[index]; break;
-        case 13:
-        // filtered charge
-        if (index>=eventProperties->qFiltered.size()) throw TaskException("index>=eventProperties->qFiltered.size()","EventFilter::accept(const Event & event)");
-        value = eventProperties->qFiltered[index]; break;
-        case 14:
-        // filtered strangeness
-        if (index>=eventProperties->sFiltered.size())  throw TaskException("index>=eventProperties->sFiltered.size()","EventFilter::accept(const Event & event)");
-        value = eventProperties->sFiltered[index]; break;
-        case 15:
-        // filtered baryoness
-        if (index>=eventProperties->bFiltered.size()) throw TaskException("index>=eventProperties->bFiltered.size()","EventFilter::accept(const Event & event)");
-        value = eventProperties->bFiltered[index]; break;
-      }
-//    cout << "            name: " << name << endl;
-//    cout << "      filterType: " <<  condition.filterType << endl;
-//    cout << "   filterSubtype: " <<  condition.filterSubtype << endl;
-//    cout << "       nFiltered: " <<  eventProperties->nFiltered[index] << endl;
-//    cout << "condition accept: " <<  condition.accept(value) << endl;
-
+    double value = getObservable(*eventProperties,condition.filterType,condition.filterSubtype);
     if (!condition.accept(value))  return false;
     }
   return true;
 }
-
@@ -14,6 +14,7 @@
 #define CAP__EventFilter
 #include "Event.hpp"
 #include "Filter.hpp"
+#include "EventClassTable.hpp"
 
 namespace CAP
 {
@@ -26,6 +27,22 @@ public:
   virtual ~EventFilter();
   virtual bool accept(const Event & event);
 
+  //!
+  //! Use the given event class table, in which this filter defines class iClass. Events are then accepted by comparing their class,
+  //! computed once per event, to iClass rather than by evaluating the conditions of this filter. The table is ignored if not binned.
+  //!
+  void setClassTable(EventClassTable * table, int iClass);
+
+  //!
+  //! Returns the value of the event observable selected by the given condition type (10 to 15) and index.
+  //!
+  static double getObservable(const EventProperties & eventProperties, int type, unsigned int index);
+
+protected:
+
+  EventClassTable * classTable; //!
+  int classIndex;               //!
+
   ClassDef(EventFilter,0)
 };
 
@@ -0,0 +1,54 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "EventMixingPool.hpp"
+using CAP::EventMixingPool;
+
+EventMixingPool::EventMixingPool()
+:
+depth(0),
+nLists(0),
+events(),
+nStored(),
+next()
+{
+  // no ops
+}
+
+void EventMixingPool::initialize(unsigned int nClasses, unsigned int _depth, unsigned int _nLists)
+{
+  depth  = _depth;
+  nLists = _nLists;
+  events.assign(nClasses,vector< vector<ParticleDigitColumns> >(depth,vector<ParticleDigitColumns>(nLists)));
+  nStored.assign(nClasses,0);
+  next.assign(nClasses,0);
+}
+
+void EventMixingPool::clear()
+{
+  for (unsigned int iClass=0; iClass<events.size(); iClass++)
+    {
+    for (unsigned int iSlot=0; iSlot<depth; iSlot++)
+      for (unsigned int iList=0; iList<nLists; iList++) events[iClass][iSlot][iList].clear();
+    nStored[iClass] = 0;
+    next[iClass]    = 0;
+    }
+}
+
+void EventMixingPool::add(unsigned int iClass, const vector<ParticleDigitColumns> & lists)
+{
+  if (depth==0) return;
+  vector<ParticleDigitColumns> & slot = events[iClass][next[iClass]];
+  // copy assignment of the columns reuses the capacity of the slot
+  for (unsigned int iList=0; iList<nLists && iList<lists.size(); iList++) slot[iList] = lists[iList];
+  next[iClass] = (next[iClass]+1)%depth;
+  if (nStored[iClass]<depth) nStored[iClass]++;
+}
@@ -0,0 +1,89 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventMixingPool
+#define CAP__EventMixingPool
+#include <vector>
+#include "ParticleDigitColumns.hpp"
+
+namespace CAP
+{
+
+//!
+//! Bounded pool of recent events used to build mixed event pairs. The pool holds, for each event class (e.g., multiplicity or
+//! centrality bin), a ring buffer of the last depth events of that class. An event is stored as a compact snapshot: one
+//! ParticleDigitColumns per particle list (e.g., per particle filter), i.e., bin indices and transverse momenta only, not
+//! Particle objects. Storing an event in a full ring buffer overwrites the oldest event of the class; the arrays of the overwritten
+//! snapshot are reused, so the pool allocates no memory once each slot has held an event of typical multiplicity.
+//!
+class EventMixingPool
+{
+public:
+
+  EventMixingPool();
+
+  virtual ~EventMixingPool() {}
+
+  //!
+  //! Set up the pool for the given number of event classes, with up to depth events of nLists particle lists each per class.
+  //! Any stored event is discarded.
+  //!
+  void initialize(unsigned int nClasses, unsigned int _depth, unsigned int _nLists);
+
+  //!
+  //! Discard all the stored events.
+  //!
+  void clear();
+
+  //!
+  //! Store a snapshot of the given particle lists of an event of the given class.
+  //!
+  void add(unsigned int iClass, const vector<ParticleDigitColumns> & lists);
+
+  //!
+  //! Number of events of the given class currently stored.
+  //!
+  unsigned int getNEvents(unsigned int iClass) const
+  {
+  return nStored[iClass];
+  }
+
+  //!
+  //! Particle lists of stored event k, 0<=k<getNEvents(iClass), of the given class.
+  //!
+  const vector<ParticleDigitColumns> & getEvent(unsigned int iClass, unsigned int k) const
+  {
+  return events[iClass][k];
+  }
+
+  unsigned int getNClasses() const
+  {
+  return events.size();
+  }
+
+  unsigned int getDepth() const
+  {
+  return depth;
+  }
+
+protected:
+
+  unsigned int depth;
+  unsigned int nLists;
+  vector< vector< vector<ParticleDigitColumns> > > events;  // snapshots of each slot of each class
+  vector<unsigned int>                             nStored; // number of events stored in each class
+  vector<unsigned int>                             next;    // slot of each class receiving the next event
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventMixingPool */
@@ -36,7 +36,11 @@ qFiltered(),
 sFiltered(),
 bFiltered(),
 s0Filtered(),
-s1Filtered()
+s1Filtered(),
+generation(1),
+eventClasses(),
+eventClassGenerations(),
+eventClassesMutex()
 {
 // no ops
 }
@@ -62,7 +66,11 @@ qFiltered(source.qFiltered),
 sFiltered(source.sFiltered),
 bFiltered(source.bFiltered),
 s0Filtered(source.s0Filtered),
-s1Filtered(source.s1Filtered)
+s1Filtered(source.s1Filtered),
+generation(1),
+eventClasses(),
+eventClassGenerations(),
+eventClassesMutex()
 {
 // no ops
 }
@@ -91,6 +99,7 @@ EventProperties & EventProperties::operator=(const EventProperties & source)
     bFiltered          =  source.bFiltered;
     s0Filtered         =  source.s0Filtered;
     s1Filtered         =  source.s1Filtered;
+    generation++;
     }
   return *this;
 }
@@ -117,6 +126,7 @@ void EventProperties::clear()
   bFiltered.clear();
   s0Filtered.clear();
   s1Filtered.clear();
+  generation++;
 }
 
 void EventProperties::reset()
@@ -141,6 +151,7 @@ void EventProperties::reset()
   bFiltered.clear();
   s0Filtered.clear();
   s1Filtered.clear();
+  generation++;
 }
 
 void EventProperties::fill(vector<double> & n,  // number of particles accepted by filter #i
@@ -160,14 +171,34 @@ void EventProperties::fill(vector<double> & n,  // number of particles accepted
     sFiltered.push_back(    s[iFilter] );
     bFiltered.push_back(    b[iFilter] );
     }
+  generation++;
 }
 
 void EventProperties::fillSpherocity(vector<double> & s0, vector<double> & s1)
 {
   for (unsigned int iFilter=0; iFilter<s0.size(); iFilter++) s0Filtered.push_back( s0[iFilter] );
   for (unsigned int iFilter=0; iFilter<s1.size(); iFilter++) s1Filtered.push_back( s1[iFilter] );
+  generation++;
 }
 
+int EventProperties::getEventClass(const EventClassTable & table)
+{
+  std::lock_guard<std::mutex> lock(eventClassesMutex);
+  unsigned int id = table.getId();
+  if (id>=eventClasses.size())
+    {
+    eventClasses.resize(id+1,-1);
+    eventClassGenerations.resize(id+1,0);
+    }
+  if (eventClassGenerations[id]!=generation)
+    {
+    eventClasses[id]          = table.classify(*this);
+    eventClassGenerations[id] = generation;
+    }
+  return eventClasses[id];
+}
+
+
 
 void EventProperties::printProperties(ostream & output)
 {
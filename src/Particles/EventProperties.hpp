@@ -13,8 +13,10 @@
 #ifndef EventProperties_hpp
 #define EventProperties_hpp
 #include <vector>
+#include <mutex>
 #include "Particle.hpp"
 #include "ParticleType.hpp"
+#include "EventClassTable.hpp"
 
 using std::vector;
 
@@ -44,6 +46,22 @@ public:
 
   virtual void fillSpherocity(vector<double> & s0,
                               vector<double> & s1);
+
+  //!
+  //! Returns the class of this event in the given event class table (see EventClassTable::classify()). The class is computed on first
+  //! use after the properties were reset or filled, and then shared by all the filters and analyzers using the same table. It may be
+  //! requested concurrently by several analyzers of the same event.
+  //!
+  int getEventClass(const EventClassTable & table);
+
+  //!
+  //! Mark the event classes as out of date. Call this method after changing the data members of this object directly rather
+  //! than with reset(), clear(), or the fill methods.
+  //!
+  void invalidateEventClasses()
+  {
+  generation++;
+  }
   
   // ================================================
   // Data Members
@@ -81,6 +99,16 @@ public:
   vector<double> s0Filtered;  // transverse spherocity
   vector<double> s1Filtered;  // transverse spherocity w/ unig vector
 
+protected:
+
+  // Event classes
+  unsigned long         generation;            //! incremented whenever the properties are reset or filled
+  vector<int>           eventClasses;          //! class of the event for each EventClassTable, by table id
+  vector<unsigned long> eventClassGenerations; //! generation of the properties each class was computed for
+  std::mutex            eventClassesMutex;     //!
+
+public:
+
   ClassDef(EventProperties,0)
 
 };
@@ -0,0 +1,34 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "EventSlot.hpp"
+using CAP::EventSlot;
+
+EventSlot::EventSlot(unsigned int nStreams, int factoryCapacity)
+:
+PipelineSlot(),
+events(),
+particleFactory(new Factory<Particle>())
+{
+  for (unsigned int iStream=0; iStream<nStreams; iStream++)
+    {
+    Event * event = new Event();
+    event->setStreamIndex(iStream);
+    events.push_back(event);
+    }
+  particleFactory->initialize(factoryCapacity);
+}
+
+EventSlot::~EventSlot()
+{
+  for (unsigned int iStream=0; iStream<events.size(); iStream++) delete events[iStream];
+  delete particleFactory;
+}
@@ -0,0 +1,66 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventSlot
+#define CAP__EventSlot
+#include <vector>
+#include "PipelineSlot.hpp"
+#include "Factory.hpp"
+#include "Event.hpp"
+
+namespace CAP
+{
+
+//!
+//! Pipeline slot holding one event per stream and the particle factory the particles of these events are taken from.
+//! Slots are recycled by a pipelined TaskIterator: the producer stage fills the events of a free slot while the consumer
+//! stage analyzes the events of slots filled earlier. Each slot owns its factory so the particles of an event are not
+//! overwritten while the event waits in the queue.
+//!
+class EventSlot : public PipelineSlot
+{
+public:
+
+  //!
+  //! CTOR. Allocate nStreams events and a particle factory of the given initial capacity.
+  //!
+  EventSlot(unsigned int nStreams=4, int factoryCapacity=5000);
+
+  virtual ~EventSlot();
+
+  //!
+  //! Returns the event of the given stream held by this slot.
+  //!
+  Event * getEvent(unsigned int streamIndex)
+  {
+  return events[streamIndex];
+  }
+
+  unsigned int getNEvents() const
+  {
+  return events.size();
+  }
+
+  Factory<Particle> * getParticleFactory()
+  {
+  return particleFactory;
+  }
+
+protected:
+
+  vector<Event*> events;
+  Factory<Particle> * particleFactory;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventSlot */
@@ -42,6 +42,7 @@ eventsUseStream0         (false),
 eventsUseStream1         (false),
 eventsUseStream2         (false),
 eventsUseStream3         (false),
+eventsReadOnly           (false),
 eventsAnalyze            (false),
 filtersUseModel          (false),
 filtersUseGlobal         (false),
@@ -65,6 +66,7 @@ nEventFilters(0),
 nParticleFilters(0),
 eventFilters(),
 particleFilters(),
+particleSelections(),
 nEventsAccepted(),
 nEventsAcceptedTotal(),
 nParticlesAcceptedEvent(),
@@ -101,6 +103,7 @@ eventsUseStream0         (false),
 eventsUseStream1         (false),
 eventsUseStream2         (false),
 eventsUseStream3         (false),
+eventsReadOnly           (false),
 eventsAnalyze            (false),
 filtersUseModel          (false),
 filtersUseGlobal         (false),
@@ -124,6 +127,7 @@ nEventFilters(0),
 nParticleFilters(0),
 eventFilters(),
 particleFilters(),
+particleSelections(),
 nEventsAccepted(),
 nEventsAcceptedTotal(),
 nParticlesAcceptedEvent(),
@@ -289,6 +293,11 @@ void EventTask::initializeFilters()
     }
   nEventFilters    = eventFilters.size();
   nParticleFilters = particleFilters.size();
+  // filters shared by several tasks are already compiled by FilterCreator and must not be rewritten here
+  for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++)
+    {
+    if (!particleFilters[iParticleFilter]->isCompiled()) particleFilters[iParticleFilter]->compile(particleDb);
+    }
   if (reportInfo(__FUNCTION__))
     {
     cout << endl;
@@ -425,8 +434,17 @@ void EventTask::finalize()
   if (eventsCreate)  finalizeEventGenerator();
   if (eventsImport)  finalizeEventReader();
   if (eventsExport)  finalizeEventWriter();
-  if (histosScale && !histosExportPartial)  scaleHistograms();
-  if (histosExport&& !histosExportPartial)  exportHistograms();
+  flushHistograms();
+  if (histosScale && !histosExportPartial)
+    {
+    TaskProfileScope scope(profile,TaskProfile::ScaleHistograms);
+    scaleHistograms();
+    }
+  if (histosExport&& !histosExportPartial)
+    {
+    TaskProfileScope scope(profile,TaskProfile::ExportHistograms);
+    exportHistograms();
+    }
   if (reportInfo(__FUNCTION__)) cout << "Check if rootInputFile is open and close it" << endl;
   if (rootInputFile && rootInputFile->IsOpen())  
     {
@@ -470,6 +488,17 @@ void EventTask::analyzeEvent()
 
 }
 
+void EventTask::analyzeEvents(const vector<Event*> & events)
+{
+  Event * stream0 = eventStreams[0];
+  for (unsigned int iEvent=0; iEvent<events.size(); iEvent++)
+    {
+    eventStreams[0] = events[iEvent];
+    analyzeEvent();
+    }
+  eventStreams[0] = stream0;
+}
+
 void EventTask::exportEvent()
 {
   if (eventsCreateCAP || eventsConvertToCAP || eventsExportCAP)
@@ -488,10 +517,26 @@ void EventTask::execute()
   if (eventsImport)  importEvent();
   if (eventsCreate)  createEvent();
   if (eventsAnalyze) analyzeEvent();
+  // producers, and tasks other than read only analyzers, may have changed the particles of the events in place. The columnar
+  // view is refreshed here, once, so the analyzers that follow (possibly running concurrently) only read it. Only the streams
+  // this task writes are refreshed: the other streams may be read meanwhile by tasks of the same level (see
+  // TaskIterator::buildTaskLevels()).
+  if (!eventsReadOnly || eventsImport || eventsCreate) refreshColumns();
   if (eventsExport)  exportEvent();
   if (hasSubTasks()) executeSubTasks();
 }
 
+void EventTask::refreshColumns()
+{
+  unsigned int written = getDataWritten();
+  for (unsigned int iStream=0; iStream<eventStreams.size(); iStream++)
+    {
+    if (!(written & getStreamData(iStream))) continue;
+    eventStreams[iStream]->invalidateColumns();
+    eventStreams[iStream]->fillColumns();
+    }
+}
+
 
 //!
 //! Reset this Task instance. Implement this method in a derived class if the functionality provided in this base class is insufficient.
@@ -525,6 +570,159 @@ void EventTask::clear()
 }
 
 
+//!
+//! Merge the given replica into this Task instance. The replica is expected to be reset after each merge so its accepted event
+//! and particle counts are the increments since the last merge.
+//!
+void EventTask::mergeHistograms(Task & source)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  EventTask & replica = dynamic_cast<EventTask&>(source);
+  if (replica.nEventFilters!=nEventFilters || replica.nParticleFilters!=nParticleFilters)
+    throw TaskException("Replica has a different number of filters.","EventTask::mergeHistograms(Task & source)");
+  Task::mergeHistograms(source);
+  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++)
+    {
+    nEventsAccepted[iEventFilter]      += replica.nEventsAccepted[iEventFilter];
+    nEventsAcceptedTotal[iEventFilter] += replica.nEventsAccepted[iEventFilter];
+    }
+  unsigned int n = nParticlesAcceptedTotal.size();
+  for (unsigned int k=0; k<n; k++) nParticlesAcceptedTotal[k] += replica.nParticlesAcceptedTotal[k];
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void EventTask::executeBatch(const vector<PipelineSlot*> & slots)
+{
+  if (!eventsAnalyze || eventsImport || eventsCreate || eventsExport || hasSubTasks() || eventStreams.size()!=1)
+    {
+    Task::executeBatch(slots);
+    return;
+    }
+  batchEvents.clear();
+  for (unsigned int iSlot=0; iSlot<slots.size(); iSlot++)
+    {
+    setPipelineSlot(slots[iSlot]);
+    batchEvents.push_back(eventStreams[0]);
+    incrementTaskExecuted();
+    }
+  analyzeEvents(batchEvents);
+  // as in execute(), the events changed by an analyzer that is not read only are refreshed for the consumers that follow.
+  if (!eventsReadOnly)
+    {
+    for (unsigned int iSlot=0; iSlot<slots.size(); iSlot++)
+      {
+      setPipelineSlot(slots[iSlot]);
+      refreshColumns();
+      }
+    }
+}
+
+unsigned int EventTask::getEventStreamsData() const
+{
+  unsigned int data = 0;
+  if (eventsUseStream0) data |= getStreamData(0) | getPropertiesData(0);
+  if (eventsUseStream1) data |= getStreamData(1) | getPropertiesData(1);
+  if (eventsUseStream2) data |= getStreamData(2) | getPropertiesData(2);
+  if (eventsUseStream3) data |= getStreamData(3) | getPropertiesData(3);
+  return data;
+}
+
+unsigned int EventTask::getDataRead() const
+{
+  if (!eventsReadOnly || eventsImport || eventsCreate || eventsExport || hasSubTasks()) return AllData;
+  return getEventStreamsData();
+}
+
+unsigned int EventTask::getDataWritten() const
+{
+  if (!eventsReadOnly || eventsImport || eventsCreate || eventsExport || hasSubTasks()) return AllData;
+  return 0;
+}
+
+void EventTask::saveCheckpoint(TDirectory & directory)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  Task::saveCheckpoint(directory);
+  for (unsigned int k=0; k<nEventsAccepted.size(); k++)
+    {
+    writeParameter(directory,Form("nEventsAccepted%d",k),     nEventsAccepted[k]);
+    writeParameter(directory,Form("nEventsAcceptedTotal%d",k),nEventsAcceptedTotal[k]);
+    }
+  for (unsigned int k=0; k<nParticlesAccepted.size(); k++)
+    {
+    writeParameter(directory,Form("nParticlesAccepted%d",k),     nParticlesAccepted[k]);
+    writeParameter(directory,Form("nParticlesAcceptedTotal%d",k),nParticlesAcceptedTotal[k]);
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void EventTask::loadCheckpoint(TDirectory & directory)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  Task::loadCheckpoint(directory);
+  for (unsigned int k=0; k<nEventsAccepted.size(); k++)
+    {
+    nEventsAccepted[k]      = readParameter(directory,Form("nEventsAccepted%d",k));
+    nEventsAcceptedTotal[k] = readParameter(directory,Form("nEventsAcceptedTotal%d",k));
+    }
+  for (unsigned int k=0; k<nParticlesAccepted.size(); k++)
+    {
+    nParticlesAccepted[k]      = readParameter(directory,Form("nParticlesAccepted%d",k));
+    nParticlesAcceptedTotal[k] = readParameter(directory,Form("nParticlesAcceptedTotal%d",k));
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+bool EventTask::isPipelineProducer() const
+{
+  return eventsCreate || eventsImport;
+}
+
+PipelineSlot * EventTask::createPipelineSlot()
+{
+  return new EventSlot(4,Particle::factorySize);
+}
+
+void EventTask::setPipelineSlot(PipelineSlot * slot)
+{
+  eventStreams.clear();
+  if (!slot)
+    {
+    initializeEventStreams();
+    initializeParticleFactory();
+    return;
+    }
+  EventSlot * eventSlot = dynamic_cast<EventSlot*>(slot);
+  if (!eventSlot) throw TaskException("Given slot is not an EventSlot.","EventTask::setPipelineSlot(PipelineSlot * slot)");
+  if (eventsUseStream0)  addEventStream(eventSlot->getEvent(0));
+  if (eventsUseStream1)  addEventStream(eventSlot->getEvent(1));
+  if (eventsUseStream2)  addEventStream(eventSlot->getEvent(2));
+  if (eventsUseStream3)  addEventStream(eventSlot->getEvent(3));
+  particleFactory = eventSlot->getParticleFactory();
+}
+
+long EventTask::getNParticlesProcessed() const
+{
+  long n = 0;
+  for (unsigned int k=0; k<nParticlesAcceptedTotal.size(); k++) n += nParticlesAcceptedTotal[k];
+  return n;
+}
+
+void EventTask::selectParticles(Event & event)
+{
+  particleSelections.resize(nParticleFilters);
+  for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++)
+    {
+    particleSelections[iParticleFilter] = &event.getSelection(*particleFilters[iParticleFilter]);
+    }
+}
+
 void EventTask::initializeNParticlesAccepted()
 {
   int n = nEventFilters*nParticleFilters;
@@ -18,6 +18,7 @@
 #include "ParticleType.hpp"
 #include "ParticleDb.hpp"
 #include "HistogramGroup.hpp"
+#include "EventSlot.hpp"
 
 namespace CAP
 {
@@ -55,6 +56,7 @@ protected:
   bool   eventsUseStream1;
   bool   eventsUseStream2;
   bool   eventsUseStream3;
+  bool   eventsReadOnly; //!
   bool   eventsAnalyze;
   bool   filtersUseModel;
   bool   filtersUseGlobal;
@@ -107,6 +109,11 @@ protected:
   //!
   vector<ParticleFilter*>  particleFilters;
 
+  //!
+  //! Selections of the particles of the current event by each of the particle filters, set by selectParticles().
+  //!
+  vector<const ParticleSelection*> particleSelections; //!
+
 
   //!
   //! Array of filter particles (ParticleDigits).
@@ -139,6 +146,11 @@ protected:
   //!
   vector<long> nParticlesAcceptedTotal;
 
+  //!
+  //! Events of the block being executed by executeBatch().
+  //!
+  vector<Event*> batchEvents; //!
+
 public:
 
   //!
@@ -224,6 +236,18 @@ public:
   virtual void createEvent();
   virtual void analyzeEvent();
 
+  //!
+  //! Analyze the given block of events. The base class implementation points event stream 0 to each event in turn and calls
+  //! analyzeEvent(). Analyzers may override this method to set up once per block what analyzeEvent() sets up for every event.
+  //!
+  virtual void analyzeEvents(const vector<Event*> & events);
+
+  //!
+  //! Refresh the columnar view of the event streams written by this task (see getDataWritten()) after their particles may have
+  //! been changed in place.
+  //!
+  void refreshColumns();
+
   //!
   //! Reset this Task instance. Implement this method in a derived class if the functionality provided in this base class is insufficient.
   //!
@@ -234,6 +258,65 @@ public:
   //!
   virtual void clear();
 
+  //!
+  //! Add the histograms, execution counters, and accepted event and particle counters of the given replica to those of this Task instance.
+  //!
+  virtual void mergeHistograms(Task & source);
+
+  //!
+  //! Save the histograms, execution counters, and accepted event and particle counters of this Task instance in the given directory.
+  //!
+  virtual void saveCheckpoint(TDirectory & directory);
+
+  //!
+  //! Restore the histograms and counters saved by saveCheckpoint().
+  //!
+  virtual void loadCheckpoint(TDirectory & directory);
+
+  //!
+  //! Returns true if this task creates or imports events, i.e., if it belongs to the producer stage of a pipelined TaskIterator.
+  //!
+  virtual bool isPipelineProducer() const;
+
+  //!
+  //! Create an EventSlot holding one event per stream and its own particle factory.
+  //!
+  virtual PipelineSlot * createPipelineSlot();
+
+  //!
+  //! Use the events and particle factory of the given EventSlot for the next call to execute(). A null pointer restores
+  //! the event streams and particle factory set at initialization.
+  //!
+  virtual void setPipelineSlot(PipelineSlot * slot);
+
+  //!
+  //! Execute this task on the events of the given slots. Tasks that only analyze events from a single stream pass the whole block
+  //! to analyzeEvents(). Other tasks are executed once per slot.
+  //!
+  virtual void executeBatch(const vector<PipelineSlot*> & slots);
+
+  //!
+  //! Returns the bit mask of the event streams used by this task and of their EventProperties.
+  //!
+  unsigned int getEventStreamsData() const;
+
+  //!
+  //! Returns the data read by this task. Tasks flagged as read only (eventsReadOnly) that neither import, create, nor export
+  //! events, and have no subtasks, read the event streams they use and their properties. Other tasks return AllData.
+  //!
+  virtual unsigned int getDataRead() const;
+
+  //!
+  //! Returns the data written by this task: nothing for read only tasks, AllData otherwise.
+  //!
+  virtual unsigned int getDataWritten() const;
+
+  //!
+  //! Get the selections of the particles of the given event by each of the particle filters used by this task. The selections are
+  //! computed once per event and filter instance, and shared with the other tasks using the same filters (see Event::getSelection()).
+  //!
+  void selectParticles(Event & event);
+
   virtual void initializeNParticlesAccepted();
   virtual void incrementNParticlesAccepted(int iEventFilter=0, int iParticleFilter=0);
   virtual void resetNParticlesAcceptedEvent();
@@ -241,6 +324,11 @@ public:
   virtual void clearNParticlesAccepted();
   virtual int getNParticlesAccepted(int iEventFilter=0, int iParticleFilter=0)  const;
   virtual int getNParticlesAcceptedTotal(int iEventFilter=0, int iParticleFilter=0) const;
+
+  //!
+  //! Number of particles accepted by this task, summed over all event and particle filters.
+  //!
+  virtual long getNParticlesProcessed() const;
   //!
   //! Scale (all) the histograms held in all the histogram groups owned by this Task instance. This operation is executed automatically within the finalize() method call if
   //! and only if the HistogramsScale parameter of the Configuration instance controlling this Task is set to "true".
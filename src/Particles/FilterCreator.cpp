@@ -141,10 +141,19 @@ void FilterCreator::initialize()
   createEventFilters(0);
   createEventFilters(1);
   createEventFilters(2);
+  eventClassTableModel    = createEventClassTable(*eventFiltersModel);
+  eventClassTableGlobal   = createEventClassTable(*eventFiltersGlobal);
+  eventClassTableAnalysis = createEventClassTable(*eventFiltersAnalysis);
   createParticleFilterContainers();
   createParticleFilters(0);
   createParticleFilters(1);
   createParticleFilters(2);
+  speciesTableModel    = createSpeciesTable(*particleFiltersModel,particleDb);
+  speciesTableGlobal   = createSpeciesTable(*particleFiltersGlobal,particleDb);
+  speciesTableAnalysis = createSpeciesTable(*particleFiltersAnalysis,particleDb);
+  compileParticleFilters(*particleFiltersModel);
+  compileParticleFilters(*particleFiltersGlobal);
+  compileParticleFilters(*particleFiltersAnalysis);
 
   if (particleFiltersAnalysis->size()<1)
     {
@@ -196,6 +205,12 @@ vector<EventFilter*>    * FilterCreator::eventFiltersGlobal = nullptr;
 vector<ParticleFilter*> * FilterCreator::particleFiltersGlobal = nullptr;
 vector<EventFilter*>    * FilterCreator::eventFiltersAnalysis = nullptr;
 vector<ParticleFilter*> * FilterCreator::particleFiltersAnalysis = nullptr;
+ParticleSpeciesTable * FilterCreator::speciesTableModel    = nullptr;
+ParticleSpeciesTable * FilterCreator::speciesTableGlobal   = nullptr;
+ParticleSpeciesTable * FilterCreator::speciesTableAnalysis = nullptr;
+EventClassTable      * FilterCreator::eventClassTableModel    = nullptr;
+EventClassTable      * FilterCreator::eventClassTableGlobal   = nullptr;
+EventClassTable      * FilterCreator::eventClassTableAnalysis = nullptr;
 
 void FilterCreator::createEventFilterContainers()
 {
@@ -478,6 +493,36 @@ vector<ParticleFilter*> & FilterCreator::getParticleFiltersAnalysis()
   return *particleFiltersAnalysis;
 }
 
+ParticleSpeciesTable * FilterCreator::createSpeciesTable(const vector<ParticleFilter*> & filters, ParticleDb * particleDb)
+{
+  ParticleSpeciesTable * table = new ParticleSpeciesTable();
+  table->build(filters,particleDb);
+  for (unsigned int iFilter=0; iFilter<filters.size(); iFilter++)
+    {
+    filters[iFilter]->setSpeciesTable(table,iFilter);
+    }
+  return table;
+}
+
+EventClassTable * FilterCreator::createEventClassTable(const vector<EventFilter*> & filters)
+{
+  EventClassTable * table = new EventClassTable();
+  table->build(filters);
+  for (unsigned int iFilter=0; iFilter<filters.size(); iFilter++)
+    {
+    filters[iFilter]->setClassTable(table,iFilter);
+    }
+  return table;
+}
+
+void FilterCreator::compileParticleFilters(const vector<ParticleFilter*> & filters)
+{
+  for (unsigned int iFilter=0; iFilter<filters.size(); iFilter++)
+    {
+    filters[iFilter]->compile(particleDb);
+    }
+}
+
 vector<ParticleFilter*> FilterCreator::createOpenParticleFilter()
 {
   vector<ParticleFilter*> filters;
@@ -67,6 +67,24 @@ public:
   static vector<ParticleFilter*> & getParticleFiltersGlobal();
   static vector<ParticleFilter*> &  getParticleFiltersAnalysis();
 
+  //!
+  //! Create the species table of the given filters: a table, indexed by ParticleType index, of the bit mask of the filters each
+  //! type of the given db belongs to. The filters are set to use the table (bit k for filter k) when they are compiled.
+  //!
+  static ParticleSpeciesTable * createSpeciesTable(const vector<ParticleFilter*> & filters, ParticleDb * particleDb);
+
+  //!
+  //! Compile the given filters against the particle db of this task. The filters are shared by all the tasks, and threads, that use
+  //! them, so they are compiled here once rather than by each task.
+  //!
+  void compileParticleFilters(const vector<ParticleFilter*> & filters);
+
+  //!
+  //! Create the event class table of the given event filters and set the filters to use it when the filters define non overlapping
+  //! bins (e.g., centrality or multiplicity classes) of a single event observable.
+  //!
+  static EventClassTable * createEventClassTable(const vector<EventFilter*> & filters);
+
   //!
   //!  Create an open filter i.e., a filter that accepts all particles considered "live".
   //!
@@ -182,6 +200,12 @@ protected:
   static vector<ParticleFilter*> * particleFiltersGlobal;
   static vector<EventFilter*>    * eventFiltersAnalysis;
   static vector<ParticleFilter*> * particleFiltersAnalysis;
+  static ParticleSpeciesTable    * speciesTableModel;
+  static ParticleSpeciesTable    * speciesTableGlobal;
+  static ParticleSpeciesTable    * speciesTableAnalysis;
+  static EventClassTable         * eventClassTableModel;
+  static EventClassTable         * eventClassTableGlobal;
+  static EventClassTable         * eventClassTableAnalysis;
 
   ClassDef(FilterCreator,0)
 };
@@ -19,10 +19,11 @@ Nucleus::Nucleus()
 :
 Particle(),
 nProtons(0),
-nNeutrons(0)
+nNeutrons(0),
+nucleons()
 {
   type = ParticleType::getNucleusType();
-  children.push_back(Particle::getProton());
+  nucleons.push_back(Particle::getProton());
   nProtons  = 1;
   nNeutrons = 0;
   live      = false;
@@ -32,7 +33,8 @@ Nucleus::Nucleus(const Nucleus & otherNucleus)
 :
 Particle(otherNucleus),
 nProtons(otherNucleus.nProtons),
-nNeutrons(otherNucleus.nNeutrons)
+nNeutrons(otherNucleus.nNeutrons),
+nucleons(otherNucleus.nucleons)
 {
  // no ops
 }
@@ -44,6 +46,7 @@ Nucleus & Nucleus::operator=(const Nucleus & otherNucleus)
     Particle::operator=(otherNucleus);
     nProtons  = otherNucleus.nProtons;
     nNeutrons = otherNucleus.nNeutrons;
+    nucleons  = otherNucleus.nucleons;
     }
   return *this;
 }
@@ -64,14 +67,14 @@ void Nucleus::defineAs(unsigned int z, unsigned int a)
   type = ParticleType::getNucleusType();
   nProtons  = 0;
   nNeutrons = 0;
-  children.clear();
+  nucleons.clear();
   for (unsigned int iNucleon=0; iNucleon<z; iNucleon++)
     {
-    children.push_back(Particle::getProton()); nProtons++;
+    nucleons.push_back(Particle::getProton()); nProtons++;
     }
   for (unsigned int iNucleon=0; iNucleon<(a-z); iNucleon++)
     {
-    children.push_back(Particle::getNeutron()); nNeutrons++;
+    nucleons.push_back(Particle::getNeutron()); nNeutrons++;
     }
 }
 
@@ -87,12 +90,12 @@ void Nucleus::reset()
 {
   momentum.SetPxPyPzE (0.0,0.0,0.0,0.0);
   position.SetXYZT    (0.0,0.0,0.0,0.0);
-  parents.clear();
+  nParents = 0;
 
-  for (unsigned int iNucleon=0; iNucleon<children.size(); iNucleon++)
+  for (unsigned int iNucleon=0; iNucleon<nucleons.size(); iNucleon++)
     {
-    children[iNucleon]->reset();
-    children[iNucleon]->setWounded(false);;
+    nucleons[iNucleon]->reset();
+    nucleons[iNucleon]->setWounded(false);;
     }
   live = true;
 }
@@ -100,9 +103,9 @@ void Nucleus::reset()
 unsigned int Nucleus::countWounded()
 {
   unsigned int wounded = 0;
-  for (unsigned int iNucleon=0; iNucleon<children.size(); iNucleon++)
+  for (unsigned int iNucleon=0; iNucleon<nucleons.size(); iNucleon++)
     {
-    wounded += children[iNucleon]->isWounded();
+    wounded += nucleons[iNucleon]->isWounded();
     }
   return wounded;
 }
@@ -110,9 +113,9 @@ unsigned int Nucleus::countWounded()
 vector<Particle*> Nucleus::getWoundedNucleons()
 {
   vector<Particle*> woundedNucleons;
-  for (unsigned int iNucleon=0; iNucleon<children.size(); iNucleon++)
+  for (unsigned int iNucleon=0; iNucleon<nucleons.size(); iNucleon++)
     {
-    Particle * nucleon = children[iNucleon];
+    Particle * nucleon = nucleons[iNucleon];
      if (nucleon->isWounded())
        {
        woundedNucleons.push_back(nucleon);
@@ -42,10 +42,15 @@ public:
 
   Particle * getNucleonAt(unsigned int index)
   {
-  if (index>=children.size())
+  if (index>=nucleons.size())
     return nullptr;
   else
-   return children[index];
+   return nucleons[index];
+  }
+
+  const vector<Particle*> & getNucleons() const
+  {
+  return nucleons;
   }
 
   unsigned int getNProtons() const
@@ -68,6 +73,12 @@ protected:
   unsigned int nProtons;
   unsigned int nNeutrons;
 
+  //!
+  //! Nucleons of this nucleus. They are owned by the nucleus and persist from event to event, so they are not recorded as
+  //! children in the genealogy arena of an event.
+  //!
+  vector<Particle*> nucleons;
+
   ClassDef(Nucleus,0)
   
 };
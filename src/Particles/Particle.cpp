@@ -11,9 +11,11 @@
  * *********************************************************************/
 #include <ostream>
 #include "Factory.hpp"
+#include "MathConstants.hpp"
 #include "Particle.hpp"
 using CAP::Factory;
 using CAP::Particle;
+using CAP::ParticleGenealogy;
 
 ClassImp(Factory<Particle>);
 
@@ -24,8 +26,12 @@ Particle::Particle()
 momentum (),
 position (),
 type     (nullptr),
-parents  (),
-children (),
+genealogy(nullptr),
+genealogyGeneration(0),
+firstParent(0),
+nParents (0),
+firstChild(0),
+nChildren(0),
 truth    (nullptr),
 live     (false),
 pid      (-1),
@@ -39,8 +45,12 @@ Particle::Particle(const Particle& other)
 momentum (other.momentum),
 position (other.position),
 type     (other.type),
-parents  (other.parents),
-children (other.children),
+genealogy(other.genealogy),
+genealogyGeneration(other.genealogyGeneration),
+firstParent(other.firstParent),
+nParents (other.nParents),
+firstChild(other.firstChild),
+nChildren(other.nChildren),
 truth    (other.truth),
 live     (other.live),
 pid      (other.pid),
@@ -58,8 +68,12 @@ Particle & Particle::operator=(const Particle & other)
     momentum    = other.momentum;
     position    = other.position;
     type        = other.type;
-    parents     = other.parents;
-    children    = other.children;
+    genealogy   = other.genealogy;
+    genealogyGeneration = other.genealogyGeneration;
+    firstParent = other.firstParent;
+    nParents    = other.nParents;
+    firstChild  = other.firstChild;
+    nChildren   = other.nChildren;
     truth       = other.truth;
     live        = other.live;
     pid         = other.pid;
@@ -77,8 +91,10 @@ void Particle::clear()
   ixYPhi     = -1;
   momentum.SetPxPyPzE (0.0,0.0,0.0,0.0);
   position.SetXYZT    (0.0,0.0,0.0,0.0);
-  parents.clear();
-  children.clear();
+  genealogy  = nullptr;
+  genealogyGeneration = 0;
+  nParents   = 0;
+  nChildren  = 0;
   truth = nullptr;
 }
 
@@ -90,8 +106,10 @@ void Particle::reset()
   ixYPhi     = -1;
   momentum.SetPxPyPzE (0.0,0.0,0.0,0.0);
   position.SetXYZT    (0.0,0.0,0.0,0.0);
-  parents.clear();
-  children.clear();
+  genealogy  = nullptr;
+  genealogyGeneration = 0;
+  nParents   = 0;
+  nChildren  = 0;
   truth = nullptr;
 }
 
@@ -105,8 +123,10 @@ void Particle::set(ParticleType * _type,
   momentum.SetPxPyPzE (p_x,p_y,p_z,p_e);
   position.SetXYZT    (_x,_y,_z,_t);
   live       = _live;
-  parents.clear();
-  children.clear();
+  genealogy  = nullptr;
+  genealogyGeneration = 0;
+  nParents   = 0;
+  nChildren  = 0;
   truth = nullptr;
 }
 
@@ -170,6 +190,13 @@ void Particle::setPidPxPyPzE(long _pid, double p_x, double p_y, double p_z, doub
   momentum.SetPxPyPzE (p_x,p_y,p_z,p_e);
 }
 
+double Particle::getPhi() const
+{
+  double phi = momentum.Phi();
+  if (phi<0.0) phi += CAP::Math::twoPi();
+  return phi;
+}
+
 void Particle::setRThetaPhiT(double r, double theta, double phi,double t)
 {
   double rsinTh = r*sin(theta);
@@ -191,10 +218,10 @@ void Particle::setRCosThetaPhiT(double r, double cosTheta, double phi,double t)
 void Particle::boost(double ax, double ay, double az)
 {
   momentum.Boost(ax,ay,az);
-  unsigned int nChildren = children.size();
-  for (unsigned int iChildren=0; iChildren<nChildren; iChildren++)
+  unsigned int n = getNChildren();
+  for (unsigned int iChildren=0; iChildren<n; iChildren++)
     {
-    children[iChildren]->boost(ax,ay,az);
+    genealogy->getAt(firstChild+iChildren)->boost(ax,ay,az);
     }
 }
 
@@ -210,10 +237,10 @@ void Particle::boostRapidity(double boost)
   pz = mt * sinh(rapidity);
   e  = mt * cosh(rapidity);
   momentum.SetPxPyPzE (px,py,pz,e);
-  unsigned int nChildren = children.size();
-  for (unsigned int iChildren=0; iChildren<nChildren; iChildren++)
+  unsigned int n = getNChildren();
+  for (unsigned int iChildren=0; iChildren<n; iChildren++)
     {
-    children[iChildren]->boostRapidity(boost);
+    genealogy->getAt(firstChild+iChildren)->boostRapidity(boost);
     }
 }
 
@@ -245,29 +272,57 @@ double Particle::distanceXY(Particle * otherParticle)  const
 }
 
 int Particle::factorySize = 5000;
-Factory<Particle> * Particle::factory = 0;
+thread_local std::unique_ptr< Factory<Particle> > Particle::factory;
 Factory<Particle> * Particle::getFactory()
 {
   if (!factory)
     {
-    factory = new Factory<Particle>();
+    factory.reset(new Factory<Particle>());
     factory->initialize(factorySize);
     }
-  return factory;
+  return factory.get();
 }
 
 void Particle::resetFactory()
 {
-  factory->reset();
+  if (factory) factory->reset();
+  defaultGenealogy.clear();
+}
+
+thread_local ParticleGenealogy Particle::defaultGenealogy;
+ParticleGenealogy * Particle::getDefaultGenealogy()
+{
+  return &defaultGenealogy;
 }
 
 
+ParticleGenealogy & Particle::prepareGenealogy()
+{
+  if (!genealogy) genealogy = getDefaultGenealogy();
+  if (genealogyGeneration!=genealogy->getGeneration())
+    {
+    genealogyGeneration = genealogy->getGeneration();
+    nParents  = 0;
+    nChildren = 0;
+    }
+  return *genealogy;
+}
+
+void Particle::setGenealogy(ParticleGenealogy * _genealogy)
+{
+  genealogy = _genealogy;
+  genealogyGeneration = genealogy ? genealogy->getGeneration() : 0;
+  nParents  = 0;
+  nChildren = 0;
+}
+
 // Particle Interaction 1->1
 // Considered a decay vertex
 void Particle::setParent(Particle * _parent)
 {
-  parents.clear();
-  parents.push_back(_parent);
+  ParticleGenealogy & arena = prepareGenealogy();
+  firstParent = arena.append(&_parent,1);
+  nParents    = 1;
   momentum = _parent->getMomentum();
   position = _parent->getPosition();
 
@@ -276,9 +331,10 @@ void Particle::setParent(Particle * _parent)
 // Particle Interaction 2->X
 void Particle::setParents(Particle * parent1, Particle * parent2)
 {
-  parents.clear();
-  parents.push_back(parent1);
-  parents.push_back(parent2);
+  ParticleGenealogy & arena = prepareGenealogy();
+  Particle * newParents[2] = {parent1, parent2};
+  firstParent = arena.append(newParents,2);
+  nParents    = 2;
   momentum = parent1->getMomentum(); momentum += parent2->getMomentum();
   position = parent1->getPosition(); position += parent2->getPosition();
   position *= 0.5;
@@ -288,10 +344,10 @@ void Particle::setParents(Particle * parent1, Particle * parent2)
 // Particle Interaction 3->X
 void Particle::setParents(Particle * parent1, Particle * parent2, Particle * parent3)
 {
-  parents.clear();
-  parents.push_back(parent1);
-  parents.push_back(parent2);
-  parents.push_back(parent3);
+  ParticleGenealogy & arena = prepareGenealogy();
+  Particle * newParents[3] = {parent1, parent2, parent3};
+  firstParent = arena.append(newParents,3);
+  nParents    = 3;
   momentum = parent1->getMomentum(); momentum += parent2->getMomentum(); momentum += parent3->getMomentum();
   position = parent1->getPosition(); position += parent2->getPosition(); position += parent3->getPosition();
   position *= 0.3333333333;
@@ -301,56 +357,71 @@ void Particle::setParents(Particle * parent1, Particle * parent2, Particle * par
 // Particle Interaction n->X
 void Particle::setParents(const vector<Particle*> &  newParents)
 {
-  parents.clear();
+  ParticleGenealogy & arena = prepareGenealogy();
+  unsigned int nNewParents = newParents.size();
+  firstParent = arena.append(newParents.data(),nNewParents);
+  nParents    = nNewParents;
   Particle * parent = newParents[0];
   momentum = parent->getMomentum();
   position = parent->getPosition();
-  unsigned int nParents = newParents.size();
-  for (unsigned int iParent=1;iParent<nParents;iParent++)
+  for (unsigned int iParent=1;iParent<nNewParents;iParent++)
   {
   parent   =  newParents[iParent];
   momentum += parent->getMomentum();
   position += parent->getPosition();
-  parents.push_back(parent);
   }
-  position *= 1.0/double(nParents);
+  position *= 1.0/double(nNewParents);
 }
 
 void Particle::addChild(Particle* child)
 {
-  children.push_back(child); child->setPosition(position);
+  ParticleGenealogy & arena = prepareGenealogy();
+  firstChild = arena.extend(firstChild,nChildren,child); nChildren++;
+  child->setPosition(position);
 }
 
 void Particle::addChildren(Particle* child1, Particle* child2)
 {
-  children.push_back(child1); child1->setPosition(position);
-  children.push_back(child2); child2->setPosition(position);
+  Particle * newChildren[2] = {child1, child2};
+  addChildren(newChildren,2);
 }
 
 void Particle::addChildren(Particle* child1, Particle* child2, Particle* child3)
 {
-  children.push_back(child1); child1->setPosition(position);
-  children.push_back(child2); child2->setPosition(position);
-  children.push_back(child3); child3->setPosition(position);
+  Particle * newChildren[3] = {child1, child2, child3};
+  addChildren(newChildren,3);
 }
 
 void Particle::addChildren(const vector<Particle*> &  newChildren)
 {
-  for (unsigned int iChild=0;iChild<newChildren.size();iChild++)
+  addChildren(newChildren.data(),newChildren.size());
+}
+
+void Particle::addChildren(Particle * const * newChildren, int32_t nNewChildren)
+{
+  ParticleGenealogy & arena = prepareGenealogy();
+  if (nChildren==0)
+    {
+    firstChild = arena.append(newChildren,nNewChildren);
+    nChildren  = nNewChildren;
+    }
+  else
     {
-    Particle * child =  newChildren[iChild];
-    child->setPosition(position);
-    children.push_back(child);
+    for (int32_t iChild=0;iChild<nNewChildren;iChild++)
+      {
+      firstChild = arena.extend(firstChild,nChildren,newChildren[iChild]); nChildren++;
+      }
     }
+  for (int32_t iChild=0;iChild<nNewChildren;iChild++) newChildren[iChild]->setPosition(position);
 }
 
 
 bool Particle::isNucleonNucleonInteraction() const
 {
   bool result = false;
-  if (parents.size() == 2  &&
-      parents[0]->isNucleon() &&
-      parents[1]->isNucleon() ) result = true;
+  if (getNParents() == 2  &&
+      genealogy->getAt(firstParent+0)->isNucleon() &&
+      genealogy->getAt(firstParent+1)->isNucleon() ) result = true;
   return result;
 }
 
@@ -358,27 +429,27 @@ bool Particle::isNucleonNucleonInteraction() const
 bool Particle::isProtonProton() const
 {
   bool result = false;
-  if (parents.size() == 2  &&
-      parents[0]->isProton() &&
-      parents[1]->isProton() ) result = true;
+  if (getNParents() == 2  &&
+      genealogy->getAt(firstParent+0)->isProton() &&
+      genealogy->getAt(firstParent+1)->isProton() ) result = true;
   return result;
 }
 
 bool Particle::isNeutronNeutron() const
 {
   bool result = false;
-  if (parents.size() == 2  &&
-      parents[0]->isNeutron() &&
-      parents[1]->isNeutron() ) result = true;
+  if (getNParents() == 2  &&
+      genealogy->getAt(firstParent+0)->isNeutron() &&
+      genealogy->getAt(firstParent+1)->isNeutron() ) result = true;
   return result;
 }
 
 bool Particle::isProtonNeutron() const
 {
   bool result = false;
-  if ((parents.size() == 2) &&
-      ((parents[0]->isProton() && parents[1]->isNeutron()) ||
-       (parents[1]->isProton() && parents[0]->isNeutron()))) result = true;
+  if ((getNParents() == 2) &&
+      ((genealogy->getAt(firstParent+0)->isProton() && genealogy->getAt(firstParent+1)->isNeutron()) ||
+       (genealogy->getAt(firstParent+1)->isProton() && genealogy->getAt(firstParent+0)->isNeutron()))) result = true;
   return result;
 }
 
@@ -412,7 +483,7 @@ bool Particle::isPrimary() const
 {
   bool result = true;
   if (!isParticle()) result = false;
-  else if (parents.size()==1 && parents[0]->isDecay()) result = false;
+  else if (getNParents()==1 && genealogy->getAt(firstParent+0)->isDecay()) result = false;
   return result;
 }
 
@@ -420,7 +491,7 @@ bool Particle::isSecondary() const
 {
   bool result = true;
   if (!isParticle()) result = false;
-  else if (parents.size()<1) result = false;
-  else if (!parents[0]->isDecay()) result = false;
+  else if (getNParents()<1) result = false;
+  else if (!genealogy->getAt(firstParent+0)->isDecay()) result = false;
   return result;
 }
@@ -13,10 +13,12 @@
 #ifndef CAP__Particle
 #define CAP__Particle
 
+#include <memory>
 #include "Aliases.hpp"
 #include "Factory.hpp"
 #include "ParticleType.hpp"
 #include "ParticleDb.hpp"
+#include "ParticleGenealogy.hpp"
 
 using namespace std;
 
@@ -190,6 +192,45 @@ public:
   //!
   void setMomentum(const LorentzVector & _momentum)          { momentum = _momentum;  }
 
+  //!
+  //! Get the transverse momentum of this particle. getPt(), getP(), getEta(), getPhi(), and getRapidity() compute their value from
+  //! the momentum on every call and never modify the particle, so they may be called concurrently. Code looping over the particles
+  //! of an event should rather read the values computed once per event by Event::getColumns().
+  //!
+  double getPt() const
+  {
+  return momentum.Pt();
+  }
+
+  //!
+  //! Get the magnitude of the 3-momentum of this particle.
+  //!
+  double getP() const
+  {
+  return momentum.P();
+  }
+
+  //!
+  //! Get the pseudorapidity of this particle.
+  //!
+  double getEta() const
+  {
+  return momentum.Eta();
+  }
+
+  //!
+  //! Get the azimuth of the momentum of this particle, in the range [0,2pi[ used by histograms.
+  //!
+  double getPhi() const;
+
+  //!
+  //! Get the rapidity of this particle.
+  //!
+  double getRapidity() const
+  {
+  return momentum.Rapidity();
+  }
+
   //!
   //! Get the  4-position  vector of this particle as a changeable LorentzVector object
   //!
@@ -413,7 +454,7 @@ public:
   //!
   bool hasParents() const
   {
-  return parents.size()>0;
+  return getNParents()>0;
   }
 
   //!
@@ -432,7 +473,7 @@ public:
   //!
   unsigned int getNParents() const
   {
-  return parents.size();
+  return hasGenealogy() ? nParents : 0;
   }
 
   //!
@@ -441,18 +482,18 @@ public:
   //!
   Particle * getParentAt(unsigned int index)
   {
-  if (index < parents.size())
-    return parents[index];
+  if (index < getNParents())
+    return genealogy->getAt(firstParent+index);
   else
     return nullptr;
   }
 
   //!
-  //!Get a constant array of the parents of this particle.
+  //!Get a constant array (view) of the parents of this particle.
   //!
-  const vector<Particle*> & getParents() const
+  ParticleGenealogy::Range getParents() const
   {
-    return parents;
+  return hasGenealogy() ? genealogy->getRange(firstParent,nParents) : ParticleGenealogy::Range();
   }
 
   //!
@@ -480,7 +521,7 @@ public:
   //!
   bool hasChildren() const
   {
-  return children.size()>0;
+  return getNChildren()>0;
   }
 
   //!
@@ -488,7 +529,7 @@ public:
   //!
   unsigned int getNChildren() const
   {
-  return children.size();
+  return hasGenealogy() ? nChildren : 0;
   }
 
   //!
@@ -496,22 +537,49 @@ public:
   //!
   Particle * getChildAt(unsigned int index)
   {
-  if (index < children.size())
-    return children[index];
+  if (index < getNChildren())
+    return genealogy->getAt(firstChild+index);
   else
     return nullptr;
   }
 
   //!
-  //!Get an immutable array of children produced by this particle.
+  //!Get an immutable array (view) of children produced by this particle.
   //!
-  const vector<Particle*> & getChildren() const
+  ParticleGenealogy::Range getChildren() const
   {
-    return children;
+  return hasGenealogy() ? genealogy->getRange(firstChild,nChildren) : ParticleGenealogy::Range();
+  }
+
+  //!
+  //! Record the relations of this particle in the given arena, normally that of the event the particle belongs to. Relations
+  //! recorded earlier in another arena are dropped. Event::add() binds the particles without relations to the arena of the event.
+  //! Particles never bound record their relations in a per thread arena cleared by Event::reset() and resetFactory(). clear(), reset()
+  //! and set() unbind the particle, so objects reused from the factory never refer to the arena of an event deleted since.
+  //!
+  void setGenealogy(ParticleGenealogy * _genealogy);
+
+  //!
+  //! Returns true if this particle recorded valid relations in the given arena. The arena of the particle is not dereferenced
+  //! unless it is the given one.
+  //!
+  bool hasGenealogyIn(const ParticleGenealogy * arena) const
+  {
+  return genealogy==arena && arena && arena->getGeneration()==genealogyGeneration;
+  }
+
+  //!
+  //! Returns true if the relations recorded by this particle are valid, i.e., if its arena was not cleared since they were recorded.
+  //!
+  bool hasGenealogy() const
+  {
+  return genealogy && genealogy->getGeneration()==genealogyGeneration;
   }
 
   //!
   //!Add the given particle as one of the children of this particle.
+  //! The children of a particle are recorded as one range of the arena: they must be added before other relations are recorded in the
+  //! arena, and a MemoryException is thrown otherwise. Use addChildren() to add several children at once.
   //!
   void addChild(Particle* child);
 
@@ -530,6 +598,11 @@ public:
   //!
   void addChildren(const vector<Particle*> &  children);
 
+  //!
+  //!Add the given n particles as children of this particle.
+  //!
+  void addChildren(Particle * const * children, int32_t n);
+
   //!
   //!Return true if this particle is a nucleon-nucleon interaction.
   //!
@@ -572,22 +645,38 @@ protected:
   LorentzVector momentum;  //!< 4-momentum of the particle
   LorentzVector position;  //!< 4-position of the particle
   ParticleType * type;      //!< type of this particle
-  vector<Particle*> parents;  //!< array containing the parents of this particle.
-  vector<Particle*> children; //!< array containing the children of this particle.
+  ParticleGenealogy * genealogy;    //!< arena holding the parents and children of this particle.
+  uint32_t genealogyGeneration;     //!< generation of the arena the relations below were recorded in.
+  int32_t  firstParent;             //!< index of the first parent of this particle in the arena.
+  int32_t  nParents;                //!< number of parents of this particle.
+  int32_t  firstChild;              //!< index of the first child of this particle in the arena.
+  int32_t  nChildren;               //!< number of children of this particle.
   Particle * truth;  //!< pointer to the truth particle corresponding to this particle.
   bool live; //!< whether this particle is live or dead (measurable or not)
   long pid;  //!< used defined identified used in some applications
   int  sourceIndex;  //!<  source index  used in some applications
 
+  //!
+  //! Returns the arena relations are recorded in, binding this particle to the default arena if needed, and drops the
+  //! relations recorded in an earlier generation of the arena.
+  //!
+  ParticleGenealogy & prepareGenealogy();
+
 public:
   int   ixEtaPhi, ixYPhi;
 
 public:
   static int factorySize;
-  static Factory<Particle> * factory;
+  static thread_local std::unique_ptr< Factory<Particle> > factory; //!< one factory per thread, deleted when the thread exits
   static Factory<Particle> * getFactory();
   static void resetFactory();
 
+  //!
+  //! Arena used by the particles of this thread not bound to an event (see setGenealogy()).
+  //!
+  static thread_local ParticleGenealogy defaultGenealogy; //!
+  static ParticleGenealogy * getDefaultGenealogy();
+
   //!
   //!Get a proton object singleton
   //!
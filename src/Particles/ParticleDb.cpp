@@ -31,10 +31,49 @@ ClassImp(ParticleDb);
 
 ParticleDb::ParticleDb()
 :
-Collection<ParticleType>()
+Collection<ParticleType>(),
+generation(0),
+pdgIndex(),
+nameIndex(),
+typeIndex()
 {
 }
 
+void ParticleDb::buildIndex()
+{
+  std::unique_lock<std::shared_mutex> lock(indexMutex);
+  indexTypes();
+}
+
+void ParticleDb::indexTypes()
+{
+  unsigned int n = objects.size();
+  pdgIndex.clear();
+  nameIndex.clear();
+  typeIndex.clear();
+  pdgIndex.reserve(n);
+  nameIndex.reserve(n);
+  typeIndex.reserve(n);
+  for (unsigned int iPart = 0; iPart < n; iPart++) indexType(iPart);
+}
+
+void ParticleDb::indexType(unsigned int position)
+{
+  // emplace keeps the first entry so lookups return the same index as a linear search would
+  ParticleType * type = objects[position];
+  pdgIndex.emplace(type->getPdgCode(),position);
+  nameIndex.emplace(string(type->getName().Data()),position);
+  typeIndex.emplace(type,position);
+}
+
+void ParticleDb::clear()
+{
+  std::unique_lock<std::shared_mutex> lock(indexMutex);
+  if (size()>0) generation++;
+  Collection<ParticleType>::clear();
+  indexTypes();
+}
+
 // ================================================================================================
 // read in ParticleType information from pdg data file
 // ================================================================================================
@@ -171,23 +210,28 @@ void ParticleDb::sortByMass()
 {
   cout << "<D> ParticleDb::sortHadronListByHadronMass() Collection size:"
   << size() << endl;
+  std::unique_lock<std::shared_mutex> lock(indexMutex);
   //double m1, m2;
   int n = size();
+  bool moved = false;
   for (int i = 1; i<n; i++)
   {
   int k = i;
   int j = i - 1;
   //m1 = objects[k]->getMass();
   //m2 = objects[j]->getMass();
-  while (j >= 0 && (operator[](k)->getMass() < operator[](j)->getMass()) )
+  while (j >= 0 && (objects[k]->getMass() < objects[j]->getMass()) )
     {
     ParticleType* temp = objects[j];
     objects[j] = objects[k];
     objects[k] = temp;
+    moved = true;
     k--;
     j--;
     }
   }
+  if (moved) generation++;
+  indexTypes();
 }
 
 void ParticleDb::resolveTypes()
@@ -258,32 +302,26 @@ ParticleDb *  ParticleDb::extractCollection(int option)
   return collection;
 }
 
-int ParticleDb::findIndexForType(ParticleType * type)
+int ParticleDb::findIndexForType(ParticleType * type) const
 {
-  for (unsigned int iPart = 0; iPart < size(); iPart++)
-    {
-    if (type == objects[iPart]) return iPart;
-    }
-  return -1;
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
+  unordered_map<const ParticleType*,int>::const_iterator it = typeIndex.find(type);
+  return (it!=typeIndex.end()) ? it->second : -1;
 }
 
-int ParticleDb::findIndexForName(const CAP::String & name)
+int ParticleDb::findIndexForName(const CAP::String & name) const
 {
-  for (unsigned int iPart = 0; iPart < size(); iPart++)
-    {
-    if (objects[iPart]->getName().EqualTo(name)) return iPart;
-    }
-  return -1;
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
+  unordered_map<string,int>::const_iterator it = nameIndex.find(string(name.Data()));
+  return (it!=nameIndex.end()) ? it->second : -1;
 }
 
 
-int ParticleDb::findIndexForPdgCode(int pdgCode)
+int ParticleDb::findIndexForPdgCode(int pdgCode) const
 {
-  for (unsigned int iPart = 0; iPart < size(); iPart++)
-  {
-  if (pdgCode == objects[iPart]->getPdgCode()) return iPart;
-  }
-  return -1;
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
+  unordered_map<int,int>::const_iterator it = pdgIndex.find(pdgCode);
+  return (it!=pdgIndex.end()) ? it->second : -1;
 }
 
 int ParticleDb::findIndexForPrivateCode(int privateCode)
@@ -295,34 +333,56 @@ int ParticleDb::findIndexForPrivateCode(int privateCode)
   return -1;
 }
 
-bool ParticleDb::containsTypeNamed(CAP::String name)
+bool ParticleDb::containsTypeNamed(CAP::String name) const
 {
-  for (unsigned int iPart = 0; iPart < size(); iPart++)
-    {
-    if (objects[iPart]->getName().EqualTo(name)) return true;
-    }
-  return false;
+  return findIndexForName(name)>=0;
 }
 
 ParticleType * ParticleDb::findPdgCode(int pdgCode)
 {
-  for (unsigned int iPart = 0; iPart<size(); iPart++)
   {
-  if (pdgCode == objects[iPart]->getPdgCode())
-    return objects[iPart];
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
+  unordered_map<int,int>::const_iterator it = pdgIndex.find(pdgCode);
+  if (it!=pdgIndex.end()) return objects[it->second];
   }
   // code not found in the current table.
-  // create new type and add to the table.
-  ParticleType * newType = new ParticleType();
+  // create new type and add to the table, unless another thread did it since the lookup.
+  ParticleType * newType;
+  {
+  std::unique_lock<std::shared_mutex> lock(indexMutex);
+  unordered_map<int,int>::const_iterator it = pdgIndex.find(pdgCode);
+  if (it!=pdgIndex.end()) return objects[it->second];
+  newType = new ParticleType();
   newType->setName("unknown");
   newType->setTitle("unknown");
   newType->setPdgCode(pdgCode);
-  push_back(newType);
-  cout << endl
-  <<" ------------------------------------------------ Added new type with pdgCode=" << pdgCode << endl;
+  newType->setIndex(size()+1);
+  objects.push_back(newType);
+  indexType(objects.size()-1);
+  }
+  if (reportWarning(__FUNCTION__)) cout << "Added new type with pdgCode=" << pdgCode << endl;
   return newType;
 }
 
+void ParticleDb::findPdgCodes(const vector<int> & pdgCodes, vector<ParticleType*> & types)
+{
+  unsigned int n = pdgCodes.size();
+  types.resize(n);
+  bool unknownCodes = false;
+  {
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
+  for (unsigned int k=0; k<n; k++)
+    {
+    unordered_map<int,int>::const_iterator it = pdgIndex.find(pdgCodes[k]);
+    types[k] = (it!=pdgIndex.end()) ? objects[it->second] : nullptr;
+    if (!types[k]) unknownCodes = true;
+    }
+  }
+  if (!unknownCodes) return;
+  for (unsigned int k=0; k<n; k++)
+    if (!types[k]) types[k] = findPdgCode(pdgCodes[k]);
+}
+
 ParticleType * ParticleDb::findPrivateCode(int privateCode)
 {
   unsigned int n = size();
@@ -335,14 +395,17 @@ ParticleType * ParticleDb::findPrivateCode(int privateCode)
 
 void ParticleDb::addParticleType(ParticleType * particleType)
 {
-  append(particleType);
+  std::unique_lock<std::shared_mutex> lock(indexMutex);
+  objects.push_back(particleType);
+  indexType(objects.size()-1);
 }
 
 ParticleType * ParticleDb::getParticleType(String name)
 {
-  int index = findIndexForName(name);
-  if (index>=0)
-    return objects[index];
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
+  unordered_map<string,int>::const_iterator it = nameIndex.find(string(name.Data()));
+  if (it!=nameIndex.end())
+    return objects[it->second];
   else
     return nullptr;
 }
@@ -350,6 +413,7 @@ ParticleType * ParticleDb::getParticleType(String name)
 
 ParticleType * ParticleDb::getParticleType(unsigned int index)
 {
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
   if (index<objects.size())
     return objects[index];
   else
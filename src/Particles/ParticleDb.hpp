@@ -19,6 +19,8 @@
 #include <fstream>
 #include <vector>
 #include <iomanip>
+#include <unordered_map>
+#include <shared_mutex>
 #include "Collection.hpp"
 #include "ParticleType.hpp"
 
@@ -41,11 +43,11 @@ public:
 //  void writeToFile(const String &  outputFileName, bool printDecayProperties=true);
   void sortByMass();
   ParticleDb * extractCollection(int option);
-  int findIndexForType(ParticleType * type);
-  int findIndexForName(const String & name);
-  int findIndexForPdgCode(int pdgCode);
+  int findIndexForType(ParticleType * type) const;
+  int findIndexForName(const String & name) const;
+  int findIndexForPdgCode(int pdgCode) const;
   int findIndexForPrivateCode(int privateCode);
-  bool containsTypeNamed(String aName);
+  bool containsTypeNamed(String aName) const;
 
   int getNumberOfTypes() const { return size();}
   int getParticleTypeCount()const { return size();}
@@ -53,14 +55,63 @@ public:
   void resolveTypes();
   void mapAntiParticleIndices();
   void setupDecayGenerator();
+  //!
+  //! Find the type with the given pdg code. A new type, with the next free type index, is added to this db if the code is unknown.
+  //! Lookups hold a shared lock on the db and additions an exclusive one, so this method may be called concurrently by several
+  //! threads, e.g., by the event generators of the replicas of a threaded TaskIterator.
+  //!
   ParticleType * findPdgCode(int pdgCode);
   ParticleType * findPrivateCode(int privateCode);
 
+  //!
+  //! Find the types of all the given pdg codes at once. On return, types[k] is the type of pdgCodes[k]. As with findPdgCode(int),
+  //! a new type is added to this db for each unknown code.
+  //!
+  void findPdgCodes(const vector<int> & pdgCodes, vector<ParticleType*> & types);
+
+  //!
+  //! Rebuild the pdg code, name, and type lookup tables of this db. The tables are kept up to date when types are added, and
+  //! rebuilt when the db is sorted or cleared, so lookups never modify the db and may be done concurrently by several threads.
+  //!
+  void buildIndex();
+
+  //!
+  //! Generation of this db, incremented each time types already in the db are moved (sortByMass()) or removed (clear()). Adding
+  //! types does not change it. Tables derived from the db (e.g., ParticleSpeciesTable) compare it with the generation they were
+  //! built for to find whether they must be rebuilt, and otherwise only need to be extended with the types added since.
+  //!
+  unsigned long getGeneration() const
+  {
+  return generation;
+  }
+
+  //!
+  //! Add the given type to this db and to its lookup tables. push_back() and append() do the same.
+  //!
   void addParticleType(ParticleType * particleType);
+
+  ParticleType * push_back(ParticleType * particleType)
+  {
+  addParticleType(particleType);
+  return particleType;
+  }
+
+  ParticleType * append(ParticleType * particleType)
+  {
+  addParticleType(particleType);
+  return particleType;
+  }
+
+  //!
+  //! Remove all types from this db and clear its lookup tables.
+  //!
+  void clear();
+
   ParticleType * getParticleType(String name);
   ParticleType * getParticleType(unsigned int index);
   ParticleType * operator[](unsigned int index)
   {
+  std::shared_lock<std::shared_mutex> lock(indexMutex);
   if (index<objects.size())
     return objects[index];
   else
@@ -72,6 +123,27 @@ public:
   ostream & printProperties(ostream & os);
   ostream & printDecayProperties(ostream & os);
 
+protected:
+
+  //!
+  //! Add the type at the given position of this db to the lookup tables. Entries of types already in the tables are kept.
+  //! The caller must hold indexMutex exclusively.
+  //!
+  void indexType(unsigned int position);
+
+  //!
+  //! Rebuild the lookup tables from scratch. The caller must hold indexMutex exclusively.
+  //!
+  void indexTypes();
+
+  unsigned long generation;                             //! incremented when types of the db are moved or removed
+  unordered_map<int,int>                  pdgIndex;     //! pdg code  -> index of the first type with that code
+  unordered_map<string,int>               nameIndex;    //! type name -> index of the first type with that name
+  unordered_map<const ParticleType*,int>  typeIndex;    //! type      -> index of the type
+  mutable std::shared_mutex               indexMutex;   //! shared by lookups, exclusive for changes of the types or tables
+
+public:
+
   static ParticleDb * defaultParticleDb;
   static void setDefaultParticleDb(ParticleDb * newDb);
   static ParticleDb * getDefaultParticleDb();
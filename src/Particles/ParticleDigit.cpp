@@ -123,13 +123,13 @@ void ParticleDigit::printProperties(ostream & output)
 
 
 int ParticleDigit::factorySize = 5000;
-Factory<ParticleDigit> * ParticleDigit::factory = 0;
+thread_local std::unique_ptr< Factory<ParticleDigit> > ParticleDigit::factory;
 Factory<ParticleDigit> * ParticleDigit::getFactory()
 {
   if (!factory)
     {
-    factory = new Factory<ParticleDigit>();
+    factory.reset(new Factory<ParticleDigit>());
     factory->initialize(factorySize);
     }
-  return factory;
+  return factory.get();
 }
@@ -11,6 +11,7 @@
  * *********************************************************************/
 #ifndef CAP__ParticleDigit
 #define CAP__ParticleDigit
+#include <memory>
 #include "TString.h"
 #include "Factory.hpp"
 
@@ -51,7 +52,7 @@ public:
   float e;
 
   static int factorySize;
-  static Factory<ParticleDigit> * factory;
+  static thread_local std::unique_ptr< Factory<ParticleDigit> > factory; //!< one factory per thread, deleted when the thread exits
   static Factory<ParticleDigit> * getFactory();
 
 
@@ -0,0 +1,49 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "ParticleDigitColumns.hpp"
+using CAP::ParticleDigitColumns;
+
+ParticleDigitColumns::ParticleDigitColumns()
+:
+iPt(),
+iPhi(),
+iEta(),
+iY(),
+pt(),
+position()
+{
+  // no ops
+}
+
+void ParticleDigitColumns::clear()
+{
+  iPt.clear();
+  iPhi.clear();
+  iEta.clear();
+  iY.clear();
+  pt.clear();
+  position.clear();
+}
+
+void ParticleDigitColumns::getPartners(const ParticleDigitColumns & other, vector<int> & partners) const
+{
+  unsigned int n1 = size();
+  unsigned int n2 = other.size();
+  partners.assign(n1,-1);
+  unsigned int k2 = 0;
+  for (unsigned int k1=0; k1<n1; k1++)
+    {
+    while (k2<n2 && other.position[k2]<position[k1]) k2++;
+    if (k2==n2) break;
+    if (other.position[k2]==position[k1]) partners[k1] = k2;
+    }
+}
@@ -0,0 +1,78 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticleDigitColumns
+#define CAP__ParticleDigitColumns
+#include <vector>
+#include "ParticleDigit.hpp"
+
+namespace CAP
+{
+
+//!
+//! Columnar (structure of arrays) copy of the bin indices and transverse momenta of a list of digitized particles. Element k of
+//! each array describes particle k of the list, so pair loops can read contiguous arrays of bin indices, several particles at a
+//! time, rather than follow a pointer to each ParticleDigit.
+//!
+//! Each particle also carries its position in the event. Lists built from the same event must be filled in increasing order of
+//! positions so a particle present in two lists can be found by a merge of the two lists (see getPartners()).
+//!
+class ParticleDigitColumns
+{
+public:
+
+  ParticleDigitColumns();
+
+  virtual ~ParticleDigitColumns() {}
+
+  //!
+  //! Remove all entries. The capacity of the arrays is kept so the next event causes no allocation.
+  //!
+  void clear();
+
+  //!
+  //! Append the given digit, which describes the particle at the given position of the event.
+  //!
+  inline void add(const ParticleDigit & digit, unsigned int _position)
+  {
+  iPt.push_back(digit.iPt);
+  iPhi.push_back(digit.iPhi);
+  iEta.push_back(digit.iEta);
+  iY.push_back(digit.iY);
+  pt.push_back(digit.pt);
+  position.push_back(_position);
+  }
+
+  //!
+  //! Number of particles described by the arrays.
+  //!
+  unsigned int size() const
+  {
+  return iPt.size();
+  }
+
+  //!
+  //! Set partners[k] to the index in the given list of particle k of this list, or -1 if the particle is not in the given list.
+  //!
+  void getPartners(const ParticleDigitColumns & other, vector<int> & partners) const;
+
+  vector<int>          iPt;
+  vector<int>          iPhi;
+  vector<int>          iEta;
+  vector<int>          iY;
+  vector<double>       pt;
+  vector<unsigned int> position;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticleDigitColumns */
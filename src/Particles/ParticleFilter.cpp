@@ -11,6 +11,7 @@
  * *********************************************************************/
 // #include <TMath.h>
 #include "ParticleFilter.hpp"
+#include "ParticleDb.hpp"
 using CAP::Filter;
 using CAP::Particle;
 using CAP::ParticleFilter;
@@ -22,14 +23,34 @@ ClassImp(ParticleFilter);
 
 ParticleFilter::ParticleFilter()
 :
-Filter<Particle>()
+Filter<Particle>(),
+compiled(false),
+requireLive(false),
+requireNotLive(false),
+filteringOnType(false),
+speciesTable(nullptr),
+speciesIndex(0),
+compiledDb(nullptr),
+compiledGeneration(0),
+ownSpeciesTable(),
+kinematicRanges()
 {
   // no ops
 }
 
 ParticleFilter::ParticleFilter(const ParticleFilter & otherFilter)
 :
-Filter<Particle>(otherFilter)
+Filter<Particle>(otherFilter),
+compiled(false),
+requireLive(false),
+requireNotLive(false),
+filteringOnType(false),
+speciesTable(nullptr),
+speciesIndex(0),
+compiledDb(nullptr),
+compiledGeneration(0),
+ownSpeciesTable(),
+kinematicRanges()
 {
  // no ops
 }
@@ -39,198 +60,353 @@ ParticleFilter & ParticleFilter::operator=(const ParticleFilter & otherFilter)
   if (this!=&otherFilter)
     {
     Filter<Particle>::operator=(otherFilter);
+    compiled     = false;
+    speciesTable = nullptr;
     }
   return *this;
 }
 
-
 bool ParticleFilter::accept(const Particle & particle)
 {
-  //cout << " ParticleFilter::accept(const Particle & particle): "  << endl;
-  const LorentzVector & momentum1 = particle.getMomentum();
-//  double pt1   = momentum1.Pt();
-//  double e1    = momentum1.E();
-//  double phi1  = momentum1.Phi();
-//  double eta1  = momentum1.Eta();
-//  double y1    = momentum1.Rapidity();
-  //cout << "particle: " << particle.getType().getName() << "  y1: " << y1 << "  phi1: " << phi1 << " pt1: " << pt1 << endl;
+  if (compiled) return acceptCompiled(particle);
 
   unsigned int nConditions = getNConditions();
   if (nConditions<1) return true;
 
-  double value     = 0.0;
-  bool   accepting = false;
-  ParticleType & type = particle.getType();
-
-  //cout << "ParticleFilter::accept() nConditions = " << nConditions << endl;
-
+  bool accepting = false;
   for (unsigned int k = 0; k<nConditions; k++)
     {
     Condition & condition = *(conditions[k]);
-    unsigned int filterType    = condition.filterType;
-    unsigned int filterSubType = condition.filterSubtype;
-    //cout << "filterType: " << filterType << "   filterSubType: " << filterSubType << endl;
-    switch (filterType)
+    switch (condition.filterType)
       {
         case 0: // live or not to be considered at all
-        switch (filterSubType)
+        switch (condition.filterSubtype)
           {
             case  0: accepting = !particle.isLive(); break;  // decayed or removed particles only
             case  1: accepting = particle.isLive(); break;   // undecayed particles only
             case  2: accepting = 1; break;                   // all
           }
-        //if (!accepting) return false;
         break;
 
         case 1: // Charge, Neutral, Plus, or Minus
-          {
-          int charge = type.getCharge();
-          switch (filterSubType)
-            {
-              case  0: accepting = (charge==0); break;  // accepts neutral only
-              case  1: accepting = (charge!=0); break;  // accepts all charged particles
-              case  2: accepting = (charge<0);  break;  // accepts -ve only
-              case  3: accepting = (charge>0);  break;  // accepts +ve only
-            }
-          //if (!accepting) return false;
-          }
+        case 2: // PDG Code
+        case 3: // Particle index
+        case 4: // Type selection
+        accepting = acceptType(particle.getType(),condition);
         break;
 
-        case 2: // PDG Code
+        case 5: // kinematic selection/filtering
+        accepting = condition.accept(getKinematicValue(particle,condition.filterSubtype));
+        break;
+      }
+    if (!accepting)  return false;
+    }
+  return true;
+}
+
+bool ParticleFilter::acceptType(const ParticleType & type, Condition & condition)
+{
+  unsigned int filterSubType = condition.filterSubtype;
+  switch (condition.filterType)
+    {
+      case 1: // Charge, Neutral, Plus, or Minus
+      {
+      int charge = type.getCharge();
+      switch (filterSubType)
         {
-        accepting = condition.accept(type.getPdgCode());
-//        int pdg = type.getPdgCode();
-//        if (pdg==-211)
-//          {
-//          cout
-//          << "            filterType: " << condition.filterType
-//          << " filterSubtype: " << condition.filterSubtype
-//          << "  minimum: " << condition.minimum
-//          << "  maximum: " << condition.maximum
-//          << endl;
-//          //cout << "particle: " << particle.getType().getName() << "  y1: " << y1 << "  phi1: " << phi1 << " pt1: " << pt1 << endl;
-//          cout << "       case 2: accepting: " << accepting << endl;
-//          }
+          case  0: return (charge==0);  // accepts neutral only
+          case  1: return (charge!=0);  // accepts all charged particles
+          case  2: return (charge<0);   // accepts -ve only
+          case  3: return (charge>0);   // accepts +ve only
         }
-        //if (!accepting) return false;
+      }
+      break;
+
+      case 2: // PDG Code
+      return condition.accept(type.getPdgCode());
+
+      case 3: // Particle index
+      return condition.accept(type.getIndex());
+
+      case 4: // Type selection
+      switch (filterSubType)
+        {
+          case 0: return type.isPhoton();
+          case 10: return type.isLepton();
+          case 11: return type.isElectron() || type.isPositron();
+          case 12: return type.isElectron();
+          case 13: return type.isPositron();
+          case 14: return type.isMuon() || type.isAntiMuon();
+          case 15: return type.isMuon();
+          case 16: return type.isAntiMuon();
+          case 17: return type.isTau()  || type.isAntiTau();
+          case 18: return type.isTau();
+          case 19: return type.isAntiTau();
+
+          case 40: return type.isStrange();
+          case 41: return type.isStrangePlus();
+          case 42: return type.isStrangeMinus();
+
+          case 50: return type.isCharm();
+          case 51: return type.isCharmPlus();
+          case 52: return type.isCharmMinus();
+
+          case 60: return type.isBottom();
+          case 61: return type.isBottomPlus();
+          case 62: return type.isBottomMinus();
+
+          case 70: return type.isTop();
+
+          case 1100: return type.isHadron();    // any hadron
+          case 1101: return type.isHadron() && type.isCharged();    // any charged hadron
+          case 1102: return
+          type.isPionP() ||
+          type.isPionM() ||
+          type.isKaonP() ||
+          type.isKaonM() ||
+          type.isProton() ||
+          type.isAntiProton(); // pi+, pi-, K+, K-, p, pBar
+          case 1103: return
+          type.isPionP() ||
+          type.isKaonP() ||
+          type.isProton(); // pi+, K+, p
+          case 1104: return
+          type.isPionM() ||
+          type.isKaonM() ||
+          type.isAntiProton(); // pi-, K-, pBar
+
+          case 1110: return type.isPion();
+          case 1111: return type.isPionP();
+          case 1112: return type.isPion0();
+          case 1113: return type.isPionM();
+
+          case 1120: return type.isKaon();
+          case 1121: return type.isKaonP();
+          case 1122: return type.isKaonM();
+          case 1123: return type.isKaon0();
+          case 1124: return type.isKaon0Bar();
+          case 1125: return type.isKaon0S();
+          case 1126: return type.isKaon0L();
+
+          case 1200: return type.isBaryon();
+          case 1201: return type.isBaryonPlus();
+          case 1202: return type.isBaryonMinus();
+
+          case 1210: return type.isProton() || type.isAntiProton();
+          case 1211: return type.isProton();
+          case 1212: return type.isAntiProton();
+
+          case 1220: return type.isLambda() || type.isAntiLambda();
+          case 1221: return type.isLambda();
+          case 1222: return type.isAntiLambda();
+
+          case 1230: return type.isSigmaP();
+          case 1231: return type.isSigma0();
+          case 1232: return type.isSigmaM();
+          case 1241: return type.isAntiSigmaP();
+          case 1242: return type.isAntiSigma0();
+          case 1243: return type.isAntiSigmaM();
+          case 1244: return type.isXi0();
+          case 1245: return type.isXiM();
+          case 1246: return type.isAntiXi0();
+          case 1247: return type.isAntiXiM();
+          case 1248: return type.isOmegaM();
+          case 1249: return type.isAntiOmegaM();
+        }
+      break;
+    }
+  return false;
+}
+
+//!
+//! Value of the kinematic variable selected by the given subtype: 0: momentum, 1: transverse momentum, 2: energy, 3: p_x,
+//! 4: p_y, 5: p_z, 6: azimuth in ]-pi,pi], 7: pseudo rapidity, 8: rapidity.
+//!
+double ParticleFilter::getKinematicValue(const Particle & particle, int subtype)
+{
+  const LorentzVector & momentum = particle.getMomentum();
+  switch (subtype)
+    {
+      case 0: return particle.getP();        // momentum
+      case 1: return particle.getPt();       // transverse momentum
+      case 2: return momentum.E();           // energy
+      case 3: return momentum.Px();          // p_x
+      case 4: return momentum.Py();          // p_y
+      case 5: return momentum.Pz();          // p_z
+      case 6: return toSignedPhi(particle.getPhi()); // phi azimuth
+      case 7: return particle.getEta();      // pseudo rapidity
+      case 8: return particle.getRapidity(); // rapidity
+    }
+  return 0.0;
+}
+
+void ParticleFilter::compile(ParticleDb * particleDb)
+{
+  // a compiled filter may be in use by other threads: it is never rewritten for the same db
+  if (compiled && particleDb==compiledDb && (!particleDb || particleDb->getGeneration()==compiledGeneration)) return;
+  requireLive     = false;
+  requireNotLive  = false;
+  filteringOnType = false;
+  kinematicRanges.clear();
+  for (unsigned int k = 0; k<conditions.size(); k++)
+    {
+    Condition * condition = conditions[k];
+    switch (condition->filterType)
+      {
+        case 0:
+        if (condition->filterSubtype==0) requireNotLive = true;
+        if (condition->filterSubtype==1) requireLive    = true;
         break;
 
-        case 3: // Particle index
-        accepting = condition.accept(type.getIndex());
-        //if (!accepting) return false;
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+        filteringOnType = true;
         break;
 
-        case 4: // Type selection
-        switch (filterSubType)
-          {
-            case 0: accepting = type.isPhoton();     break;
-            case 10: accepting = type.isLepton();         break;
-            case 11: accepting = type.isElectron() || type.isPositron(); break;
-            case 12: accepting = type.isElectron();   break;
-            case 13: accepting = type.isPositron();   break;
-            case 14: accepting = type.isMuon() || type.isAntiMuon();     break;
-            case 15: accepting = type.isMuon();       break;
-            case 16: accepting = type.isAntiMuon();   break;
-            case 17: accepting = type.isTau()  || type.isAntiTau();      break;
-            case 18: accepting = type.isTau();       break;
-            case 19: accepting = type.isAntiTau();  break;
-
-            case 40: accepting = type.isStrange();        break;
-            case 41: accepting = type.isStrangePlus();    break;
-            case 42: accepting = type.isStrangeMinus();   break;
-
-            case 50: accepting = type.isCharm();          break;
-            case 51: accepting = type.isCharmPlus();      break;
-            case 52: accepting = type.isCharmMinus();     break;
-
-            case 60: accepting = type.isBottom();         break;
-            case 61: accepting = type.isBottomPlus();     break;
-            case 62: accepting = type.isBottomMinus();    break;
-
-            case 70: accepting = type.isTop();            break;
-
-            case 1100: accepting = type.isHadron();   break; // any hadron
-            case 1101: accepting = type.isHadron() && type.isCharged();   break; // any charged hadron
-            case 1102: accepting =
-            type.isPionP() ||
-            type.isPionM() ||
-            type.isKaonP() ||
-            type.isKaonM() ||
-            type.isProton() ||
-            type.isAntiProton(); // pi+, pi-, K+, K-, p, pBar
-            break; // any charge hadron
-            case 1103: accepting =
-            type.isPionP() ||
-            type.isKaonP() ||
-            type.isProton(); // pi+, K+, p
-            break;
-            case 1104: accepting =
-            type.isPionM() ||
-            type.isKaonM() ||
-            type.isAntiProton(); // pi-, K-, pBar
-            break;
-
-            case 1110: accepting = type.isPion();     break;
-            case 1111: accepting = type.isPionP(); break;
-            case 1112: accepting = type.isPion0(); break;
-            case 1113: accepting = type.isPionM(); break;
-
-            case 1120: accepting = type.isKaon();     break;
-            case 1121: accepting = type.isKaonP();    break;
-            case 1122: accepting = type.isKaonM();    break;
-            case 1123: accepting = type.isKaon0();    break;
-            case 1124: accepting = type.isKaon0Bar(); break;
-            case 1125: accepting = type.isKaon0S();   break;
-            case 1126: accepting = type.isKaon0L();   break;
-
-            case 1200: accepting = type.isBaryon();         break;
-            case 1201: accepting = type.isBaryonPlus();     break;
-            case 1202: accepting = type.isBaryonMinus();    break;
-
-            case 1210: accepting = type.isProton() || type.isAntiProton();   break;
-            case 1211: accepting = type.isProton();     break;
-            case 1212: accepting = type.isAntiProton(); break;
-
-            case 1220: accepting = type.isLambda() || type.isAntiLambda();   break;
-            case 1221: accepting = type.isLambda();     break;
-            case 1222: accepting = type.isAntiLambda(); break;
-
-            case 1230: accepting = type.isSigmaP();       break;
-            case 1231: accepting = type.isSigma0();       break;
-            case 1232: accepting = type.isSigmaM();       break;
-            case 1241: accepting = type.isAntiSigmaP();   break;
-            case 1242: accepting = type.isAntiSigma0();   break;
-            case 1243: accepting = type.isAntiSigmaM();   break;
-            case 1244: accepting = type.isXi0();          break;
-            case 1245: accepting = type.isXiM();          break;
-            case 1246: accepting = type.isAntiXi0();      break;
-            case 1247: accepting = type.isAntiXiM();      break;
-            case 1248: accepting = type.isOmegaM();       break;
-            case 1249: accepting = type.isAntiOmegaM();   break;
-          }
-        //if (!accepting) return false;
+        case 5:
+        {
+        KinematicRange range;
+        ConditionOr * conditionOr = dynamic_cast<ConditionOr*>(condition);
+        range.subtype  = condition->filterSubtype;
+        range.isOr     = conditionOr!=nullptr;
+        range.minimum  = condition->minimum;
+        range.maximum  = condition->maximum;
+        range.minimum2 = conditionOr ? conditionOr->minimum2 : 0.0;
+        range.maximum2 = conditionOr ? conditionOr->maximum2 : 0.0;
+        kinematicRanges.push_back(range);
+        }
         break;
+      }
+    }
 
-        case 5: // kinematic selection/filtering
-        const LorentzVector & momentum = particle.getMomentum();
-        switch (filterSubType)
+  if (speciesTable && speciesTable!=&ownSpeciesTable)
+    {
+    speciesTable->update();
+    }
+  else if (filteringOnType)
+    {
+    ownSpeciesTable.build(vector<ParticleFilter*>(1,this),particleDb);
+    speciesTable = &ownSpeciesTable;
+    speciesIndex = 0;
+    }
+  compiledDb         = particleDb;
+  compiledGeneration = particleDb ? particleDb->getGeneration() : 0;
+  compiled = true;
+}
+
+void ParticleFilter::setSpeciesTable(ParticleSpeciesTable * table, unsigned int iFilter)
+{
+  speciesTable = table;
+  speciesIndex = iFilter;
+}
+
+bool ParticleFilter::acceptSpecies(const ParticleType & type) const
+{
+  for (unsigned int k=0; k<conditions.size(); k++)
+    {
+    Condition & condition = *conditions[k];
+    if (condition.filterType<1 || condition.filterType>4) continue;
+    if (!acceptType(type,condition)) return false;
+    }
+  return true;
+}
+
+bool ParticleFilter::acceptTypeConditions(const ParticleType & type) const
+{
+  if (speciesTable) return speciesTable->accept(type,speciesIndex);
+  return acceptSpecies(type);
+}
+
+bool ParticleFilter::acceptCompiled(const Particle & particle) const
+{
+  bool live = particle.isLive();
+  if (requireLive && !live)   return false;
+  if (requireNotLive && live) return false;
+  if (filteringOnType && !acceptTypeConditions(particle.getType())) return false;
+  for (unsigned int k=0; k<kinematicRanges.size(); k++)
+    {
+    const KinematicRange & range = kinematicRanges[k];
+    if (!range.accept(getKinematicValue(particle,range.subtype))) return false;
+    }
+  return true;
+}
+
+void ParticleFilter::accept(const vector<Particle*> & particles, const EventColumns & columns, vector<unsigned char> & accepted)
+{
+  unsigned int nParticles = particles.size();
+  if (!compiled)
+    {
+    accepted.resize(nParticles);
+    for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      accepted[iParticle] = accept(*particles[iParticle]) ? 1 : 0;
+    return;
+    }
+
+  if (requireLive && requireNotLive)
+    {
+    accepted.assign(nParticles,0);
+    return;
+    }
+  accepted.assign(nParticles,1);
+  if (requireLive || requireNotLive)
+    {
+    unsigned char live = requireLive ? 1 : 0;
+    const unsigned char * liveColumn = columns.live.data();
+    for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      accepted[iParticle] = (liveColumn[iParticle]==live);
+    }
+
+  if (filteringOnType)
+    {
+    for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      {
+      if (!accepted[iParticle]) continue;
+      const ParticleType * type = particles[iParticle]->getTypePtr();
+      accepted[iParticle] = (type && acceptTypeConditions(*type)) ? 1 : 0;
+      }
+    }
+
+  // Each range is applied to a whole column in one pass.
+  for (unsigned int k=0; k<kinematicRanges.size(); k++)
+    {
+    const KinematicRange & range = kinematicRanges[k];
+    const double * values = nullptr;
+    switch (range.subtype)
+      {
+        case 0:
+        for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
           {
-            case 0: value = momentum.P();   break;    // momentum
-            case 1: value = momentum.Pt();  break;   // transverse momentum
-            case 2: value = momentum.E();   break;    // energy
-            case 3: value = momentum.Px();  break;   // p_x
-            case 4: value = momentum.Py();  break;   // p_y
-            case 5: value = momentum.Pz();  break;   // p_z
-            case 6: value = momentum.Phi(); break;   // phi azimuth
-            case 7: value = momentum.Eta(); break;   // pseudo rapidity
-            case 8: value = momentum.Rapidity(); break;   // rapidity
+          double px = columns.px[iParticle];
+          double py = columns.py[iParticle];
+          double pz = columns.pz[iParticle];
+          accepted[iParticle] &= range.accept(sqrt(px*px+py*py+pz*pz));
           }
-        accepting = conditions[k]->accept(value);
-        //cout << "k:" << k << " case 5: filterSubType: " << filterSubType << " value:" << value << " accepting:" << accepting << endl;
-        //if (!accepting) return false;
-        break;
+        continue;
+
+        case 6:
+        for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+          accepted[iParticle] &= range.accept(toSignedPhi(columns.phi[iParticle]));
+        continue;
+
+        case 1: values = columns.pt.data();  break;
+        case 2: values = columns.e.data();   break;
+        case 3: values = columns.px.data();  break;
+        case 4: values = columns.py.data();  break;
+        case 5: values = columns.pz.data();  break;
+        case 7: values = columns.eta.data(); break;
+        case 8: values = columns.y.data();   break;
+      }
+    if (values)
+      {
+      for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+        accepted[iParticle] &= range.accept(values[iParticle]);
+      }
+    else
+      {
+      for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+        accepted[iParticle] &= range.accept(0.0);
       }
-    if (!accepting)  return false;
     }
-  return true;
 }
@@ -12,11 +12,24 @@
 #ifndef CAP__ParticleFilter
 #define CAP__ParticleFilter
 #include "Particle.hpp"
+#include "EventColumns.hpp"
+#include "ParticleSpeciesTable.hpp"
 #include "Filter.hpp"
+#include "MathConstants.hpp"
 
 namespace CAP
 {
 
+class ParticleDb;
+
+//!
+//! Filter of particles defined by a list of conditions (class Condition) all of which must be satisfied by accepted particles.
+//!
+//! Once all conditions are added, compile() translates them into a flat program: live flag requirements, a table of the accepted
+//! particle types built from the conditions on charge, pdg code, type index, and species (see ParticleSpeciesTable), and a list
+//! of ranges applied to kinematic variables. The program is never modified by accept(), so a compiled filter may be used concurrently by several
+//! threads. Filters that are not compiled evaluate their conditions one by one.
+//!
 class ParticleFilter : public Filter<Particle>
 {
 public:
@@ -27,12 +40,86 @@ public:
   virtual ~ParticleFilter() {}
   virtual bool accept(const Particle & particle);
 
+  //!
+  //! Apply this filter to all the given particles at once. On return, accepted[k] is 1 if particles[k] is accepted and 0 otherwise.
+  //! The kinematic conditions are evaluated on the given columns, which must describe the given particles (see Event::getColumns()).
+  //!
+  void accept(const vector<Particle*> & particles, const EventColumns & columns, vector<unsigned char> & accepted);
+
+  //!
+  //! Compile the conditions of this filter. The table of accepted types covers the types of the given particle db; particles
+  //! of other types are tested against the type conditions directly. Conditions must all be added before the filter is compiled.
+  //! Filters given a shared species table by setSpeciesTable() use it, after updating it if the db changed. Other filters
+  //! build a table of their own. Compiling a filter already compiled for the same db, unchanged since, does nothing: the filters
+  //! of FilterCreator are compiled once, by FilterCreator::initialize(), before any thread uses them.
+  //!
+  void compile(ParticleDb * particleDb);
+
+  //!
+  //! Use bit iFilter of the given species table, shared by several filters (see FilterCreator::createSpeciesTable()), to test
+  //! the type of the particles.
+  //!
+  void setSpeciesTable(ParticleSpeciesTable * table, unsigned int iFilter);
+
+  //!
+  //! Returns true if the given type satisfies the conditions of this filter on charge, pdg code, type index, and species.
+  //! The conditions are evaluated one by one.
+  //!
+  bool acceptSpecies(const ParticleType & type) const;
+
+  bool isCompiled() const
+  {
+  return compiled;
+  }
+
+protected:
+
+  //!
+  //! Range applied to the kinematic variable selected by subtype (see getKinematicValue()). Conditions accept values in
+  //! [minimum,maximum[; ConditionOr accept values in [minimum,maximum] or [minimum2,maximum2].
+  //!
+  struct KinematicRange
+  {
+    int    subtype;
+    bool   isOr;
+    double minimum;
+    double maximum;
+    double minimum2;
+    double maximum2;
+
+    bool accept(double value) const
+    {
+    return isOr ? ((value>=minimum && value<=maximum) || (value>=minimum2 && value<=maximum2)) : (value>=minimum && value<maximum);
+    }
+  };
+
+  static bool   acceptType(const ParticleType & type, Condition & condition);
+  static double getKinematicValue(const Particle & particle, int subtype);
+
+  //!
+  //! Conditions on the azimuth use the range ]-pi,pi] whereas particles and columns store it in [0,2pi[.
+  //!
+  static double toSignedPhi(double phi)
+  {
+  return (phi>CAP::Math::pi()) ? phi-CAP::Math::twoPi() : phi;
+  }
+  bool acceptTypeConditions(const ParticleType & type) const;
+  bool acceptCompiled(const Particle & particle) const;
+
+  bool compiled;                              //!
+  bool requireLive;                           //!
+  bool requireNotLive;                        //!
+  bool filteringOnType;                       //!
+  ParticleSpeciesTable *     speciesTable;    //! table used to test particle types, shared or owned
+  unsigned int               speciesIndex;    //! bit of this filter in speciesTable
+  ParticleSpeciesTable       ownSpeciesTable; //!
+  vector<KinematicRange>     kinematicRanges; //!
+  ParticleDb *               compiledDb;      //! db this filter was compiled for
+  unsigned long              compiledGeneration; //! generation of compiledDb when this filter was compiled
 
- 
   ClassDef(ParticleFilter,0)
 };
 
 }
 
 #endif /* CAP__ParticleFilter */
-
@@ -0,0 +1,136 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticleGenealogy
+#define CAP__ParticleGenealogy
+#include <vector>
+#include <cstdint>
+#include "Exceptions.hpp"
+
+namespace CAP
+{
+
+class Particle;
+
+//!
+//! Arena storing the parent and child relations of the particles of an event. Each particle refers to its parents and to its
+//! children as two ranges (first index, count) of the links held by the arena, so a particle with no relations costs no allocation.
+//! The arena is owned by the Event and cleared once per event: clear() only bumps the generation of the arena, which invalidates the
+//! ranges held by all particles at once, without visiting the particles.
+//!
+class ParticleGenealogy
+{
+public:
+
+  //!
+  //! Read only view of a range of links of the arena, usable in range based for loops. A view is valid until relations
+  //! are added to the arena.
+  //!
+  class Range
+  {
+  public:
+
+    Range(Particle * const * _first=nullptr, int32_t _size=0)
+    :
+    first(_first),
+    n(_size)
+    {  }
+
+    Particle * const * begin() const { return first;   }
+    Particle * const * end()   const { return first+n; }
+    unsigned int size()        const { return n;       }
+    bool empty()               const { return n==0;    }
+    Particle * operator[](unsigned int index) const { return first[index]; }
+
+  protected:
+
+    Particle * const * first;
+    int32_t n;
+  };
+
+  ParticleGenealogy()
+  :
+  links(),
+  generation(1)
+  {  }
+
+  virtual ~ParticleGenealogy() {}
+
+  //!
+  //! Remove all relations. The ranges held by particles become invalid and the capacity of the arena is kept.
+  //!
+  void clear()
+  {
+  links.clear();
+  generation++;
+  }
+
+  //!
+  //! Generation of the arena, incremented by each clear(). A particle range is valid only if recorded in the current generation.
+  //!
+  uint32_t getGeneration() const
+  {
+  return generation;
+  }
+
+  //!
+  //! Append the given links to the arena and return the index of the first one.
+  //!
+  int32_t append(Particle * const * particles, int32_t n)
+  {
+  int32_t first = links.size();
+  links.insert(links.end(),particles,particles+n);
+  return first;
+  }
+
+  //!
+  //! Append one link to the range (first, n) and return the index of the first link of the range. Ranges only grow in place:
+  //! the range must be empty or end the arena, i.e., the children of a particle are added before any other relation is recorded
+  //! in the arena. Moving the range instead would copy it once per added link.
+  //!
+  int32_t extend(int32_t first, int32_t n, Particle * particle)
+  {
+  if (n==0)
+    first = links.size();
+  else if (first+n!=int32_t(links.size()))
+    throw MemoryException("Range does not end the arena: relations must be added in order","ParticleGenealogy::extend()");
+  links.push_back(particle);
+  return first;
+  }
+
+  Range getRange(int32_t first, int32_t n) const
+  {
+  return (n>0) ? Range(links.data()+first,n) : Range();
+  }
+
+  Particle * getAt(int32_t index) const
+  {
+  return links[index];
+  }
+
+  //!
+  //! Number of links stored in the arena.
+  //!
+  unsigned int size() const
+  {
+  return links.size();
+  }
+
+protected:
+
+  std::vector<Particle*> links;
+  uint32_t generation;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticleGenealogy */
@@ -0,0 +1,34 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "ParticleSelection.hpp"
+#include "ParticleFilter.hpp"
+using CAP::ParticleSelection;
+
+ParticleSelection::ParticleSelection()
+:
+accepted(),
+indices(),
+generation(0)
+{
+  // no ops
+}
+
+void ParticleSelection::fill(ParticleFilter & filter, const vector<Particle*> & particles, const EventColumns & columns)
+{
+  filter.accept(particles,columns,accepted);
+  unsigned int nParticles = accepted.size();
+  indices.clear();
+  for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+    {
+    if (accepted[iParticle]) indices.push_back(iParticle);
+    }
+}
@@ -0,0 +1,62 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticleSelection
+#define CAP__ParticleSelection
+#include <vector>
+#include "Particle.hpp"
+#include "EventColumns.hpp"
+
+namespace CAP
+{
+
+class ParticleFilter;
+
+//!
+//! Particles of an event accepted by a particle filter. Element k of "accepted" is 1 if the particle at position k of the event
+//! is accepted by the filter and 0 otherwise; "indices" lists the positions of the accepted particles in increasing order.
+//! Selections are computed by Event::getSelection() once per event and filter, and shared by all the analyzers using that filter.
+//!
+class ParticleSelection
+{
+public:
+
+  ParticleSelection();
+
+  virtual ~ParticleSelection() {}
+
+  //!
+  //! Apply the given filter to the given particles, described by the given columns. The capacity of the arrays is kept so the
+  //! next event causes no allocation.
+  //!
+  void fill(ParticleFilter & filter, const vector<Particle*> & particles, const EventColumns & columns);
+
+  //!
+  //! Number of accepted particles.
+  //!
+  unsigned int size() const
+  {
+  return indices.size();
+  }
+
+  vector<unsigned char> accepted;
+  vector<unsigned int>  indices;
+
+  //!
+  //! Particle generation of the event for which this selection was computed (see Event::getSelection()).
+  //!
+  unsigned long generation;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticleSelection */
@@ -0,0 +1,85 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "ParticleSpeciesTable.hpp"
+#include "ParticleFilter.hpp"
+#include "ParticleDb.hpp"
+using CAP::ParticleSpeciesTable;
+
+ParticleSpeciesTable::ParticleSpeciesTable()
+:
+filters(),
+particleDb(nullptr),
+generation(0),
+nWords(0),
+nTypes(0),
+updateMutex(),
+masks(),
+types()
+{
+  // no ops
+}
+
+void ParticleSpeciesTable::build(const vector<ParticleFilter*> & _filters, ParticleDb * _particleDb)
+{
+  filters    = _filters;
+  particleDb = _particleDb;
+  nWords     = (filters.size()+63)/64;
+  nTypes     = 0;
+  masks.clear();
+  types.clear();
+  if (!particleDb) return;
+  generation = particleDb->getGeneration();
+  addTypes(0,particleDb->size());
+}
+
+void ParticleSpeciesTable::addTypes(unsigned int first, unsigned int last)
+{
+  for (unsigned int iType=first; iType<last; iType++)
+    {
+    ParticleType * type = particleDb->getParticleType(iType);
+    int index = type->getIndex();
+    if (index<0) continue;
+    if (index>=int(types.size()))
+      {
+      types.resize(index+1,nullptr);
+      masks.resize((index+1)*nWords,0);
+      }
+    if (types[index]) continue; // index already used by another type: tested directly
+    types[index] = type;
+    uint64_t * mask = masks.data() + index*nWords;
+    for (unsigned int iFilter=0; iFilter<filters.size(); iFilter++)
+      {
+      if (filters[iFilter]->acceptSpecies(*type)) mask[iFilter>>6] |= uint64_t(1) << (iFilter&63);
+      }
+    }
+  nTypes = last;
+}
+
+void ParticleSpeciesTable::update()
+{
+  std::lock_guard<std::mutex> lock(updateMutex);
+  if (!particleDb) return;
+  if (!isCurrent())
+    build(vector<ParticleFilter*>(filters),particleDb);
+  else if (particleDb->size()>nTypes)
+    addTypes(nTypes,particleDb->size());
+}
+
+bool ParticleSpeciesTable::isCurrent() const
+{
+  return particleDb && particleDb->getGeneration()==generation;
+}
+
+bool ParticleSpeciesTable::acceptDirect(const ParticleType & type, unsigned int iFilter) const
+{
+  return filters[iFilter]->acceptSpecies(type);
+}
@@ -0,0 +1,115 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticleSpeciesTable
+#define CAP__ParticleSpeciesTable
+#include <vector>
+#include <cstdint>
+#include <mutex>
+#include "ParticleType.hpp"
+
+namespace CAP
+{
+
+class ParticleFilter;
+class ParticleDb;
+
+//!
+//! Table, indexed by ParticleType index, of the species filters a particle type belongs to. Each type of the particle db is given
+//! a bit mask with bit k set if the type satisfies the conditions on charge, pdg code, type index, and species of filter k.
+//! Classifying a particle against all filters then requires a single table read rather than the evaluation of each filter.
+//! Kinematic and live conditions are not part of the table.
+//!
+//! The table records the generation of the particle db it was built from. It is not used, and the filters are evaluated
+//! directly, when types of the db were moved or removed since (see ParticleDb::getGeneration()); update() then rebuilds it.
+//! Types added to the db since the table was built are tested directly until update() extends the table with them.
+//!
+//! A table is shared by the filters of a FilterCreator filter set. It is read without synchronization, so it is only built and
+//! updated before the filters are used by several threads (see FilterCreator::initialize()).
+//!
+class ParticleSpeciesTable
+{
+public:
+
+  ParticleSpeciesTable();
+
+  virtual ~ParticleSpeciesTable() {}
+
+  //!
+  //! Build the table for the given filters and the types of the given particle db.
+  //!
+  void build(const vector<ParticleFilter*> & _filters, ParticleDb * _particleDb);
+
+  //!
+  //! Rebuild the table if types of the particle db were moved or removed since it was built, or otherwise add the types added to
+  //! the db since. Concurrent calls are serialized, but no thread may use the table during the call.
+  //!
+  void update();
+
+  //!
+  //! Returns true if the table is up to date with its particle db.
+  //!
+  bool isCurrent() const;
+
+  //!
+  //! Returns true if the given type satisfies the species conditions of filter iFilter.
+  //!
+  bool accept(const ParticleType & type, unsigned int iFilter) const
+  {
+  const uint64_t * mask = getMask(type);
+  if (mask) return (mask[iFilter>>6] >> (iFilter&63)) & 1;
+  return acceptDirect(type,iFilter);
+  }
+
+  //!
+  //! Returns the bit mask of the filters the given type belongs to, stored as getNWords() words of 64 bits, or a null pointer if the
+  //! type is not in the table or the table is out of date.
+  //!
+  const uint64_t * getMask(const ParticleType & type) const
+  {
+  int index = type.getIndex();
+  if (index<0 || index>=int(types.size()) || types[index]!=&type || !isCurrent()) return nullptr;
+  return masks.data() + index*nWords;
+  }
+
+  unsigned int getNFilters() const
+  {
+  return filters.size();
+  }
+
+  unsigned int getNWords() const
+  {
+  return nWords;
+  }
+
+protected:
+
+  bool acceptDirect(const ParticleType & type, unsigned int iFilter) const;
+
+  //!
+  //! Add the types of the particle db at positions [first,last[ to the table.
+  //!
+  void addTypes(unsigned int first, unsigned int last);
+
+  vector<ParticleFilter*>     filters;
+  ParticleDb *                particleDb;
+  unsigned long               generation;
+  unsigned int                nWords;
+  unsigned int                nTypes;  //! number of types of the db included in the table
+  std::mutex                  updateMutex;
+  vector<uint64_t>            masks;   //! nWords words per type index
+  vector<const ParticleType*> types;   //! type for which each entry of the table was computed
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticleSpeciesTable */
@@ -0,0 +1,120 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticleView
+#define CAP__ParticleView
+#include <vector>
+#include "Particle.hpp"
+#include "EventColumns.hpp"
+
+namespace CAP
+{
+
+//!
+//! Read only view of a subset of the particles of an event: a span of positions of particles in the event, e.g., the particles
+//! accepted by a filter (see Event::getView()). The view copies neither the particles nor their positions; element k of the view
+//! is the particle at position getPosition(k) of the event, and the columns of the event describe it at that same position.
+//! Iterating over a view yields Particle pointers, so a view can be used in range based for loops.
+//!
+//! A view is valid until the particles of the event change.
+//!
+class ParticleView
+{
+public:
+
+  class Iterator
+  {
+  public:
+
+    Iterator(const ParticleView & _view, unsigned int _k)
+    :
+    view(_view),
+    k(_k)
+    {  }
+
+    Particle * operator*() const                  { return view[k];           }
+    Iterator & operator++()                       { k++; return *this;        }
+    bool operator!=(const Iterator & other) const { return k!=other.k;        }
+    bool operator==(const Iterator & other) const { return k==other.k;        }
+
+  protected:
+
+    const ParticleView & view;
+    unsigned int k;
+  };
+
+  //!
+  //! View of n particles of the given event particles. The particles are those at the given positions or, if positions is a null
+  //! pointer, those at positions first to first+n-1.
+  //!
+  ParticleView(const vector<Particle*> * _particles=nullptr,
+               const EventColumns * _columns=nullptr,
+               const unsigned int * _positions=nullptr,
+               unsigned int _first=0,
+               unsigned int _size=0)
+  :
+  particles(_particles),
+  columns(_columns),
+  positions(_positions),
+  first(_first),
+  n(_size)
+  {  }
+
+  unsigned int size() const { return n;    }
+  bool empty() const        { return n==0; }
+
+  //!
+  //! Position in the event of element k of this view, i.e., the index of the particle in the event and in its columns.
+  //!
+  unsigned int getPosition(unsigned int k) const
+  {
+  return positions ? positions[k] : first+k;
+  }
+
+  Particle * operator[](unsigned int k) const
+  {
+  return (*particles)[getPosition(k)];
+  }
+
+  //!
+  //! Columnar description of the particles of the event the view refers to.
+  //!
+  const EventColumns & getColumns() const
+  {
+  return *columns;
+  }
+
+  //!
+  //! View of elements first to first+count-1 of this view, e.g., to split the particles of an event among several workers.
+  //!
+  ParticleView getSpan(unsigned int _first, unsigned int count) const
+  {
+  if (_first>n) _first = n;
+  if (count>n-_first) count = n-_first;
+  return positions ? ParticleView(particles,columns,positions+_first,0,count) : ParticleView(particles,columns,nullptr,first+_first,count);
+  }
+
+  Iterator begin() const { return Iterator(*this,0); }
+  Iterator end()   const { return Iterator(*this,n); }
+
+protected:
+
+  const vector<Particle*> * particles;
+  const EventColumns *      columns;
+  const unsigned int *      positions;
+  unsigned int              first;
+  unsigned int              n;
+
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticleView */
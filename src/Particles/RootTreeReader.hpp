@@ -185,6 +185,25 @@ public:
     ;
   }
 
+  //!
+  //! Save the histograms and counters of this reader along with the index of the next entry to be read from the input chain.
+  //!
+  virtual void saveCheckpoint(TDirectory & directory)
+  {
+  EventTask::saveCheckpoint(directory);
+  writeParameter(directory,"entryIndex",entryIndex);
+  }
+
+  //!
+  //! Restore the state saved by saveCheckpoint(): reading resumes at the saved entry.
+  //!
+  virtual void loadCheckpoint(TDirectory & directory)
+  {
+  EventTask::loadCheckpoint(directory);
+  entryIndex = readParameter(directory,"entryIndex");
+  if (entryIndex>nEntries) throw TaskException("Checkpoint entry index exceeds the number of entries","RootTreeReader::loadCheckpoint()");
+  }
+
   //!
   //!Initialize the input tree chain by mapping branches onto specific variables.
   //!This method must be implemented in a sub class of the RootTreeReader class.
@@ -21,7 +21,8 @@ ClassImp(ClosureIterator);
 ClosureIterator::ClosureIterator(const String & _name,
                                  const Configuration & _configuration)
 :
-Task(_name,_configuration)
+Task(_name,_configuration),
+filePool()
 {
   appendClassName("ClosureIterator");
 }
@@ -35,6 +36,7 @@ void ClosureIterator::setDefaultConfiguration()
   addParameter("HistogramsExport",          true);
   addParameter("AppendedString",          TString("Closure"));
   addParameter("SelectedMethod",          1);
+  addParameter("maxConcurrentFiles",      int(1));
   generateKeyValuePairs("IncludedPattern",none,20);
   generateKeyValuePairs("ExcludedPattern",none,20);
 }
@@ -56,6 +58,8 @@ void ClosureIterator::execute()
   String histogramsExportPath  = getValueString("HistogramsExportPath");
   bool histosForceRewrite      = getValueBool(  "HistogramsForceRewrite");
   int selectedMethod           = getValueInt(   "SelectedMethod");
+  int maxConcurrentFiles       = getValueInt(   "maxConcurrentFiles");
+  filePool.setMaxConcurrentFiles(maxConcurrentFiles);
 
   unsigned int nSubTasks = subTasks.size();
   if (reportDebug(__FUNCTION__))  cout << "SubTasks Count: " << nSubTasks  << endl;
@@ -105,19 +109,21 @@ void ClosureIterator::execute()
       printItem("HistogramsExportPath",histogramsExportPath);
       printItem("nFilesToProcess",nFilesToProcess);
       printItem("appendedString",appendedString);
+      printItem("maxConcurrentFiles",maxConcurrentFiles);
       cout << "===========================================================" << endl;
       }
-      for (int iFile=0; iFile<nFilesToProcess; iFile++)
+    // each file is handled by its own ClosureCalculator: files are processed concurrently
+    filePool.run(allFilesToProcess,maxConcurrentFiles,[&](unsigned int iWorker __attribute__((unused)), unsigned int iFile)
       {
       String histoGeneratorFileName = removeRootExtension(allFilesToProcess[iFile]);
       String histoDetectorFileName  = substitute(histoGeneratorFileName, "_Gen", "_Reco");
       String histoClosureFileName   = substitute(histoGeneratorFileName, "_Gen", "_Closure");
 
-      if (reportInfo(__FUNCTION__))
+      if (reportInfo("execute"))
         {
         cout << endl;
         cout << " --------------------------------------------------------------------------" << endl;
-        printItem("iFile",iFile);
+        printItem("iFile",int(iFile));
         printItem("Generator File Name",histoGeneratorFileName);
         printItem("Detector File Name",histoDetectorFileName);
         printItem("Closure File Name",histoClosureFileName);
@@ -135,7 +141,8 @@ void ClosureIterator::execute()
       closureConfig.addParameter("HistoClosureFileName",   histoClosureFileName);
       ClosureCalculator calculator("Closure", closureConfig);
       calculator.execute();
-      } // iFile loop
+      }); // iFile loop
+    if (reportInfo(__FUNCTION__)) filePool.printReport(cout);
     } // iTask loop
   if (reportEnd(__FUNCTION__))
     ;
@@ -12,6 +12,7 @@
 #ifndef CAP__ClosureIterator
 #define CAP__ClosureIterator
 #include "Task.hpp"
+#include "FileTaskPool.hpp"
 
 namespace CAP
 {
@@ -19,6 +20,8 @@ namespace CAP
 //!
 //!Task performs a closure test
 //!
+//!The selected files are independent: with maxConcurrentFiles>1, they are processed concurrently, each by its own ClosureCalculator.
+//!
 class ClosureIterator : public Task
 {
 public:
@@ -49,6 +52,12 @@ public:
   //!
   virtual void execute();
 
+protected:
+
+  FileTaskPool filePool; //!
+
+public:
+
   ClassDef(ClosureIterator,0)
 };
 
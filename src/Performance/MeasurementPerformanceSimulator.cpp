@@ -74,6 +74,18 @@ void MeasurementPerformanceSimulator::setDefaultConfiguration()
     }
 }
 
+unsigned int MeasurementPerformanceSimulator::getDataRead() const
+{
+  if (eventsImport || eventsExport || hasSubTasks()) return AllData;
+  return getStreamData(0) | getPropertiesData(0);
+}
+
+unsigned int MeasurementPerformanceSimulator::getDataWritten() const
+{
+  if (eventsImport || eventsExport || hasSubTasks()) return AllData;
+  return getStreamData(1) | getPropertiesData(1) | ParticleFactoryData | RandomGeneratorData;
+}
+
 void MeasurementPerformanceSimulator::initialize()
 {
   if (reportStart(__FUNCTION__))
@@ -201,22 +213,19 @@ void MeasurementPerformanceSimulator::createEvent()
       {
       ParticleFilter  * particleFilter  = particleFilters[iParticleFilter];
       ParticlePerformanceSimulator * simulator = (ParticlePerformanceSimulator *) histogramManager.getGroup(0,iParticleFilter);
-      for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      // only the particles accepted by the filter are visited; the selection is shared with the other tasks using the filter
+      for (Particle * genParticle : genEvent.getView(*particleFilter))
         {
-        Particle * genParticle = genEvent.getParticleAt(iParticle);
-        if (particleFilter->accept(*genParticle))
-          {
-          LorentzVector & genMomentum = genParticle->getMomentum();
-          if (!simulator->accept(genMomentum)) continue;
-          ParticleType * type = genParticle->getTypePtr();
-          LorentzVector & genPosition = genParticle->getPosition();
-          simulator->smearMomentum(genMomentum,recoMomentum);
-          Particle * recoParticle = particleFactory->getNextObject();
-          // we dont smear the position for now..
-          recoParticle->set(type,recoMomentum,genPosition,true);
-          recoParticle->setTruth(genParticle);
-          recoEvent.add(recoParticle);
-          } // particle accepted by filter
+        LorentzVector & genMomentum = genParticle->getMomentum();
+        if (!simulator->accept(genMomentum)) continue;
+        ParticleType * type = genParticle->getTypePtr();
+        LorentzVector & genPosition = genParticle->getPosition();
+        simulator->smearMomentum(genMomentum,recoMomentum);
+        Particle * recoParticle = particleFactory->getNextObject();
+        // we dont smear the position for now..
+        recoParticle->set(type,recoMomentum,genPosition,true);
+        recoParticle->setTruth(genParticle);
+        recoEvent.add(recoParticle);
         } //particle loop
       } // particle filter loop
     } // event filter loop
@@ -68,6 +68,17 @@ public:
   //!
   virtual void createEvent();
 
+  //!
+  //! Returns the data read by this task: the generator level event (stream 0) and its properties.
+  //!
+  virtual unsigned int getDataRead() const;
+
+  //!
+  //! Returns the data written by this task: the reconstructed event (stream 1), its properties, the particle factory,
+  //! and the random generator used to simulate the detector performance.
+  //!
+  virtual unsigned int getDataWritten() const;
+
   //!
   //! Initialize this task
   //!
@@ -22,6 +22,7 @@ fillEta(true),
 fillY(false)
 {
   appendClassName("ParticlePerformanceAnalyzer");
+  eventsReadOnly = true;
 }
 
 void ParticlePerformanceAnalyzer::setDefaultConfiguration()
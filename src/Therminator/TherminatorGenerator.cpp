@@ -325,7 +325,7 @@ void TherminatorGenerator::createEvent()
   double   maxIntegrand;
   double   value;
   double   valueTest;
-  CAP::Factory<Particle> * factory = Particle::getFactory();
+  CAP::Factory<Particle> * factory = particleFactory;
   bool flag = false;
 
   double totalQ = 0.0;